@@ -5,9 +5,28 @@
  */
 #include "src/bus.h"
 
+#include <cmath>
+
+// Moves smaller than this are not worth redrawing or notifying. In
+// degrees, about a metre, and above the float spacing at the latitudes and
+// longitudes of the map, 4e-6 to 8e-6, so it is not an exact compare
+static const float kPositionEpsilon = 1e-5f;
+
+static bool SameBusData(const BusData& a, const BusData& b) {
+  return a.id == b.id
+      && std::fabs(a.position.x - b.position.x) < kPositionEpsilon
+      && std::fabs(a.position.y - b.position.y) < kPositionEpsilon
+      && a.num_passengers == b.num_passengers
+      && a.capacity == b.capacity
+      && a.color.red == b.color.red && a.color.green == b.color.green
+      && a.color.blue == b.color.blue && a.color.alpha == b.color.alpha;
+}
+
 Bus::Bus(std::string name, Route * out, Route * in,
             int capacity, double speed, std::string type) {
   name_ = name;
+  // In the table of the network of its routes
+  id_ = out->GetNames()->Intern(name);
   outgoing_route_ = out;
   incoming_route_ = in;
   passenger_max_capacity_ = capacity;
@@ -18,11 +37,47 @@ Bus::Bus(std::string name, Route * out, Route * in,
   unloader_ = new PassengerUnloader;
   loader_ = new PassengerLoader;
   total_passenger_ = 0;
+  events_ = NULL;
+  changed_ = false;
+  color_policy_ = &MaroonGoldColorPolicy::Apply<Bus>;
   // Initialize the color to default maroon
   // using a decorator
-  IBus *bus_decorator = new BusDecorator(this);
-  bus_decorator->UpdateBusData();
-  delete bus_decorator;
+  BusDefaultDecorator<Bus> decorator(this);
+  Decorate(&decorator);
+}
+
+Bus::~Bus() {
+  ClearPassengers();
+  delete unloader_;
+  delete loader_;
+}
+
+void Bus::ClearPassengers() {
+  // The bus owns its riders, those left at the end of a run are freed here
+  for (std::list<Passenger *>::iterator it = passengers_.begin();
+       it != passengers_.end(); it++) {
+    delete *it;
+  }
+  passengers_.clear();
+}
+
+void Bus::SetLog(FileWriter * log) {
+  unloader_->SetLog(log);
+}
+
+void Bus::Reset(double speed) {
+  speed_ = speed;
+  outgoing_route_->ResetCursor();
+  incoming_route_->ResetCursor();
+  distance_remaining_ = 0;
+  next_stop_ = outgoing_route_->GetDestinationStop();
+  ClearPassengers();
+  total_passenger_ = 0;
+  changed_ = false;
+  bus_data_ = BusData();
+  reported_data_ = BusData();
+  BusDefaultDecorator<Bus> decorator(this);
+  Decorate(&decorator);
 }
 
 bool Bus::IsTripComplete() {
@@ -118,7 +173,16 @@ bool Bus::Move() {
 void Bus::Update() {  // using common Update format
   Move();
   UpdateBusData();
-  NotifyObservers(&bus_data_);
+
+  // Parked or finished buses keep the same data, nobody needs to hear it
+  changed_ = !SameBusData(reported_data_, bus_data_);
+  if (!changed_) {
+    return;
+  }
+  reported_data_ = bus_data_;
+  if (events_ && events_->HasSubscribers<BusMovedEvent>(id_)) {
+    events_->Publish(id_, BusMovedEvent(bus_data_));
+  }
 }
 
 void Bus::Report(std::ostream& out) {
@@ -136,12 +200,60 @@ void Bus::Report(std::ostream& out) {
   // }
 }
 
+void Bus::Save(CheckpointWriter * out) const {
+  out->WriteDouble(speed_);
+  out->WriteInt(outgoing_route_->GetCursor());
+  out->WriteInt(incoming_route_->GetCursor());
+  out->WriteDouble(distance_remaining_);
+  out->WriteInt(total_passenger_);
+  out->WriteInt(static_cast<int>(passengers_.size()));
+  for (const auto* passenger : passengers_) {
+    passenger->Save(out);
+  }
+}
+
+bool Bus::Load(CheckpointReader * in) {
+  double speed = in->ReadDouble();
+  int outgoing = in->ReadInt();
+  int incoming = in->ReadInt();
+  double distance_remaining = in->ReadDouble();
+  int total_passenger = in->ReadInt();
+  if (!in->IsOk()) {
+    return false;
+  }
+  if (!outgoing_route_->SetCursor(outgoing)
+      || !incoming_route_->SetCursor(incoming)) {
+    return in->Fail("bus " + name_ + " is off its routes");
+  }
+  speed_ = speed;
+  distance_remaining_ = distance_remaining;
+  total_passenger_ = total_passenger;
+  next_stop_ = IsTripComplete() ? NULL : CurrentRoute()->GetDestinationStop();
+
+  ClearPassengers();
+  int count = in->ReadCount(5 * sizeof(int));
+  for (int i = 0; i < count; i++) {
+    Passenger * passenger = Passenger::Load(in);
+    if (!passenger) {
+      return false;
+    }
+    passengers_.push_back(passenger);
+  }
+
+  // As after the tick it was saved at, nothing changed since
+  UpdateBusData();
+  reported_data_ = bus_data_;
+  changed_ = false;
+  return true;
+}
+
 int Bus::UnloadPassengers() {
-  return unloader_->UnloadPassengers(&passengers_, next_stop_);
+  return unloader_->UnloadPassengers(&passengers_, next_stop_, events_, id_,
+                                     CurrentRoute()->GetId());
 }
 
 void Bus::UpdateBusData() {
-  bus_data_.id = name_;
+  bus_data_.id = id_;
 
   // Get the correct route and early exit
   Route * current_route = outgoing_route_;
@@ -179,16 +291,8 @@ void Bus::UpdateBusData() {
   bus_data_.num_passengers = static_cast<int>(passengers_.size());
   bus_data_.capacity = passenger_max_capacity_;
 
-  // Update bus color using a decorator
-  if (current_route == incoming_route_) {
-    IBus *bus_decorator = new BusColorGoldDecorator(this);
-    bus_decorator->UpdateBusData();
-    delete bus_decorator;
-  } else {
-    IBus *bus_decorator = new BusColorMaroonDecorator(this);
-    bus_decorator->UpdateBusData();
-    delete bus_decorator;
-  }
+  // Update bus color using the decorator of the color policy
+  color_policy_(this, current_route == incoming_route_);
 
   // Update color intensity based on the number of passengers on bus
   // using a decorator
@@ -196,9 +300,7 @@ void Bus::UpdateBusData() {
   if (alpha > 255) {
     alpha = 255;
   }
-  IBus *bus_decorator = new BusIntensityDecorator(this);
-  bus_decorator->SetIntensity(alpha);
-  delete bus_decorator;
+  BusIntensityDecorator<Bus>(this).SetIntensity(alpha);
 }
 
 BusData Bus::GetBusData() const {
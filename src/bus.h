@@ -13,6 +13,7 @@
 #include <list>
 #include <string>
 
+#include "src/checkpoint.h"
 #include "src/data_structs.h"
 #include "src/passenger.h"
 #include "src/passenger_loader.h"
@@ -21,7 +22,10 @@
 #include "src/stop.h"
 #include "src/ibus.h"
 #include "src/bus_decorator.h"
+#include "src/name_table.h"
+#include "src/event_bus.h"
 
+class FileWriter;
 class PassengerUnloader;
 class PassengerLoader;
 class Route;
@@ -33,33 +37,68 @@ class Stop;
 /**
  * @brief The main class for Bus.
  *
- * Implement the Subject Interface in Observer Pattern.
+ * Publishes BusMovedEvent and PassengerAlightedEvent on the EventBus of
+ * its simulation, if one was set.
  */
-class Bus : public IBus {
+class Bus : public IBus<Bus> {
  public:
+  // Paints the bus depending on the route it is on, see BusColorPolicy
+  typedef void (*ColorPolicy)(Bus * bus, bool incoming);
+
   Bus(std::string name, Route * out, Route * in, int capacity = 60,
                       double speed = 1, std::string type = "Medium");
+  virtual ~Bus();
+  /**
+   * @brief Put a finished bus back on the road.
+   *
+   * Rewinds its routes and clears its trip state, keeping the name and id,
+   * loader, unloader, routes and color policy, so a recycled bus allocates
+   * nothing and interns no new name.
+   */
+  void Reset(double speed = 1);
   bool IsTripComplete();
   bool LoadPassenger(Passenger *);  // returning revenue delta
   bool Move();
   void Update();
   void Report(std::ostream&);
+  /**
+   * @brief Save where the bus is on its routes and who rides it.
+   *
+   * The name and type are not saved, they pick the bus to Load into.
+   */
+  void Save(CheckpointWriter * out) const;
+  /**
+   * @brief Put the bus back where Save found it, with new passengers.
+   *
+   * @return false, with the reader failed, if the checkpoint does not fit
+   * the routes of the bus.
+   */
+  bool Load(CheckpointReader * in);
 
   // Vis Getters
   void UpdateBusData();
   BusData GetBusData() const;
   void SetColor(int red, int green, int clue);
   void SetIntensity(int alpha);
+  void SetColorPolicy(ColorPolicy policy) { color_policy_ = policy; }
   std::string GetName() const { return name_; }
+  int GetId() const { return id_; }  // interned name, see NameTable
+  std::string GetType() const { return type_; }
   Stop * GetNextStop() const { return next_stop_; }
   size_t GetNumPassengers() const { return passengers_.size(); }
   int GetCapacity() const { return passenger_max_capacity_; }
+  void SetEventBus(EventBus * events) { events_ = events; }
+  // Log the alighting passengers are reported to, NULL reports none
+  void SetLog(FileWriter * log);
+  // Whether the last Update changed the position, passengers or color
+  bool HasChanged() const { return changed_; }
 
  protected:
   int total_passenger_;  // total number of passengers riding the bus
 
  private:
   int UnloadPassengers();  // returning revenue delta
+  void ClearPassengers();  // deletes the riding passengers
   int HandleBusStop();
   void ToNextStop();
   double UpdateDistance();
@@ -74,6 +113,7 @@ class Bus : public IBus {
   // double fuel_;   // may not be necessary for our simulation
   // double max_fuel_;
   std::string name_;
+  int id_;
   std::string type_;
   double speed_;  // could also be called "distance travelled in one time step"
   Route * outgoing_route_;
@@ -86,6 +126,10 @@ class Bus : public IBus {
 
   // Vis data for bus
   BusData bus_data_;
+  BusData reported_data_;  // bus_data_ as of the last change
+  bool changed_;
+  EventBus * events_;  // not owned, may be NULL
+  ColorPolicy color_policy_;
 };
 
 #endif  // SRC_BUS_H_
@@ -19,12 +19,19 @@
 /**
  * @brief The decorator class for Decorator Pattern.
  *
+ * Decorators are templates over the component they decorate, so the whole
+ * pipeline is composed at compile time and built on the stack. A concrete
+ * decorator passes itself as Derived, so calls through IBus<Derived> reach
+ * its own functions, and the decorated component is reached through
+ * IBus<Component> as well.
+ *
  * Calls to \ref UpdateBusData function to decorator a bus using
  * default values.
  */
-class BusDecorator : public IBus {
+template <typename Derived, typename Component>
+class BusDecorator : public IBus<Derived> {
  public:
-  explicit BusDecorator(IBus * bus_to_decorate) :
+  explicit BusDecorator(Component * bus_to_decorate) :
   bus_to_decorate_(bus_to_decorate) {}
   /**
   * @brief Decorate the color and intensity using default values.
@@ -33,8 +40,8 @@ class BusDecorator : public IBus {
   *
   */
   void UpdateBusData() {
-    SetColor(196, 34, 74);  // set the default color to be maroon
-    SetIntensity(255);  // set the default intensity to be maximum
+    Self()->SetColor(196, 34, 74);  // set the default color to be maroon
+    Self()->SetIntensity(255);  // set the default intensity to be maximum
   }
   /**
   * @brief Change the bus color. Set it to the default marron.
@@ -56,7 +63,26 @@ class BusDecorator : public IBus {
   }
 
  protected:
-  IBus * bus_to_decorate_;
+  ~BusDecorator() { }
+
+  IBus<Component> * bus_to_decorate_;
+
+ private:
+  Derived * Self() { return static_cast<Derived *>(this); }
+};
+
+/**
+ * @brief Concrete decorator for the default color and intensity.
+ *
+ * Calls to \ref UpdateBusData function to decorator a bus using
+ * color maroon and the maximum intensity.
+ */
+template <typename Component>
+class BusDefaultDecorator
+  : public BusDecorator<BusDefaultDecorator<Component>, Component> {
+ public:
+  explicit BusDefaultDecorator(Component * bus_to_decorate)
+    : BusDecorator<BusDefaultDecorator, Component>(bus_to_decorate) {}
 };
 
 /**
@@ -65,10 +91,12 @@ class BusDecorator : public IBus {
  * Calls to \ref UpdateBusData function to decorator a bus using
  * color maroon.
  */
-class BusColorMaroonDecorator : public BusDecorator {
+template <typename Component>
+class BusColorMaroonDecorator
+  : public BusDecorator<BusColorMaroonDecorator<Component>, Component> {
  public:
-  explicit BusColorMaroonDecorator(IBus * bus_to_decorate)
-    : BusDecorator(bus_to_decorate) {}
+  explicit BusColorMaroonDecorator(Component * bus_to_decorate)
+    : BusDecorator<BusColorMaroonDecorator, Component>(bus_to_decorate) {}
   /**
   * @brief Decorate the bus color to be maroon.
   *
@@ -76,7 +104,7 @@ class BusColorMaroonDecorator : public BusDecorator {
   *
   */
   void UpdateBusData() {
-    SetColor(196, 34, 74);  // set the color to be maroon
+    this->SetColor(196, 34, 74);  // set the color to be maroon
   }
 };
 
@@ -87,10 +115,12 @@ class BusColorMaroonDecorator : public BusDecorator {
  * Calls to \ref UpdateBusData function to decorator a bus using
  * color gold.
  */
-class BusColorGoldDecorator : public BusDecorator {
+template <typename Component>
+class BusColorGoldDecorator
+  : public BusDecorator<BusColorGoldDecorator<Component>, Component> {
  public:
-  explicit BusColorGoldDecorator(IBus * bus_to_decorate)
-    : BusDecorator(bus_to_decorate) {}
+  explicit BusColorGoldDecorator(Component * bus_to_decorate)
+    : BusDecorator<BusColorGoldDecorator, Component>(bus_to_decorate) {}
   /**
   * @brief Decorate the bus color to be gold.
   *
@@ -98,7 +128,7 @@ class BusColorGoldDecorator : public BusDecorator {
   *
   */
   void UpdateBusData() {
-    SetColor(206, 163, 53);  // set the color to be gold
+    this->SetColor(206, 163, 53);  // set the color to be gold
   }
 };
 
@@ -107,10 +137,12 @@ class BusColorGoldDecorator : public BusDecorator {
  *
  * Calls to \ref SetIntensity function to decorator a bus's color intensity.
  */
-class BusIntensityDecorator : public BusDecorator {
+template <typename Component>
+class BusIntensityDecorator
+  : public BusDecorator<BusIntensityDecorator<Component>, Component> {
  public:
-  explicit BusIntensityDecorator(IBus * bus_to_decorate)
-    : BusDecorator(bus_to_decorate) {}
+  explicit BusIntensityDecorator(Component * bus_to_decorate)
+    : BusDecorator<BusIntensityDecorator, Component>(bus_to_decorate) {}
   /**
   * @brief Decorate the bus color intensity based on the number of
   * passengers on the bus.
@@ -120,8 +152,44 @@ class BusIntensityDecorator : public BusDecorator {
   * @param[in] alpha Intensity value to be set
   */
   void SetIntensity(int alpha) {
-    bus_to_decorate_->SetIntensity(alpha);
+    this->bus_to_decorate_->SetIntensity(alpha);
   }
 };
 
+// Update a bus through the static interface of a concrete decorator
+template <typename Derived>
+void Decorate(IBus<Derived> * decorator) {
+  decorator->UpdateBusData();
+}
+
+/**
+ * @brief Color policy, paints a bus with one decorator on its outgoing
+ * route and another one on its incoming route.
+ *
+ * Policies are plain functions, so the policy of a bus can be chosen at
+ * runtime, see VisualizationSimulator::SetColorPolicy for one per line,
+ * while each one is composed at compile time.
+ */
+template <template <typename> class Outgoing,
+          template <typename> class Incoming>
+struct BusColorPolicy {
+  template <typename Component>
+  static void Apply(Component * bus, bool incoming) {
+    if (incoming) {
+      Incoming<Component> decorator(bus);
+      Decorate(&decorator);
+    } else {
+      Outgoing<Component> decorator(bus);
+      Decorate(&decorator);
+    }
+  }
+};
+
+// Maroon on the way out, gold on the way back, the default
+typedef BusColorPolicy<BusColorMaroonDecorator, BusColorGoldDecorator>
+  MaroonGoldColorPolicy;
+// Gold on the way out, maroon on the way back
+typedef BusColorPolicy<BusColorGoldDecorator, BusColorMaroonDecorator>
+  GoldMaroonColorPolicy;
+
 #endif  // SRC_BUS_DECORATOR_H_
@@ -5,33 +5,21 @@
  */
 #include "src/bus_depot.h"
 
-/*******************************************************************************
- * Static Variable Initialization
- ******************************************************************************/
-BusFactory * Strategy::small_bus_factory_ = new BusFactory("Small");
-BusFactory * Strategy::medium_bus_factory_ = new BusFactory("Medium");
-BusFactory * Strategy::large_bus_factory_ = new BusFactory("Large");
-int StrategyA::state_ = 0;
-int StrategyB::state_ = 1;
-int StrategyC::state_ = 0;
-
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
 void BusDepot::SetStrategy(int type) {
-  // Delete the existing strategy_ to avoid memory leak
-  delete strategy_;
-
-  // Check which type of strategy to set
+  // Check which type of strategy to set, the strategies are owned by the
+  // depot so their rotation carries on where it left off
   if (type == 1) {
-    strategy_ = new StrategyA();
+    strategy_ = &strategy_a_;
   } else if (type == 2) {
-    strategy_ = new StrategyB();
+    strategy_ = &strategy_b_;
   } else if (type == 3) {
-    strategy_ = new StrategyC();
+    strategy_ = &strategy_c_;
   } else {
     // Only get here by default (non of the above values are specified)
-    strategy_ = new StrategyD();
+    strategy_ = &strategy_d_;
   }
 }
 
@@ -41,93 +29,94 @@ Bus * BusDepot::Generate(std::string name,
   return strategy_->GenerateBus(name, outbound, inbound, speed);
 }
 
-// Implementation of strategy A for generating bus
-// generate small and regular bus alternatively
-Bus * StrategyA::GenerateBus(std::string name,
-  Route * outbound, Route * inbound, double speed) {
-  Bus * new_bus = NULL;
-
-  // Check global state to decide to generate which type of bus
-  if (state_ % 2 == 0) {
-    std::cout << "Deploying strategy 1, "
-              << "bus size Small"
-              << std::endl;
-    new_bus = small_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 1;  // switch the global state to generate another bus next time
-  } else if (state_ % 2 == 1) {
-    std::cout << "Deploying strategy 1, "
-              << "bus size Medium"
-              << std::endl;
-    new_bus = medium_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 0;  // switch the global state to generate another bus next time
+BusDepot::~BusDepot() {
+  for (int i = 0; i < static_cast<int>(owned_.size()); i++) {
+    delete owned_[i].bus;
+    delete owned_[i].outbound;
+    delete owned_[i].inbound;
   }
+}
 
-  return new_bus;
+Bus * BusDepot::Deploy(std::string name,
+  Route * outbound, Route * inbound, double speed) {
+  std::string type = strategy_->NextFactory().GetType();
+  // Reuse a retired bus of the same type, its routes are the line's
+  for (int i = 0; i < static_cast<int>(retired_.size()); i++) {
+    if (retired_[i]->GetType() == type) {
+      Bus * bus = retired_[i];
+      retired_[i] = retired_.back();
+      retired_.pop_back();
+      bus->Reset(speed);
+      return bus;
+    }
+  }
+  return DeployType(name, type, outbound, inbound, speed);
 }
 
-// Implementation of strategy B for generating bus
-// generate regualr and large bus alternatively
-Bus * StrategyB::GenerateBus(std::string name,
+Bus * BusDepot::DeployType(std::string name, std::string type,
   Route * outbound, Route * inbound, double speed) {
-  Bus * new_bus = NULL;
+  OwnedBus owned;
+  owned.outbound = outbound->Clone();
+  owned.inbound = inbound->Clone();
+  owned.bus = BusFactory(type).Generate(name, owned.outbound, owned.inbound,
+                                        speed);
+  owned_.push_back(owned);
+  return owned.bus;
+}
+
+void BusDepot::Retire(Bus * bus) {
+  retired_.push_back(bus);
+}
 
-  // Check global state to decide to generate which type of bus
-  if (state_ % 3 == 1) {
-    std::cout << "Deploying strategy 2, "
-              << "bus size Medium"
-              << std::endl;
-    new_bus = medium_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 2;  // switch the global state to generate another bus next time
-  } else if (state_ % 3 == 2) {
-    std::cout << "Deploying strategy 2, "
-              << "bus size Large"
-              << std::endl;
-    new_bus = large_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 1;  // switch the global state to generate another bus next time
+void BusDepot::Save(CheckpointWriter * out) const {
+  out->WriteInt(static_cast<int>(strategy_a_.GetRotation()));
+  out->WriteInt(static_cast<int>(strategy_b_.GetRotation()));
+  out->WriteInt(static_cast<int>(strategy_c_.GetRotation()));
+  out->WriteInt(static_cast<int>(strategy_d_.GetRotation()));
+}
+
+void BusDepot::Load(CheckpointReader * in) {
+  strategy_a_.SetRotation(static_cast<unsigned int>(in->ReadInt()));
+  strategy_b_.SetRotation(static_cast<unsigned int>(in->ReadInt()));
+  strategy_c_.SetRotation(static_cast<unsigned int>(in->ReadInt()));
+  strategy_d_.SetRotation(static_cast<unsigned int>(in->ReadInt()));
+}
+
+// Implementation of strategy A for generating bus
+// generate small and regular bus alternatively
+BusFactory& StrategyA::NextFactory() {
+  // Check the rotation to decide to generate which type of bus
+  if (NextInRotation() % 2 == 0) {
+    return small_bus_factory_;
   }
+  return medium_bus_factory_;
+}
 
-  return new_bus;
+// Implementation of strategy B for generating bus
+// generate regualr and large bus alternatively
+BusFactory& StrategyB::NextFactory() {
+  // Check the rotation to decide to generate which type of bus
+  if (NextInRotation() % 2 == 0) {
+    return medium_bus_factory_;
+  }
+  return large_bus_factory_;
 }
 
 // Implementation of strategy C for generating bus
 // generate small, regualr and large bus alternatively
-Bus * StrategyC::GenerateBus(std::string name,
-  Route * outbound, Route * inbound, double speed) {
-  Bus * new_bus = NULL;
-
-  // Check global state to decide to generate which type of bus
-  if (state_ % 3 == 0) {
-    std::cout << "Deploying strategy 3, "
-              << "bus size Small"
-              << std::endl;
-    new_bus = small_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 1;  // switch the global state to generate another bus next time
-  } else if (state_ % 3 == 1) {
-    std::cout << "Deploying strategy 3, "
-              << "bus size Medium"
-              << std::endl;
-    new_bus = medium_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 2;  // switch the global state to generate another bus next time
-  } else if (state_ % 3 == 2) {
-    std::cout << "Deploying strategy 3, "
-              << "bus size large"
-              << std::endl;
-    new_bus = large_bus_factory_->Generate(name, outbound, inbound, speed);
-    state_ = 0;  // switch the global state to generate another bus next time
+BusFactory& StrategyC::NextFactory() {
+  // Check the rotation to decide to generate which type of bus
+  unsigned int next = NextInRotation() % 3;
+  if (next == 0) {
+    return small_bus_factory_;
+  } else if (next == 1) {
+    return medium_bus_factory_;
   }
-
-  return new_bus;
+  return large_bus_factory_;
 }
 
 // Implementation of strategy D for generating bus
 // generate small bus only
-Bus * StrategyD::GenerateBus(std::string name,
-  Route * outbound, Route * inbound, double speed) {
-  std::cout << "Deploying small bus strategy, "
-            << "bus size Small"
-            << std::endl;
-
-  Bus * new_bus = small_bus_factory_->Generate(name, outbound, inbound, speed);
-
-  return new_bus;
+BusFactory& StrategyD::NextFactory() {
+  return small_bus_factory_;
 }
@@ -9,6 +9,7 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <atomic>
 #include <string>
 #include <vector>
 #include <random>
@@ -16,53 +17,17 @@
 
 #include "src/bus.h"
 #include "src/bus_factory.h"
-
-class Strategy;
+#include "src/checkpoint.h"
 
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
-/**
- * @brief The main class for bus depot.
- *
- * Calls to \ref SetStrategy function to set a type of strategy.
- *
- * Calls to \ref GenerateBus function to generate a type of bus
- * using Strategy Pattern.
- */
-class BusDepot {
- public:  // public Reporter
-  BusDepot() : strategy_(NULL) {}
-  ~BusDepot() {}
- /**
-  * @brief Set a specific strategy for generating buses.
-  *
-  * This function will be used for simulation purposes.
-  *
-  * @param[in] type A type of strategy
-  */
-  void SetStrategy(int type);
- /**
-  * @brief Generate a type of bus using a specific strategy.
-  *
-  * @param[in] name Bus name
-  * @param[in] outbound Outgoing route
-  * @param[in] inbound Ingoing route
-  * @param[in] speed Bus speed
-  * @return Bus object with name, route, type and speed.
-  */
-  Bus * Generate(std::string name, Route * outbound, Route * inbound,
-                    double speed);
-
- private:
-  Strategy * strategy_;
-};
-
 /**
  * @brief The Strategy Abstract Interface Class.
  *
  * Calls to \ref GenerateBus function to generate a type of bus
  * using a type of strategy.
+ * Calls to \ref NextFactory function to pick the type of the next bus.
  */
 class Strategy {
  public:
@@ -76,19 +41,43 @@ class Strategy {
   * @param[in] Bus speed
   * @return Bus object with name, route, type and speed.
   */
-  virtual Bus * GenerateBus(std::string name,
-    Route * outbound, Route * inbound, double speed) = 0;
+  Bus * GenerateBus(std::string name,
+    Route * outbound, Route * inbound, double speed) {
+    return NextFactory().Generate(name, outbound, inbound, speed);
+  }
+ /**
+  * @brief Pick the factory of the next bus, advancing the rotation.
+  *
+  * @return Factory of the bus type to deploy next.
+  */
+  virtual BusFactory& NextFactory() = 0;
+  // Position in the rotation, saved with a checkpoint
+  unsigned int GetRotation() const { return next_.load(); }
+  void SetRotation(unsigned int next) { next_.store(next); }
 
  protected:
-  static BusFactory * small_bus_factory_;
-  static BusFactory * medium_bus_factory_;
-  static BusFactory * large_bus_factory_;
+  Strategy() : small_bus_factory_("Small"), medium_bus_factory_("Medium"),
+               large_bus_factory_("Large"), next_(0) {}
+  /**
+   * @brief Get the position of the next bus in the rotation.
+   *
+   * Lock-free, so depots may spawn busses from several threads.
+   */
+  unsigned int NextInRotation() { return next_.fetch_add(1); }
+
+  // Owned by each strategy, nothing is shared between depots
+  BusFactory small_bus_factory_;
+  BusFactory medium_bus_factory_;
+  BusFactory large_bus_factory_;
+
+ private:
+  std::atomic<unsigned int> next_;
 };
 
 /**
  * @brief One of the strategy implementations.
  *
- * Calls to \ref GenerateBus function to generate small and regular buses
+ * Calls to \ref NextFactory function to generate small and regular buses
  * alternatively.
  */
 class StrategyA : public Strategy {
@@ -96,27 +85,17 @@ class StrategyA : public Strategy {
   StrategyA() {}
   ~StrategyA() {}
  /**
-  * @brief Generate a type of bus using strategy 1.
+  * @brief Pick the type of the next bus using strategy 1.
   *
   * Generate small and regular buses alternatively.
-  *
-  * @param[in] name Bus name
-  * @param[in] outbound Outgoing route
-  * @param[in] inbound Ingoing route
-  * @param[in] Bus speed
-  * @return Bus object with name, route, type and speed.
   */
-  Bus * GenerateBus(std::string name,
-    Route * outbound, Route * inbound, double speed) override;
-
- private:
-  static int state_;
+  BusFactory& NextFactory() override;
 };
 
 /**
  * @brief One of the strategy implementations.
  *
- * Calls to \ref GenerateBus function to generate regular and large buses
+ * Calls to \ref NextFactory function to generate regular and large buses
  * alternatively.
  */
 class StrategyB : public Strategy {
@@ -124,27 +103,17 @@ class StrategyB : public Strategy {
   StrategyB() {}
   ~StrategyB() {}
  /**
-  * @brief Generate a type of bus using strategy 2.
+  * @brief Pick the type of the next bus using strategy 2.
   *
   * Generate regular and large buses alternatively.
-  *
-  * @param[in] name Bus name
-  * @param[in] outbound Outgoing route
-  * @param[in] inbound Ingoing route
-  * @param[in] Bus speed
-  * @return Bus object with name, route, type and speed.
   */
-  Bus * GenerateBus(std::string name,
-    Route * outbound, Route * inbound, double speed) override;
-
- private:
-  static int state_;
+  BusFactory& NextFactory() override;
 };
 
 /**
  * @brief One of the strategy implementations.
  *
- * Calls to \ref GenerateBus function to generate small, 
+ * Calls to \ref NextFactory function to generate small,
  * regular and large buses alternatively.
  */
 class StrategyC : public Strategy {
@@ -152,45 +121,124 @@ class StrategyC : public Strategy {
   StrategyC() {}
   ~StrategyC() {}
  /**
-  * @brief Generate a type of bus using strategy 3.
+  * @brief Pick the type of the next bus using strategy 3.
   *
   * Generate small, regular and large buses alternatively.
-  *
-  * @param[in] name Bus name
-  * @param[in] outbound Outgoing route
-  * @param[in] inbound Ingoing route
-  * @param[in] Bus speed
-  * @return Bus object with name, route, type and speed.
   */
-  Bus * GenerateBus(std::string name,
-    Route * outbound, Route * inbound, double speed) override;
-
- private:
-  static int state_;
+  BusFactory& NextFactory() override;
 };
 
 /**
  * @brief One of the strategy implementations.
  *
- * Calls to \ref GenerateBus function to generate small buses only.
+ * Calls to \ref NextFactory function to generate small buses only.
  */
 class StrategyD : public Strategy {
  public:
   StrategyD() {}
   ~StrategyD() {}
  /**
-  * @brief Generate a type of bus using default strategy.
+  * @brief Pick the type of the next bus using default strategy.
   *
   * Generate only small buses.
+  */
+  BusFactory& NextFactory() override;
+};
+
+/**
+ * @brief The main class for bus depot.
+ *
+ * A depot owns one instance of every strategy. Each strategy keeps its own
+ * rotation, which survives switching strategies, and nothing is shared with
+ * other depots or simulations.
+ *
+ * Busses put on the road by \ref Deploy are owned by the depot. A depot
+ * serves a single line, so a retired bus keeps its route clones and goes
+ * back on the road with its cursors rewound instead of being reallocated.
+ *
+ * Calls to \ref SetStrategy function to set a type of strategy.
+ * Calls to \ref Generate function to generate a type of bus
+ * using Strategy Pattern.
+ * Calls to \ref Deploy function to get a new or recycled bus of the line.
+ * Calls to \ref Retire function when that bus finished its trip.
+ * Calls to \ref Save and \ref Load functions to checkpoint the rotations.
+ */
+class BusDepot {
+ public:  // public Reporter
+  BusDepot() : strategy_(&strategy_d_) {}
+  ~BusDepot();
+ /**
+  * @brief Set a specific strategy for generating buses.
+  *
+  * This function will be used for simulation purposes.
+  *
+  * @param[in] type A type of strategy
+  */
+  void SetStrategy(int type);
+ /**
+  * @brief Generate a type of bus using a specific strategy.
   *
   * @param[in] name Bus name
   * @param[in] outbound Outgoing route
   * @param[in] inbound Ingoing route
-  * @param[in] Bus speed
+  * @param[in] speed Bus speed
   * @return Bus object with name, route, type and speed.
   */
-  Bus * GenerateBus(std::string name,
-    Route * outbound, Route * inbound, double speed) override;
+  Bus * Generate(std::string name, Route * outbound, Route * inbound,
+                    double speed);
+ /**
+  * @brief Put a bus of the next type on the line, recycling a retired one.
+  *
+  * Unlike Generate, the depot clones the routes and keeps the bus. A
+  * recycled bus keeps the name it was allocated with, so a line interns
+  * no more names than it ever has busses at once.
+  *
+  * @param[in] name Bus name, only used if a new bus is allocated
+  * @param[in] outbound Prototype outgoing route of the line
+  * @param[in] inbound Prototype ingoing route of the line
+  * @param[in] speed Bus speed
+  * @return Bus owned by the depot, valid until the depot is deleted.
+  */
+  Bus * Deploy(std::string name, Route * outbound, Route * inbound,
+                  double speed);
+ /**
+  * @brief Put a new bus of a given type on the line, outside the rotation.
+  *
+  * Used to bring back the busses of a checkpoint under their own names.
+  *
+  * @param[in] type Small, Medium or Large
+  * @return Bus owned by the depot, as for Deploy.
+  */
+  Bus * DeployType(std::string name, std::string type, Route * outbound,
+                      Route * inbound, double speed);
+ /**
+  * @brief Take back a deployed bus, it is reused by a later Deploy.
+  */
+  void Retire(Bus * bus);
+  // Number of busses ever allocated by Deploy and DeployType
+  int GetNumOwned() const { return static_cast<int>(owned_.size()); }
+  // Checkpoint of the rotation of every strategy, the strategy in use
+  // follows the dispatch plan and is not saved
+  void Save(CheckpointWriter * out) const;
+  void Load(CheckpointReader * in);
+
+ private:
+  // A deployed bus with the route clones it travels on
+  struct OwnedBus {
+    Bus * bus;
+    Route * outbound;
+    Route * inbound;
+  };
+
+  BusDepot(const BusDepot&) = delete;
+  BusDepot& operator=(const BusDepot&) = delete;
+  StrategyA strategy_a_;
+  StrategyB strategy_b_;
+  StrategyC strategy_c_;
+  StrategyD strategy_d_;
+  Strategy * strategy_;
+  std::vector<OwnedBus> owned_;
+  std::vector<Bus *> retired_;
 };
 
 #endif  // SRC_BUS_DEPOT_H_
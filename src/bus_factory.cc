@@ -11,7 +11,8 @@
 // Code for generation of a bus
 Bus * BusFactory::Generate(std::string name, Route * outbound,
     Route * inbound, double speed) {
-    int rand_int = GetRandomInteger();
+    // Only a random type needs a random number
+    int rand_int = type_ == "Random" ? GetRandomInteger() : 0;
 
     // Check which type of bus needs to be create
     if (type_ == "Small" || (type_ == "Random" && rand_int == 1)) {
@@ -35,6 +35,7 @@ class BusFactory {
   */
   Bus * Generate(std::string name, Route * outbound, Route * inbound,
                   double speed = 1);
+  std::string GetType() const { return type_; }
 
  private:  // private reporter
   int GetRandomInteger();
@@ -0,0 +1,147 @@
+/**
+ * @file checkpoint.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "src/util.h"
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const uint32_t Checkpoint::kVersion;
+
+static const char kMagic[8] = {'B', 'U', 'S', 'C', 'K', 'P', 'T', '\0'};
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void CheckpointWriter::WriteString(const std::string& value) {
+  WriteInt(static_cast<int>(value.size()));
+  data_.append(value);
+}
+
+bool CheckpointReader::Take(void * value, size_t size) {
+  if (!IsOk() || data_.size() - offset_ < size) {
+    std::memset(value, 0, size);
+    return Fail("truncated checkpoint");
+  }
+  std::memcpy(value, data_.data() + offset_, size);
+  offset_ += size;
+  return true;
+}
+
+int CheckpointReader::ReadInt() {
+  int value;
+  Take(&value, sizeof(value));
+  return value;
+}
+
+double CheckpointReader::ReadDouble() {
+  double value;
+  Take(&value, sizeof(value));
+  return value;
+}
+
+std::string CheckpointReader::ReadString() {
+  int size = ReadCount(1);
+  std::string value(data_, IsOk() ? offset_ : 0, size);
+  offset_ += size;
+  return value;
+}
+
+int CheckpointReader::ReadCount(size_t itemSize) {
+  int count = ReadInt();
+  if (count < 0 || static_cast<size_t>(count) * itemSize >
+                   data_.size() - offset_) {
+    Fail("truncated checkpoint");
+    return 0;
+  }
+  return count;
+}
+
+bool CheckpointReader::Fail(const std::string& error) {
+  if (error_.empty()) {
+    error_ = error;
+  }
+  return false;
+}
+
+bool Checkpoint::Write(const std::string& path, const std::string& body,
+                       std::string * error) {
+  CheckpointHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.body_size = body.size();
+  header.checksum = Util::Checksum(Util::kChecksumSeed, body.data(),
+                                   body.size());
+
+  std::string partial = path + ".partial";
+  std::ofstream out(partial.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(body.data(), body.size());
+  out.close();
+  if (!out) {
+    std::remove(partial.c_str());
+    *error = "cannot write the checkpoint";
+    return false;
+  }
+  if (std::rename(partial.c_str(), path.c_str()) != 0) {
+    std::remove(partial.c_str());
+    *error = "cannot replace the checkpoint";
+    return false;
+  }
+  return true;
+}
+
+bool Checkpoint::Read(const std::string& path, std::string * body,
+                      std::string * error) {
+  std::ifstream in(path.c_str(), std::ios::binary);
+  if (!in) {
+    *error = "cannot open the checkpoint";
+    return false;
+  }
+  CheckpointHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    *error = "truncated checkpoint";
+    return false;
+  }
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    *error = "not a checkpoint";
+    return false;
+  }
+  if (header.version != kVersion) {
+    *error = "checkpoint version " + std::to_string(header.version)
+           + ", expected " + std::to_string(kVersion);
+    return false;
+  }
+
+  // The size is checked against the file before allocating for it
+  std::streampos start = in.tellg();
+  in.seekg(0, std::ios::end);
+  if (static_cast<uint64_t>(in.tellg() - start) != header.body_size) {
+    *error = "truncated checkpoint";
+    return false;
+  }
+  in.seekg(start);
+  body->resize(header.body_size);
+  if (!in.read(&(*body)[0], header.body_size)) {
+    *error = "truncated checkpoint";
+    return false;
+  }
+  if (Util::Checksum(Util::kChecksumSeed, body->data(), body->size())
+      != header.checksum) {
+    *error = "checksum mismatch";
+    return false;
+  }
+  return true;
+}
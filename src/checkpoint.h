@@ -0,0 +1,134 @@
+/**
+ * @file checkpoint.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_CHECKPOINT_H_
+#define SRC_CHECKPOINT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <string>
+
+/*******************************************************************************
+ * Checkpoint Records
+ ******************************************************************************/
+// The body follows the header, it is written by the simulation with
+// CheckpointWriter and read back with CheckpointReader
+struct CheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t checksum;  // FNV-1a of the body
+  uint64_t body_size;
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Memory buffer the state of a simulation is saved into.
+ *
+ * Values keep their native size and byte order, like a NetworkImage, so a
+ * checkpoint is read back on the kind of machine that wrote it.
+ *
+ * Calls to \ref WriteInt, \ref WriteDouble and \ref WriteString functions
+ * to append a value.
+ */
+class CheckpointWriter {
+ public:
+  void WriteInt(int value) { Append(&value, sizeof(value)); }
+  void WriteDouble(double value) { Append(&value, sizeof(value)); }
+  // Length, then the bytes
+  void WriteString(const std::string& value);
+  const std::string& GetData() const { return data_; }
+  // Hand the buffer over without copying it, the writer is left empty
+  void Swap(std::string * data) { data_.swap(*data); }
+
+ private:
+  void Append(const void * value, size_t size) {
+    data_.append(static_cast<const char *>(value), size);
+  }
+  std::string data_;
+};
+
+/**
+ * @brief Reads the values of a CheckpointWriter back, in the same order.
+ *
+ * Reading past the end fails the reader, every later read returns 0 or an
+ * empty string, so a caller checks \ref IsOk once after a group of reads.
+ *
+ * Calls to \ref ReadInt, \ref ReadDouble and \ref ReadString functions to
+ * read the next value.
+ * Calls to \ref ReadCount function to read the size of a list.
+ * Calls to \ref Fail function to reject a value that was read.
+ */
+class CheckpointReader {
+ public:
+  explicit CheckpointReader(const std::string& data) :
+    data_(data), offset_(0) {}
+  int ReadInt();
+  double ReadDouble();
+  std::string ReadString();
+ /**
+  * @brief Read the number of items of a list.
+  *
+  * A count the rest of the data cannot hold fails the reader, so a damaged
+  * checkpoint never makes the caller allocate for it.
+  *
+  * @param[in] itemSize Fewest bytes an item takes
+  * @return The count, 0 once the reader failed.
+  */
+  int ReadCount(size_t itemSize);
+ /**
+  * @brief Fail the reader, keeping the first reason given.
+  *
+  * @return false, to return it from the caller.
+  */
+  bool Fail(const std::string& error);
+  bool IsOk() const { return error_.empty(); }
+  bool AtEnd() const { return offset_ == data_.size(); }
+  const std::string& GetError() const { return error_; }
+
+ private:
+  bool Take(void * value, size_t size);
+  const std::string& data_;
+  size_t offset_;
+  std::string error_;
+};
+
+/**
+ * @brief Versioned, checksummed file of a simulation checkpoint.
+ *
+ * Calls to \ref Write function to save the body of a checkpoint.
+ * Calls to \ref Read function to load and validate one.
+ */
+class Checkpoint {
+ public:
+  static const uint32_t kVersion = 3;
+
+ /**
+  * @brief Save a body, written by a CheckpointWriter, with its header.
+  *
+  * The file is written under a temporary name and renamed, so a crash
+  * while writing never leaves a truncated checkpoint behind.
+  *
+  * @param[out] error Reason of a failure
+  * @return false if the file cannot be written.
+  */
+  static bool Write(const std::string& path, const std::string& body,
+                    std::string * error);
+ /**
+  * @brief Load a checkpoint and check its version, size and checksum.
+  *
+  * @param[out] body Body to read with a CheckpointReader
+  * @param[out] error Reason of a failure
+  * @return false if the checkpoint cannot be used.
+  */
+  static bool Read(const std::string& path, std::string * body,
+                   std::string * error);
+};
+
+#endif  // SRC_CHECKPOINT_H_
@@ -0,0 +1,158 @@
+/**
+ * @file cluster_grid.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/cluster_grid.h"
+
+#include <cmath>
+
+#include "src/spatial_grid.h"
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+ClusterGrid::ClusterGrid(double cellSize) : cellSize_(cellSize) {}
+
+int64_t ClusterGrid::CellOf(double x, double y) const {
+  return SpatialGrid::CellKey(
+    static_cast<int64_t>(std::floor(x / cellSize_)),
+    static_cast<int64_t>(std::floor(y / cellSize_)));
+}
+
+ClusterGrid::Contribution * ClusterGrid::Find(
+    std::vector<Contribution> * list, int id) {
+  if (id >= static_cast<int>(list->size())) {
+    Contribution absent = {false, 0, 0, 0, 0};
+    list->resize(id + 1, absent);
+  }
+  return &(*list)[id];
+}
+
+void ClusterGrid::AddBus(const Contribution& bus, int sign) {
+  Cluster& cluster = cells_[bus.cell];
+  cluster.num_busses += sign;
+  cluster.num_passengers += sign * bus.passengers;
+  cluster.capacity += sign * bus.capacity;
+
+  // A handful of colors at most, one per direction and color policy
+  std::vector<std::pair<int, int> >& colors = cluster.colors;
+  for (int i = 0; i < static_cast<int>(colors.size()); i++) {
+    if (colors[i].first == bus.color) {
+      colors[i].second += sign;
+      if (colors[i].second == 0) {
+        colors.erase(colors.begin() + i);
+      }
+      return;
+    }
+  }
+  colors.push_back(std::make_pair(bus.color, sign));
+}
+
+void ClusterGrid::AddStop(const Contribution& stop, int sign) {
+  Cluster& cluster = cells_[stop.cell];
+  cluster.num_stops += sign;
+  cluster.num_waiting += sign * stop.passengers;
+}
+
+void ClusterGrid::Release(int64_t cell) {
+  std::unordered_map<int64_t, Cluster>::iterator it = cells_.find(cell);
+  if (it != cells_.end() && it->second.num_busses == 0
+      && it->second.num_stops == 0) {
+    cells_.erase(it);
+  }
+}
+
+void ClusterGrid::UpdateBus(int id, double x, double y, int passengers,
+                            int capacity, int color) {
+  if (id < 0) return;
+  Contribution * bus = Find(&busses_, id);
+  if (bus->present) {
+    AddBus(*bus, -1);
+  }
+  int64_t old = bus->cell;
+  bool moved = bus->present;
+  bus->present = true;
+  bus->cell = CellOf(x, y);
+  bus->passengers = passengers;
+  bus->capacity = capacity;
+  bus->color = color;
+  AddBus(*bus, 1);
+  if (moved && old != bus->cell) {
+    Release(old);
+  }
+}
+
+void ClusterGrid::RemoveBus(int id) {
+  if (id < 0 || id >= static_cast<int>(busses_.size())
+      || !busses_[id].present) {
+    return;
+  }
+  AddBus(busses_[id], -1);
+  busses_[id].present = false;
+  Release(busses_[id].cell);
+}
+
+void ClusterGrid::UpdateStop(int id, double x, double y, int waiting) {
+  if (id < 0) return;
+  Contribution * stop = Find(&stops_, id);
+  if (stop->present) {
+    AddStop(*stop, -1);
+  }
+  int64_t old = stop->cell;
+  bool moved = stop->present;
+  stop->present = true;
+  stop->cell = CellOf(x, y);
+  stop->passengers = waiting;
+  stop->capacity = 0;
+  stop->color = 0;
+  AddStop(*stop, 1);
+  if (moved && old != stop->cell) {
+    Release(old);
+  }
+}
+
+void ClusterGrid::RemoveStop(int id) {
+  if (id < 0 || id >= static_cast<int>(stops_.size())
+      || !stops_[id].present) {
+    return;
+  }
+  AddStop(stops_[id], -1);
+  stops_[id].present = false;
+  Release(stops_[id].cell);
+}
+
+void ClusterGrid::Clear() {
+  busses_.clear();
+  stops_.clear();
+  cells_.clear();
+}
+
+void ClusterGrid::GetTiles(std::vector<ClusterTile> * tiles) const {
+  tiles->clear();
+  tiles->reserve(cells_.size());
+  for (std::unordered_map<int64_t, Cluster>::const_iterator it =
+       cells_.begin(); it != cells_.end(); it++) {
+    const Cluster& cluster = it->second;
+    ClusterTile tile;
+    tile.column = SpatialGrid::CellColumn(it->first);
+    tile.row = SpatialGrid::CellRow(it->first);
+    tile.num_busses = cluster.num_busses;
+    tile.num_passengers = cluster.num_passengers;
+    tile.capacity = cluster.capacity;
+    tile.color = -1;
+    int most = 0;
+    for (int i = 0; i < static_cast<int>(cluster.colors.size()); i++) {
+      if (cluster.colors[i].second > most) {
+        most = cluster.colors[i].second;
+        tile.color = cluster.colors[i].first;
+      }
+    }
+    tile.num_stops = cluster.num_stops;
+    tile.num_waiting = cluster.num_waiting;
+    tiles->push_back(tile);
+  }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file cluster_grid.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_CLUSTER_GRID_H_
+#define SRC_CLUSTER_GRID_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The busses and stops of a grid cell, summed up.
+ */
+struct Cluster {
+  Cluster() : num_busses(0), num_passengers(0), capacity(0), num_stops(0),
+    num_waiting(0) {}
+  int num_busses;
+  int num_passengers;
+  int capacity;
+  // Packed 0xRRGGBB bus colors, which tell the direction, with the number
+  // of busses of each
+  std::vector<std::pair<int, int> > colors;
+  int num_stops;
+  int num_waiting;  // passengers waiting at the stops
+};
+
+/**
+ * @brief A cluster as sent to the browsers, plain data.
+ */
+struct ClusterTile {
+  int column;
+  int row;
+  int num_busses;
+  int num_passengers;
+  int capacity;
+  int color;  // most common bus color, or -1 without busses
+  int num_stops;
+  int num_waiting;
+};
+
+/**
+ * @brief Busses and stops summed up per grid cell, for zoomed out views.
+ *
+ * Every entity remembers what it added to its cell, so an update takes the
+ * old contribution out and puts the new one in, and the clusters never
+ * have to be recomputed from scratch. Only occupied cells are stored.
+ *
+ * Calls to \ref UpdateBus function to add or move a bus.
+ * Calls to \ref UpdateStop function to add a stop or change its queue.
+ * Calls to \ref GetTiles function to read the clusters.
+ */
+class ClusterGrid {
+ public:
+ /**
+  * @param[in] cellSize Width and height of a cell
+  */
+  explicit ClusterGrid(double cellSize);
+ /**
+  * @brief Add a bus, or replace what it adds to the clusters.
+  *
+  * @param[in] id Interned id, see NameTable
+  * @param[in] color Packed 0xRRGGBB color
+  */
+  void UpdateBus(int id, double x, double y, int passengers, int capacity,
+                 int color);
+  void RemoveBus(int id);
+ /**
+  * @brief Add a stop, or replace its queue length.
+  *
+  * @param[in] id Interned id, see NameTable
+  */
+  void UpdateStop(int id, double x, double y, int waiting);
+  void RemoveStop(int id);
+  void Clear();
+ /**
+  * @brief Get every occupied cell, in no particular order.
+  *
+  * @param[out] tiles Replaced with the clusters
+  */
+  void GetTiles(std::vector<ClusterTile> * tiles) const;
+  double GetCellSize() const { return cellSize_; }
+  int GetNumCells() const { return static_cast<int>(cells_.size()); }
+
+ private:
+  // What an entity adds to its cell
+  struct Contribution {
+    bool present;
+    int64_t cell;
+    int passengers;  // or waiting passengers for a stop
+    int capacity;
+    int color;
+  };
+  int64_t CellOf(double x, double y) const;
+  void AddBus(const Contribution& bus, int sign);
+  void AddStop(const Contribution& stop, int sign);
+  // Drop the cell if nothing is left in it
+  void Release(int64_t cell);
+  static Contribution * Find(std::vector<Contribution> * list, int id);
+
+  double cellSize_;
+  std::vector<Contribution> busses_;  // indexed by id
+  std::vector<Contribution> stops_;  // indexed by id
+  std::unordered_map<int64_t, Cluster> cells_;
+};
+
+#endif  // SRC_CLUSTER_GRID_H_
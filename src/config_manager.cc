@@ -4,194 +4,378 @@
  * @Copyright 2019 3081 Staff, All rights reserved.
  */
 
-#include <sstream>
-#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <list>
-#include <algorithm>
-// #include <functional>
+#include <unordered_map>
 
 #include "src/config_manager.h"
 
+#include "src/gtfs_importer.h"
+#include "src/mapped_file.h"
 #include "src/route.h"
 #include "src/stop.h"
 #include "src/random_passenger_generator.h"
 
+/***********************
+ * Tokenizer
+ ***********************/
+// A field of a line, pointing into the mapped file, nothing is copied
+struct ConfigField {
+    ConfigField() : begin(NULL), end(NULL) {}
+    ConfigField(const char * first, const char * last) :
+        begin(first), end(last) {}
+    size_t Length() const { return end - begin; }
+    bool Equals(const char * text) const {
+        return Length() == std::strlen(text)
+            && std::memcmp(begin, text, Length()) == 0;
+    }
+    const char * begin;
+    const char * end;
+};
+
+static bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static ConfigField Trim(ConfigField field) {
+    while (field.begin < field.end && IsBlank(*field.begin)) field.begin++;
+    while (field.end > field.begin && IsBlank(field.end[-1])) field.end--;
+    return field;
+}
+
+// Cut the next comma separated field off the line
+static ConfigField NextField(ConfigField * line) {
+    const char * comma = static_cast<const char *>(
+        std::memchr(line->begin, ',', line->Length()));
+    const char * end = comma ? comma : line->end;
+    ConfigField field(line->begin, end);
+    line->begin = comma ? comma + 1 : line->end;
+    return field;
+}
+
+// Numbers are short, so they are parsed from a copy on the stack
+static bool ParseDouble(ConfigField field, double * value) {
+    field = Trim(field);
+    char buffer[64];
+    if (field.Length() == 0 || field.Length() >= sizeof(buffer)) return false;
+    std::memcpy(buffer, field.begin, field.Length());
+    buffer[field.Length()] = '\0';
+    char * parsed;
+    *value = std::strtod(buffer, &parsed);
+    return parsed == buffer + field.Length();
+}
+
+static bool ParseInt(ConfigField field, int * value) {
+    field = Trim(field);
+    char buffer[32];
+    if (field.Length() == 0 || field.Length() >= sizeof(buffer)) return false;
+    std::memcpy(buffer, field.begin, field.Length());
+    buffer[field.Length()] = '\0';
+    char * parsed;
+    *value = static_cast<int>(std::strtol(buffer, &parsed, 10));
+    return parsed == buffer + field.Length();
+}
+
+// A stop is the same stop if both its name and its position match, the
+// coordinates bit for bit, as parsed from the same text
+struct StopKey {
+    ConfigField name;
+    double latitude;
+    double longitude;
+    bool operator==(const StopKey& other) const {
+        return name.Length() == other.name.Length()
+            && std::memcmp(name.begin, other.name.begin, name.Length()) == 0
+            && std::memcmp(&latitude, &other.latitude, sizeof(double)) == 0
+            && std::memcmp(&longitude, &other.longitude, sizeof(double)) == 0;
+    }
+};
+
+struct StopKeyHash {
+    size_t operator()(const StopKey& key) const {
+        // FNV-1a over the name, mixed with the coordinates
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char * c = key.name.begin; c != key.name.end; c++) {
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+        }
+        hash ^= std::hash<double>()(key.latitude) + (hash << 6);
+        hash ^= std::hash<double>()(key.longitude) + (hash << 6);
+        return static_cast<size_t>(hash);
+    }
+};
+
 /***********************
  * Member Functions
  ***********************/
+ConfigError::ConfigError(const std::string& file, int line,
+                         const std::string& message) :
+    std::runtime_error(file + ":" + std::to_string(line) + ": " + message),
+    line_(line) {
+}
+
 ConfigManager::ConfigManager() : routes(std::vector<Route *>()) {
 }
 
 ConfigManager::~ConfigManager() {
+    // Many networks are built and dropped in one process by a sweep, so
+    // everything the network made is freed with it
     for (int i = 0; i < static_cast<int>(routes.size()); i++) {
-        routes[i] = nullptr;
+        delete routes[i];
+        delete generators[i];
     }
     routes.clear();
+    generators.clear();
+    for (int i = 0; i < static_cast<int>(stops.size()); i++) {
+        stops[i].ClearPassengers();
+    }
 }
 
 void ConfigManager::ReadConfig(const std::string filename) {
     // Read in the configuration file for routes
-    std::ifstream configFile("config/" + filename);
+    ReadConfigFile("config/" + filename);
+}
 
-    // std::hash<std::string> stringHash;
+void ConfigManager::ReadConfigFile(const std::string& path) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        throw ConfigError(path, 0, "cannot open the file");
+    }
+    if (!stops.empty()) {
+        throw ConfigError(path, 0, "a configuration was already read");
+    }
+    const char * data = file.GetData();
+    const char * dataEnd = data + file.GetSize();
+
+    network = NetworkTables();
+
+    // Size the tables up front
+    int numStopLines = 0;
+    for (const char * pos = data; pos < dataEnd; ) {
+        const char * newline = static_cast<const char *>(
+            std::memchr(pos, '\n', dataEnd - pos));
+        const char * lineEnd = newline ? newline : dataEnd;
+        ConfigField line(pos, lineEnd);
+        if (Trim(NextField(&line)).Equals("STOP")) {
+            numStopLines++;
+        }
+        pos = lineEnd + 1;
+    }
+    network.stops.reserve(numStopLines);
+    network.route_stops.reserve(numStopLines);
+    network.probabilities.reserve(numStopLines);
 
-    std::list<Stop *> stops = std::list<Stop *>();  // stops along the route
-    std::list<double> distances = std::list<double>();
-    double oldLat = 0;
-    double oldLon = 0;
-    std::list<double> currProbabilities = std::list<double>();
+    // Stops along the current route, as indices into network.stops
+    std::unordered_map<StopKey, uint32_t, StopKeyHash> routeStopsByKey;
+    NetworkRouteRecord route = NetworkRouteRecord();
     std::string currGeneralName = "";
     std::string currRouteName = "";
-
-    std::vector<std::string> stopNames = std::vector<std::string>();
     int stopId = 10;
 
-    std::string line;
-    // Read in all stops information from the configuration file
-    while (std::getline(configFile, line)) {
-        std::istringstream stringStream(line);
-        std::string chunk;
-
-        // Check whether it is a valid line separated by commas
-        if (!std::getline(stringStream, chunk, ',')) { continue; }
-
-        if (chunk == "ROUTE_GENERAL") {
-            currGeneralName = "";
-            std::getline(stringStream, currGeneralName);
-        } else if (chunk == "ROUTE") {
+    // Add the route read so far, if any, to the tables
+    auto finishRoute = [&]() {
+        if (route.num_stops == 0) {
+            return;
+        }
+        std::string name = currGeneralName + " " + currRouteName;
+        route.name_offset = static_cast<uint32_t>(network.names.size());
+        route.name_length = static_cast<uint32_t>(name.size());
+        network.routes.push_back(route);
+        network.names += name;
+
+        route.num_stops = 0;
+        routeStopsByKey.clear();
+    };
+
+    int lineNumber = 0;
+    for (const char * pos = data; pos < dataEnd; ) {
+        const char * newline = static_cast<const char *>(
+            std::memchr(pos, '\n', dataEnd - pos));
+        const char * lineEnd = newline ? newline : dataEnd;
+        ConfigField line(pos, lineEnd);
+        pos = lineEnd + 1;
+        lineNumber++;
+
+        ConfigField chunk = Trim(NextField(&line));
+
+        if (chunk.Equals("DISPATCH")) {
+            // DISPATCH, start time step, bus depot strategy
+            int start;
+            int strategy;
+            if (!ParseInt(NextField(&line), &start)) {
+                throw ConfigError(path, lineNumber, "bad dispatch start");
+            }
+            if (!ParseInt(line, &strategy)) {
+                throw ConfigError(path, lineNumber, "bad dispatch strategy");
+            }
+            dispatchPlan.AddWindow(start, strategy);
+        } else if (chunk.Equals("ROUTE_GENERAL")) {
+            currGeneralName.assign(line.begin, line.end);
+        } else if (chunk.Equals("ROUTE")) {
             // If we are coming to a route besides our first one, save all our
             // data and init variables for next route
-            if (stops.size() > 0) {
-                // Convert our variables into the necessary raw memory
-                int numStops = static_cast<int>(stops.size());
-                Stop ** rawStops = new Stop *[numStops];
-                int it = 0;
-                for (auto* s : stops) {
-                    rawStops[it] = s;
-                    it++;
-                }
-
-                int numDists = static_cast<int>(distances.size());
-                double * rawDists = new double[numDists];
-                it = 0;
-                for (const auto& d : distances) {
-                    rawDists[it] = d;
-                    it++;
-                }
-
-                // Add a new route to the collection
-                routes.push_back(
-                    new Route(
-                        currGeneralName + " " + currRouteName,
-                        rawStops,
-                        rawDists,
-                        static_cast<int>(stops.size()),
-                        new RandomPassengerGenerator
-                        (currProbabilities, stops)));
-
-                stops.clear();
-                distances.clear();
-                currProbabilities.clear();
+            finishRoute();
+            route.first_stop =
+                static_cast<uint32_t>(network.route_stops.size());
+
+            currRouteName.clear();
+            for (const char * c = line.begin; c != line.end; c++) {
+                if (*c != ' ') currRouteName.push_back(*c);
             }
-            oldLat = 0;  // Refresh our old values on a new route
-            oldLon = 0;
-
-            std::getline(stringStream, currRouteName);
-            currRouteName.erase(
-                std::remove(currRouteName.begin(), currRouteName.end(), ' '),
-                currRouteName.end());
-
-        } else if (chunk == "STOP") {
-            // Grab our comma seperated values
-            std::string stopName;
-            std::getline(stringStream, stopName, ',');
-            stopName.erase(
-                std::remove(stopName.begin(), stopName.end(), ' '),
-                stopName.end());
-
-            // Check if the stop already exists
-            std::vector<std::string>::iterator it =
-                std::find(stopNames.begin(), stopNames.end(), stopName);
-            if (it != stopNames.end()) {
-                // We have already seen this stop
-                int index = std::distance(stopNames.begin(), it);
-
-                std::list<Stop *>::iterator iter = stops.begin();
-                std::advance(iter, index);
-
-                stops.push_back(*iter);
-                continue;
+        } else if (chunk.Equals("STOP")) {
+            // STOP, name, latitude, longitude, passenger generation chance
+            StopKey key;
+            key.name = Trim(NextField(&line));
+            if (key.name.Length() == 0) {
+                throw ConfigError(path, lineNumber, "missing stop name");
             }
-
-            // If we have not seen this stop, set it up
-            int id = stopId;
-            stopId++;
-
-            std::string latString;
-            std::getline(stringStream, latString, ',');
-            double latitude = std::stod(latString);
-
-            std::string lonString;
-            std::getline(stringStream, lonString, ',');
-            double longitude = std::stod(lonString);
-
-            stops.push_back(new Stop(id, latitude, longitude));
-
-            // Need to turn these lat and long into real-world distances
-            // This means moving 1 speed in a time click moves 1 mile.
-            // That's a bit far,
-            // so I multiply * 2 so that a speed of 1 moves 1/2 mile
-            latitude *= 69 * 2;
-            longitude *= 55 * 2;
-
-            // Grabbing last element from list is hard, so cache position
-            // instead
-            if (stops.size() > 1) {
-                double dist = sqrt((latitude-oldLat)*(latitude-oldLat)
-                        + (longitude-oldLon)*(longitude-oldLon));
-                distances.push_back(dist);
+            if (!ParseDouble(NextField(&line), &key.latitude)) {
+                throw ConfigError(path, lineNumber, "bad stop latitude");
+            }
+            if (!ParseDouble(NextField(&line), &key.longitude)) {
+                throw ConfigError(path, lineNumber, "bad stop longitude");
+            }
+            double probability;
+            if (!ParseDouble(line, &probability)) {
+                throw ConfigError(path, lineNumber, "bad stop probability");
             }
-            oldLat = latitude;
-            oldLon = longitude;
-
-            std::string probString;
-            std::getline(stringStream, probString);
-            double probability = std::stod(probString);
 
-            currProbabilities.push_back(probability);
+            // A stop listed twice on a route is the same stop. Routes do not
+            // share stops, passengers only know the stops of their route
+            std::unordered_map<StopKey, uint32_t, StopKeyHash>::iterator it =
+                routeStopsByKey.find(key);
+            uint32_t stop;
+            if (it != routeStopsByKey.end()) {
+                stop = it->second;
+            } else {
+                NetworkStopRecord record;
+                record.id = stopId;
+                record.reserved = 0;
+                record.latitude = key.latitude;
+                record.longitude = key.longitude;
+                stop = static_cast<uint32_t>(network.stops.size());
+                network.stops.push_back(record);
+                stopId++;
+                routeStopsByKey[key] = stop;
+            }
+            network.route_stops.push_back(stop);
+            network.probabilities.push_back(probability);
+            route.num_stops++;
         }
     }
 
     // Generatre our last route
-    if (stops.size() > 0) {
-        // Convert our variables into the necessary raw memory
-        int numStops = static_cast<int>(stops.size());
-        Stop ** rawStops = new Stop *[numStops];
-        int it = 0;
-        for (auto* s : stops) {
-            rawStops[it] = s;
-            it++;
-        }
+    finishRoute();
 
-        int numDists = static_cast<int>(distances.size());
-        double * rawDists = new double[numDists];
-        it = 0;
-        for (const auto& d : distances) {
-            rawDists[it] = d;
-            it++;
-        }
+    // Real-world distances in simulation units, for all routes in one go
+    network.MeasureSegments();
+    BuildNetwork(network.GetView());
+}
+
+void ConfigManager::AddRoute(const std::string& name, Stop ** routeStops,
+                             const double * distances,
+                             const double * bearings,
+                             const double * probabilities, int numStops) {
+    // The route copies the arrays into its own storage
+    generators.push_back(
+        new RandomPassengerGenerator(
+            std::list<double>(probabilities, probabilities + numStops),
+            std::list<Stop *>(routeStops, routeStops + numStops),
+            &random));
+    routes.push_back(
+        new Route(
+            name,
+            routeStops,
+            distances,
+            numStops,
+            generators.back(),
+            bearings,
+            &names));
+}
+
+NetworkTables ConfigManager::GetNetwork() const {
+    NetworkTables tables = network;
+    const std::vector<DispatchWindow>& windows = dispatchPlan.GetWindows();
+    for (int i = 0; i < static_cast<int>(windows.size()); i++) {
+        NetworkWindowRecord record;
+        record.start_time = windows[i].start_time;
+        record.strategy = windows[i].strategy;
+        tables.windows.push_back(record);
+    }
+    return tables;
+}
 
-        // Add the last route to the collection
-        routes.push_back(
-                new Route(
-                    currGeneralName + " " + currRouteName,
-                    rawStops,
-                    rawDists,
-                    static_cast<int>(stops.size()),
-                    new RandomPassengerGenerator(currProbabilities, stops)));
+void ConfigManager::WriteNetwork(const std::string& path) const {
+    std::string error;
+    if (!NetworkImage::Write(path, GetNetwork(), &error)) {
+        throw ConfigError(path, 0, error);
     }
+}
 
-    currProbabilities.clear();
-    stops.clear();
-    distances.clear();
+void ConfigManager::ReadNetwork(const std::string& path) {
+    NetworkImage image;
+    std::string error;
+    if (!image.Open(path, &error)) {
+        throw ConfigError(path, 0, error);
+    }
+    if (!stops.empty()) {
+        throw ConfigError(path, 0, "a configuration was already read");
+    }
+    // Copied out of the mapping, which is closed on return, for GetNetwork
+    network.Assign(image.GetView());
+    network.windows.clear();
+    BuildNetwork(image.GetView());
+}
+
+void ConfigManager::ReadGtfs(const std::string& directory,
+                             const std::string& demandPath, int numThreads) {
+    if (!stops.empty()) {
+        throw ConfigError(directory, 0, "a configuration was already read");
+    }
+    // The tables are kept, so an imported feed can be compiled too
+    GtfsImporter(numThreads).Import(directory, demandPath, &network);
+    BuildNetwork(network.GetView());
+}
+
+void ConfigManager::ReadTables(const NetworkTables& tables) {
+    if (!stops.empty()) {
+        throw ConfigError("tables", 0, "a configuration was already read");
+    }
+    network = tables;
+    BuildNetwork(network.GetView());
+    // Kept in dispatchPlan, like for the other sources
+    network.windows.clear();
+}
+
+void ConfigManager::BuildNetwork(const NetworkView& view) {
+    stops.reserve(view.num_stops);
+    for (uint32_t i = 0; i < view.num_stops; i++) {
+        const NetworkStopRecord& record = view.stops[i];
+        stops.emplace_back(record.id, record.latitude, record.longitude,
+                           &names);
+    }
+
+    // Distances, bearings and probabilities are used from the view as they
+    // are
+    std::vector<Stop *> routeStops;
+    for (uint32_t i = 0; i < view.num_routes; i++) {
+        const NetworkRouteRecord& record = view.routes[i];
+        routeStops.clear();
+        for (uint32_t j = 0; j < record.num_stops; j++) {
+            routeStops.push_back(
+                &stops[view.route_stops[record.first_stop + j]]);
+        }
+        AddRoute(std::string(view.names + record.name_offset,
+                             record.name_length),
+                 routeStops.data(),
+                 view.distances + record.first_stop + 1,
+                 view.bearings + record.first_stop + 1,
+                 view.probabilities + record.first_stop,
+                 static_cast<int>(record.num_stops));
+    }
+
+    for (uint32_t i = 0; i < view.num_windows; i++) {
+        dispatchPlan.AddWindow(view.windows[i].start_time,
+                               view.windows[i].strategy);
+    }
 }
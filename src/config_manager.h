@@ -7,23 +7,85 @@
 #ifndef SRC_CONFIG_MANAGER_H_
 #define SRC_CONFIG_MANAGER_H_
 
+#include <stdexcept>
 #include <vector>
 #include <string>
 
+#include "src/dispatch_plan.h"
+#include "src/name_table.h"
+#include "src/network_image.h"
+#include "src/random_streams.h"
+#include "src/stop.h"
 
+class PassengerGenerator;
 class Route;
 
+/**
+ * @brief A malformed line of a configuration file.
+ */
+class ConfigError : public std::runtime_error {
+ public:
+  ConfigError(const std::string& file, int line, const std::string& message);
+  // Line of the error, counting from 1, or 0 if it is about the whole file
+  int GetLine() const { return line_; }
+
+ private:
+  int line_;
+};
+
 class ConfigManager {
  public:
   ConfigManager();
   ~ConfigManager();
 
+  // Reads config/<filename>, throws ConfigError on a malformed line
   void ReadConfig(const std::string filename);
+  // Same, for a file anywhere. Call it once per ConfigManager, the stops of
+  // the routes live in it
+  void ReadConfigFile(const std::string& path);
+  // Saves the network read by ReadConfigFile as a binary image, see
+  // NetworkImage, throws ConfigError if it cannot be written
+  void WriteNetwork(const std::string& path) const;
+  // Loads a network image instead of a config, without any parsing or
+  // distance computation, throws ConfigError if the image is not valid
+  void ReadNetwork(const std::string& path);
+  // Imports a GTFS feed directory with a demand file, see GtfsImporter,
+  // numThreads 0 parses with one thread per core
+  void ReadGtfs(const std::string& directory, const std::string& demandPath,
+                int numThreads = 0);
+  // Builds a network from tables, such as the ones of GetNetwork of another
+  // ConfigManager, so every simulation of a sweep gets a network of its own
+  // without reading the source again
+  void ReadTables(const NetworkTables& tables);
+  // Tables of the network read, with its dispatch windows
+  NetworkTables GetNetwork() const;
 
   std::vector<Route *> GetRoutes() const { return routes; }
+  // Bus-type mix per simulation time window, from the DISPATCH lines
+  const DispatchPlan& GetDispatchPlan() const { return dispatchPlan; }
+  int GetNumStops() const { return static_cast<int>(stops.size()); }
+  // Random numbers every route of this network draws its passengers from
+  RandomStreams& GetRandom() { return random; }
+  // Names of the stops, routes and busses of this network, by id
+  NameTable& GetNames() { return names; }
 
  private:
+  // Builds the stops, routes and dispatch windows of a compiled network
+  void BuildNetwork(const NetworkView& view);
+  void AddRoute(const std::string& name, Stop ** routeStops,
+                const double * distances, const double * bearings,
+                const double * probabilities, int numStops);
   std::vector<Route *> routes;
+  // One per route, the routes do not own them
+  std::vector<PassengerGenerator *> generators;
+  // Every stop of every route, sized before the routes point into it
+  std::vector<Stop> stops;
+  DispatchPlan dispatchPlan;
+  // Tables of the network read, without the dispatch windows, for
+  // GetNetwork
+  NetworkTables network;
+  RandomStreams random;
+  NameTable names;
 };
 
 #endif  // SRC_CONFIG_MANAGER_H_
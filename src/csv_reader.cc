@@ -0,0 +1,194 @@
+/**
+ * @file csv_reader.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/csv_reader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "src/config_manager.h"
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::string CsvField::ToString() const {
+  std::string out;
+  CopyTo(&out);
+  return out;
+}
+
+void CsvField::CopyTo(std::string * out) const {
+  out->clear();
+  if (end - begin < 2 || *begin != '"') {
+    out->append(begin, end);
+    return;
+  }
+  // Drop the quotes, a doubled quote stands for one
+  for (const char * c = begin + 1; c < end - 1; c++) {
+    out->push_back(*c);
+    if (*c == '"' && c + 1 < end - 1 && c[1] == '"') c++;
+  }
+}
+
+// Numbers may be quoted or padded, and are parsed from a copy on the stack
+static bool CopyNumber(const CsvField& field, char * buffer, size_t size) {
+  const char * begin = field.begin;
+  const char * end = field.end;
+  if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+    begin++;
+    end--;
+  }
+  while (begin < end && *begin == ' ') begin++;
+  while (end > begin && end[-1] == ' ') end--;
+  size_t length = end - begin;
+  if (length == 0 || length >= size) return false;
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+  return true;
+}
+
+bool CsvField::ToDouble(double * value) const {
+  char buffer[64];
+  if (!CopyNumber(*this, buffer, sizeof(buffer))) return false;
+  char * parsed;
+  *value = std::strtod(buffer, &parsed);
+  return *parsed == '\0';
+}
+
+bool CsvField::ToInt(int * value) const {
+  char buffer[32];
+  if (!CopyNumber(*this, buffer, sizeof(buffer))) return false;
+  char * parsed;
+  *value = static_cast<int>(std::strtol(buffer, &parsed, 10));
+  return *parsed == '\0';
+}
+
+bool CsvReader::Open(const std::string& path) {
+  path_ = path;
+  columns_.clear();
+  body_ = NULL;
+  if (!file_.Open(path)) {
+    return false;
+  }
+  const char * data = file_.GetData();
+  const char * dataEnd = data + file_.GetSize();
+  // Feeds exported from spreadsheets often start with a byte order mark
+  if (dataEnd - data >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+    data += 3;
+  }
+  const char * newline = static_cast<const char *>(
+    std::memchr(data, '\n', dataEnd - data));
+  body_ = newline ? newline + 1 : dataEnd;
+
+  CsvRow header;
+  SplitLine(data, newline ? newline : dataEnd, &header);
+  for (int i = 0; i < header.Size(); i++) {
+    std::string name = header[i].ToString();
+    // Column names are compared without surrounding blanks
+    name.erase(0, name.find_first_not_of(" \t"));
+    name.erase(name.find_last_not_of(" \t") + 1);
+    columns_.push_back(name);
+  }
+  return true;
+}
+
+int CsvReader::GetColumn(const std::string& name) const {
+  std::vector<std::string>::const_iterator it =
+    std::find(columns_.begin(), columns_.end(), name);
+  return it == columns_.end() ? -1 : static_cast<int>(it - columns_.begin());
+}
+
+void CsvReader::SplitLine(const char * begin, const char * end,
+                          CsvRow * row) {
+  row->fields_.clear();
+  if (end > begin && end[-1] == '\r') end--;
+  const char * field = begin;
+  bool quoted = false;
+  for (const char * c = begin; c < end; c++) {
+    if (*c == '"') {
+      quoted = !quoted;
+    } else if (*c == ',' && !quoted) {
+      row->fields_.push_back(CsvField(field, c));
+      field = c + 1;
+    }
+  }
+  row->fields_.push_back(CsvField(field, end));
+}
+
+void CsvReader::ParseChunk(int chunk, const char * begin, const char * end,
+                           const Visitor& visit, const char ** error_row,
+                           std::string * error) const {
+  // The row, and its field list, are reused for the whole chunk
+  CsvRow row;
+  const char * line = begin;
+  try {
+    while (line < end) {
+      const char * newline = static_cast<const char *>(
+        std::memchr(line, '\n', end - line));
+      const char * lineEnd = newline ? newline : end;
+      // Blank lines, often at the end of a file, are not rows
+      if (lineEnd > line && !(lineEnd - line == 1 && *line == '\r')) {
+        SplitLine(line, lineEnd, &row);
+        visit(chunk, row);
+      }
+      line = lineEnd + 1;
+    }
+  } catch (const std::exception& e) {
+    *error_row = line;
+    *error = e.what();
+  }
+}
+
+void CsvReader::ForEachRow(int numChunks, const Visitor& visit) const {
+  const char * dataEnd = file_.GetData() + file_.GetSize();
+  if (!body_) return;
+  numChunks = std::max(1, numChunks);
+
+  // Chunk boundaries, moved forward to the start of a line
+  std::vector<const char *> bounds(numChunks + 1, dataEnd);
+  bounds[0] = body_;
+  size_t size = dataEnd - body_;
+  for (int i = 1; i < numChunks; i++) {
+    const char * bound = std::max(bounds[i - 1], body_ + size / numChunks * i);
+    if (bound > body_ && bound < dataEnd && bound[-1] != '\n') {
+      const char * newline = static_cast<const char *>(
+        std::memchr(bound, '\n', dataEnd - bound));
+      bound = newline ? newline + 1 : dataEnd;
+    }
+    bounds[i] = bound;
+  }
+
+  std::vector<const char *> errorRows(numChunks, NULL);
+  std::vector<std::string> errors(numChunks);
+  if (numChunks == 1) {
+    ParseChunk(0, bounds[0], bounds[1], visit, &errorRows[0], &errors[0]);
+  } else {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numChunks; i++) {
+      threads.push_back(std::thread(&CsvReader::ParseChunk, this, i,
+                                    bounds[i], bounds[i + 1],
+                                    std::cref(visit), &errorRows[i],
+                                    &errors[i]));
+    }
+    for (int i = 0; i < numChunks; i++) {
+      threads[i].join();
+    }
+  }
+
+  // Report the first rejected row of the file, counting its line only now
+  for (int i = 0; i < numChunks; i++) {
+    if (errorRows[i]) {
+      int line = 1 + static_cast<int>(
+        std::count(file_.GetData(), errorRows[i], '\n'));
+      throw ConfigError(path_, line, errors[i]);
+    }
+  }
+}
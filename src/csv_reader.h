@@ -0,0 +1,110 @@
+/**
+ * @file csv_reader.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_CSV_READER_H_
+#define SRC_CSV_READER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "src/mapped_file.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A field of a CSV row, pointing into the mapped file.
+ *
+ * Quoted fields keep their quotes until \ref ToString.
+ */
+struct CsvField {
+  CsvField() : begin(NULL), end(NULL) {}
+  CsvField(const char * begin, const char * end) : begin(begin), end(end) {}
+  bool IsEmpty() const { return begin == end; }
+  // Unquoted copy of the field
+  std::string ToString() const;
+  // Copies the field into a reused string, no allocation once it is large
+  // enough, use it for lookup keys
+  void CopyTo(std::string * out) const;
+  bool ToDouble(double * value) const;
+  bool ToInt(int * value) const;
+  const char * begin;
+  const char * end;
+};
+
+/**
+ * @brief A row of a CSV file, its fields are valid while the file is open.
+ */
+class CsvRow {
+ public:
+  // Field of a column, an empty field for a missing column
+  CsvField operator[](int column) const {
+    if (column < 0 || column >= static_cast<int>(fields_.size())) {
+      return CsvField();
+    }
+    return fields_[column];
+  }
+  int Size() const { return static_cast<int>(fields_.size()); }
+
+ private:
+  friend class CsvReader;
+  std::vector<CsvField> fields_;
+};
+
+/**
+ * @brief Memory-mapped CSV file with a header, parsed in parallel chunks.
+ *
+ * The body is cut into chunks at line boundaries, each chunk is parsed by
+ * its own thread straight from the mapping. Quoted fields may contain
+ * commas but not line breaks, which holds for GTFS feeds in practice.
+ *
+ * Calls to \ref Open function to map a file and read its header.
+ * Calls to \ref GetColumn function to find a column by name.
+ * Calls to \ref ForEachRow function to visit every row.
+ */
+class CsvReader {
+ public:
+  // Visits a row of a chunk, rows of a chunk come in file order. Throw
+  // std::runtime_error to reject the row
+  typedef std::function<void(int chunk, const CsvRow& row)> Visitor;
+
+ /**
+  * @brief Map a file and read its header line.
+  *
+  * @return false if the file cannot be opened.
+  */
+  bool Open(const std::string& path);
+ /**
+  * @brief Get the index of a column, or -1 if there is no such column.
+  */
+  int GetColumn(const std::string& name) const;
+ /**
+  * @brief Visit every row, one thread per chunk.
+  *
+  * Throws ConfigError with the line of the first rejected row.
+  *
+  * @param[in] numChunks Number of chunks and threads, at least 1
+  * @param[in] visit Called for every row, concurrently across chunks
+  */
+  void ForEachRow(int numChunks, const Visitor& visit) const;
+  const std::string& GetPath() const { return path_; }
+
+ private:
+  // Split a line into fields, respecting quotes
+  static void SplitLine(const char * begin, const char * end, CsvRow * row);
+  void ParseChunk(int chunk, const char * begin, const char * end,
+                  const Visitor& visit, const char ** error_row,
+                  std::string * error) const;
+  MappedFile file_;
+  std::string path_;
+  std::vector<std::string> columns_;
+  const char * body_ = NULL;  // first byte after the header line
+};
+
+#endif  // SRC_CSV_READER_H_
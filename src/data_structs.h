@@ -27,13 +27,14 @@ struct Color {
     int alpha;
 };
 
+// Entity ids are dense integers, see NameTable for their names
 struct BusData {
-    BusData(std::string id, Color color, Position pos, int n_pass, int cap):
+    BusData(int id, Color color, Position pos, int n_pass, int cap):
         id(id), position(pos), num_passengers(n_pass), capacity(cap),
         color(color) { }
-    BusData() : id(""), position(Position()), num_passengers(0), capacity(0),
+    BusData() : id(-1), position(Position()), num_passengers(0), capacity(0),
     color() {}
-    std::string id;
+    int id;
     Position position;
     int num_passengers;
     int capacity;
@@ -41,20 +42,27 @@ struct BusData {
 };
 
 struct StopData {
-    StopData(std::string id, Position pos , int n_peeps):
+    StopData(int id, Position pos , int n_peeps):
         id(id), position(pos), num_people(n_peeps) { }
-    StopData() : id(""), position(Position()), num_people(0) {}
-    std::string id;
+    StopData() : id(-1), position(Position()), num_people(0) {}
+    int id;
     Position position;
     int num_people;
 };
 
 struct RouteData {
-    explicit RouteData(std::string id) :
-        id(id), stops(std::vector<StopData>(0)) { }
-    RouteData() : id(""), stops(std::vector<StopData>(0)) {}
-    std::string id;
-    std::vector<StopData> stops;
+    explicit RouteData(int id) :
+        id(id), stops(std::vector<const StopData *>(0)),
+        num_people(std::vector<int>(0)), dirty(std::vector<bool>(0)) { }
+    RouteData() : id(-1), stops(std::vector<const StopData *>(0)),
+        num_people(std::vector<int>(0)), dirty(std::vector<bool>(0)) {}
+    int id;
+    // Static stop metadata (id, position), owned by each Stop and shared
+    std::vector<const StopData *> stops;
+    // Waiting counts, parallel to stops, refreshed every tick
+    std::vector<int> num_people;
+    // Set when the matching waiting count changed during the last tick
+    std::vector<bool> dirty;
 };
 
 #endif  // SRC_DATA_STRUCTS_H_
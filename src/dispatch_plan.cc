@@ -0,0 +1,44 @@
+/**
+ * @file dispatch_plan.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include "src/dispatch_plan.h"
+
+#include <algorithm>
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const int DispatchPlan::kDefaultStrategy;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+static bool StartsBefore(const DispatchWindow& a, const DispatchWindow& b) {
+  return a.start_time < b.start_time;
+}
+
+void DispatchPlan::AddWindow(int start_time, int strategy) {
+  // Keep the windows sorted, windows starting at the same time keep the
+  // order of the config file
+  DispatchWindow window(start_time, strategy);
+  windows_.insert(std::upper_bound(windows_.begin(), windows_.end(), window,
+                                   StartsBefore), window);
+}
+
+bool DispatchCursor::Advance(int time) {
+  if (!plan_) {
+    return false;
+  }
+  const std::vector<DispatchWindow>& windows = plan_->GetWindows();
+  int strategy = strategy_;
+  while (next_ < static_cast<int>(windows.size())
+         && windows[next_].start_time <= time) {
+    strategy = windows[next_].strategy;
+    next_++;
+  }
+  bool changed = (strategy != strategy_);
+  strategy_ = strategy;
+  return changed;
+}
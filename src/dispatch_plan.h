@@ -0,0 +1,80 @@
+/**
+ * @file dispatch_plan.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_DISPATCH_PLAN_H_
+#define SRC_DISPATCH_PLAN_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+// From start_time on, busses are deployed with the given BusDepot strategy
+struct DispatchWindow {
+  DispatchWindow(int start_time, int strategy) :
+    start_time(start_time), strategy(strategy) {}
+  int start_time;  // simulation time step
+  int strategy;  // see BusDepot::SetStrategy
+};
+
+/**
+ * @brief Which bus-type mix to deploy at which simulation time.
+ *
+ * Read from the DISPATCH lines of the config file. Depends only on the
+ * simulation time, so runs are reproducible.
+ *
+ * Calls to \ref AddWindow function to add a time window.
+ * Calls to \ref GetWindows function to get the windows, by start time.
+ */
+class DispatchPlan {
+ public:
+  /**
+   * @brief Add a window, it lasts until the next window starts.
+   *
+   * @param[in] start_time Simulation time step the window starts at
+   * @param[in] strategy Bus depot strategy used during the window
+   */
+  void AddWindow(int start_time, int strategy);
+  const std::vector<DispatchWindow>& GetWindows() const { return windows_; }
+
+  // Used before the first window, and when there is none
+  static const int kDefaultStrategy = 4;
+
+ private:
+  std::vector<DispatchWindow> windows_;  // sorted by start time
+};
+
+/**
+ * @brief Position of a running simulation in a DispatchPlan.
+ *
+ * Simulation time only moves forward, so resolving the current window is a
+ * cursor step instead of a search.
+ *
+ * Calls to \ref Advance function once per time step.
+ * Calls to \ref GetStrategy function to get the current strategy.
+ */
+class DispatchCursor {
+ public:
+  explicit DispatchCursor(const DispatchPlan * plan = nullptr) :
+    plan_(plan), next_(0), strategy_(DispatchPlan::kDefaultStrategy) {}
+  /**
+   * @brief Move to the window the given time falls in.
+   *
+   * @param[in] time Simulation time step, never less than the last one
+   * @return true if the strategy changed.
+   */
+  bool Advance(int time);
+  int GetStrategy() const { return strategy_; }
+
+ private:
+  const DispatchPlan * plan_;
+  int next_;  // index of the next window to start
+  int strategy_;
+};
+
+#endif  // SRC_DISPATCH_PLAN_H_
@@ -0,0 +1,74 @@
+/**
+ * @file entity_registry.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_ENTITY_REGISTRY_H_
+#define SRC_ENTITY_REGISTRY_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Maps interned entity ids to the live entity with that id.
+ *
+ * Ids handed out by NameTable are dense, so the registry is a plain vector
+ * indexed by id and every operation is O(1). The entities are not owned.
+ *
+ * Calls to \ref Add function when an entity is spawned.
+ * Calls to \ref Remove function when it is retired.
+ * Calls to \ref Find function to get the entity of an id.
+ */
+template <typename T>
+class EntityRegistry {
+ public:
+  /**
+   * @brief Register an entity, the first one added for an id is kept.
+   *
+   * @param[in] id Interned id, see NameTable
+   * @param[in] entity Entity to register
+   */
+  void Add(int id, T * entity) {
+    if (id < 0) return;
+    if (id >= static_cast<int>(entities_.size())) {
+      entities_.resize(id + 1, NULL);
+    }
+    if (!entities_[id]) {
+      entities_[id] = entity;
+      size_++;
+    }
+  }
+  /**
+   * @brief Unregister the entity of an id, if any.
+   */
+  void Remove(int id) {
+    if (Find(id)) {
+      entities_[id] = NULL;
+      size_--;
+    }
+  }
+  /**
+   * @brief Get the entity of an id, or NULL.
+   */
+  T * Find(int id) const {
+    if (id < 0 || id >= static_cast<int>(entities_.size())) return NULL;
+    return entities_[id];
+  }
+  void Clear() {
+    entities_.clear();
+    size_ = 0;
+  }
+  int Size() const { return size_; }
+
+ private:
+  std::vector<T *> entities_;
+  int size_ = 0;
+};
+
+#endif  // SRC_ENTITY_REGISTRY_H_
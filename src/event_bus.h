@@ -0,0 +1,192 @@
+/**
+ * @file event_bus.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_EVENT_BUS_H_
+#define SRC_EVENT_BUS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <vector>
+
+#include "src/data_structs.h"
+
+/*******************************************************************************
+ * Events
+ ******************************************************************************/
+// A bus moved, or its passengers or color changed during the tick
+struct BusMovedEvent {
+  explicit BusMovedEvent(const BusData& bus) : bus(bus) {}
+  const BusData& bus;
+};
+
+// The number of people waiting at a stop changed during the tick
+struct StopCountChangedEvent {
+  explicit StopCountChangedEvent(const StopData& stop) : stop(stop) {}
+  const StopData& stop;
+};
+
+// A passenger got off a bus at its destination, published under the stop id
+struct PassengerAlightedEvent {
+  PassengerAlightedEvent(int bus_id, int route_id, int stop_id,
+                         int wait_at_stop, int time_on_bus) :
+    bus_id(bus_id), route_id(route_id), stop_id(stop_id),
+    wait_at_stop(wait_at_stop), time_on_bus(time_on_bus),
+    total_wait(wait_at_stop + time_on_bus) {}
+  int bus_id;
+  int route_id;  // route the bus was on
+  int stop_id;
+  int wait_at_stop;
+  int time_on_bus;
+  int total_wait;  // time waiting at the stop plus time on the bus
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The subscribers of a single event type.
+ *
+ * Subscribers either watch every entity or a single one, each kind is kept
+ * in its own contiguous list. Handlers are plain function pointers bound
+ * at compile time by \ref EventBus::Subscribe, there is no virtual call.
+ */
+template <typename Event>
+class EventTopic {
+ public:
+  typedef void (*Handler)(void * subscriber, const Event& event);
+
+  /**
+   * @brief Whether anybody listens, check it before building an event.
+   */
+  bool HasSubscribers() const {
+    return !any_entity_.empty() || !by_entity_.empty();
+  }
+  /**
+   * @brief Whether anybody listens to the given entity.
+   */
+  bool HasSubscribers(int entity) const {
+    if (!any_entity_.empty()) return true;
+    return std::binary_search(by_entity_.begin(), by_entity_.end(),
+                              Subscription(entity, nullptr, nullptr));
+  }
+  /**
+   * @brief Add a subscriber.
+   *
+   * @param[in] entity Interned id of the entity to watch, or kAnyEntity
+   * @param[in] subscriber Passed back to the handler
+   * @param[in] handler Called for every matching event
+   */
+  void Add(int entity, void * subscriber, Handler handler) {
+    Subscription s(entity, subscriber, handler);
+    if (entity == kAnyEntity) {
+      any_entity_.push_back(s);
+    } else {
+      // Sorted by entity, so publishing only visits the matching range
+      by_entity_.insert(std::upper_bound(by_entity_.begin(), by_entity_.end(),
+                                         s), s);
+    }
+  }
+  /**
+   * @brief Remove every subscription of a subscriber to an entity.
+   */
+  void Remove(int entity, void * subscriber) {
+    std::vector<Subscription>& list =
+      entity == kAnyEntity ? any_entity_ : by_entity_;
+    for (int i = static_cast<int>(list.size()) - 1; i >= 0; i--) {
+      if (list[i].entity == entity && list[i].subscriber == subscriber) {
+        list.erase(list.begin() + i);
+      }
+    }
+  }
+  /**
+   * @brief Call the handlers watching every entity or this one.
+   */
+  void Publish(int entity, const Event& event) const {
+    for (int i = 0; i < static_cast<int>(any_entity_.size()); i++) {
+      any_entity_[i].handler(any_entity_[i].subscriber, event);
+    }
+    if (by_entity_.empty()) return;
+    typename std::vector<Subscription>::const_iterator it =
+      std::lower_bound(by_entity_.begin(), by_entity_.end(),
+                       Subscription(entity, nullptr, nullptr));
+    for (; it != by_entity_.end() && it->entity == entity; it++) {
+      it->handler(it->subscriber, event);
+    }
+  }
+
+  static const int kAnyEntity = -1;
+
+ private:
+  struct Subscription {
+    Subscription(int entity, void * subscriber, Handler handler) :
+      entity(entity), subscriber(subscriber), handler(handler) {}
+    bool operator<(const Subscription& other) const {
+      return entity < other.entity;
+    }
+    int entity;
+    void * subscriber;
+    Handler handler;
+  };
+  std::vector<Subscription> any_entity_;
+  std::vector<Subscription> by_entity_;
+};
+
+/**
+ * @brief Central, typed event bus of a simulation.
+ *
+ * Replaces the per-bus and per-stop observer lists. Each event type is a
+ * topic with its own subscriber lists, so a topic nobody subscribed to
+ * costs a single emptiness check, and publishers skip building its events.
+ *
+ * Calls to \ref Subscribe function to bind a member function to a topic.
+ * Calls to \ref Unsubscribe function to remove it.
+ * Calls to \ref Publish function to dispatch an event.
+ */
+class EventBus : private EventTopic<BusMovedEvent>,
+                 private EventTopic<StopCountChangedEvent>,
+                 private EventTopic<PassengerAlightedEvent> {
+ public:
+  static const int kAnyEntity = -1;
+
+  /**
+   * @brief Bind a member function of a subscriber to a topic.
+   *
+   * @param[in] subscriber Object the handler is called on
+   * @param[in] entity Interned id of the entity to watch, or kAnyEntity
+   */
+  template <typename Event, typename T, void (T::*Method)(const Event&)>
+  void Subscribe(T * subscriber, int entity = kAnyEntity) {
+    Topic<Event>().Add(entity, subscriber, &Dispatch<Event, T, Method>);
+  }
+  template <typename Event, typename T>
+  void Unsubscribe(T * subscriber, int entity = kAnyEntity) {
+    Topic<Event>().Remove(entity, subscriber);
+  }
+  template <typename Event>
+  bool HasSubscribers() const { return Topic<Event>().HasSubscribers(); }
+  template <typename Event>
+  bool HasSubscribers(int entity) const {
+    return Topic<Event>().HasSubscribers(entity);
+  }
+  template <typename Event>
+  void Publish(int entity, const Event& event) const {
+    Topic<Event>().Publish(entity, event);
+  }
+
+ private:
+  template <typename Event>
+  EventTopic<Event>& Topic() { return *this; }
+  template <typename Event>
+  const EventTopic<Event>& Topic() const { return *this; }
+
+  template <typename Event, typename T, void (T::*Method)(const Event&)>
+  static void Dispatch(void * subscriber, const Event& event) {
+    (static_cast<T *>(subscriber)->*Method)(event);
+  }
+};
+
+#endif  // SRC_EVENT_BUS_H_
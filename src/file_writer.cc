@@ -9,9 +9,8 @@
  * Member Functions
  ******************************************************************************/
 FileWriter::FileWriter() {
-  // Open the output file stream
-  bus_logfile.open("BusData.csv");
-  pass_logfile.open("PassData.csv");
+  // The output file streams are opened by Write, a run that logs nothing
+  // leaves the files of an earlier one alone
 }
 
 FileWriter::~FileWriter() {
@@ -22,13 +21,16 @@ FileWriter::~FileWriter() {
 
 void FileWriter::Write(std::string file_name,
   const std::vector<std::string>& data) {
+  std::lock_guard<std::mutex> lock(mutex_);
   // log the data into different files depending on the given file name
   if (file_name == "BusData.csv") {
+    if (!bus_logfile.is_open()) bus_logfile.open("BusData.csv");
     for (int i = static_cast<int>(data.size()) - 1; i >= 0; i--) {
       bus_logfile << data[i];
     }
     bus_logfile << std::endl << std::flush;
   } else if (file_name == "PassData.csv") {
+    if (!pass_logfile.is_open()) pass_logfile.open("PassData.csv");
     for (int i = static_cast<int>(data.size()) - 1; i >= 0; i--) {
       pass_logfile << data[i];
     }
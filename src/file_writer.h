@@ -11,6 +11,7 @@
  ******************************************************************************/
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,8 @@
  * @brief The main class for writing the output to a file in Singleton Pattern
  *
  * Calls to \ref Write function to write the output to files in csv format.
+ * Files are opened on their first write, and writes from several threads
+ * are serialized.
  */
 class FileWriter {
  public:  // public reporter
@@ -40,6 +43,7 @@ class FileWriter {
   // Stringstream for logging purpose
   std::ofstream bus_logfile;
   std::ofstream pass_logfile;
+  std::mutex mutex_;  // guards both files
 };
 
 #endif  // SRC_FILE_WRITER_H_
@@ -6,20 +6,12 @@
 #include "src/file_writer_manager.h"
 #include "src/file_writer.h"
 
-/*******************************************************************************
- * Static Variable Initialization
- ******************************************************************************/
-// Initialize pointer to zero so that it can be initialized
-// in first call to getInstance
-FileWriter * FileWriterManager::file_writer = 0;
-
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
 FileWriter * FileWriterManager::GetInstance() {
-  if (!file_writer) {
-    file_writer = new FileWriter();
-  }
-
+  // Initialized in the first call, a local static is initialized once even
+  // if simulations on several threads call it together
+  static FileWriter * file_writer = new FileWriter();
   return file_writer;
 }
@@ -25,14 +25,12 @@ class FileWriterManager {
  /**
   * @brief Instantiate an object for logging.
   * 
-  * This function will be used for logging in Singleton Pattern.
+  * This function will be used for logging in Singleton Pattern. Safe to
+  * call from several threads, the object is created once.
   *
   * @return FileWriter An object for writing purpose.
   */
   static FileWriter * GetInstance();
-
- private:  // private reporter
-  static FileWriter * file_writer;
 };
 
 #endif  // SRC_FILE_WRITER_MANAGER_H_
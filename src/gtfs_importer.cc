@@ -0,0 +1,298 @@
+/**
+ * @file gtfs_importer.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/gtfs_importer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "src/config_manager.h"
+#include "src/csv_reader.h"
+
+/*******************************************************************************
+ * Feed Records
+ ******************************************************************************/
+struct GtfsStop {
+  std::string id;
+  double latitude;
+  double longitude;
+};
+
+struct GtfsRoute {
+  std::string id;
+  std::string name;
+};
+
+struct GtfsTrip {
+  std::string id;
+  int route;
+  int direction;  // 0 outbound, 1 inbound
+  std::string headsign;
+};
+
+struct GtfsStopTime {
+  int slot;  // route * 2 + direction of the chosen trip
+  int sequence;
+  int stop;
+};
+
+static bool BySequence(const GtfsStopTime& a, const GtfsStopTime& b) {
+  return a.sequence < b.sequence;
+}
+
+static void OpenFeedFile(CsvReader * file, const std::string& path) {
+  if (!file->Open(path)) {
+    throw ConfigError(path, 0, "cannot open the file");
+  }
+}
+
+static int RequireColumn(const CsvReader& file, const std::string& name) {
+  int column = file.GetColumn(name);
+  if (column < 0) {
+    throw ConfigError(file.GetPath(), 1, "missing column " + name);
+  }
+  return column;
+}
+
+// Look a key up in a map of ids, the key string is reused between rows
+static int FindId(const std::unordered_map<std::string, int>& ids,
+                  const CsvField& field, std::string * key,
+                  const char * what) {
+  field.CopyTo(key);
+  std::unordered_map<std::string, int>::const_iterator it = ids.find(*key);
+  if (it == ids.end()) {
+    throw std::runtime_error(std::string("unknown ") + what + " " + *key);
+  }
+  return it->second;
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+GtfsImporter::GtfsImporter(int numThreads) : numThreads_(numThreads) {
+  if (numThreads_ <= 0) {
+    numThreads_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+}
+
+void GtfsImporter::Import(const std::string& directory,
+                          const std::string& demandPath,
+                          NetworkTables * tables) {
+  // Stops, parsed in chunks and merged in file order
+  CsvReader stopsFile;
+  OpenFeedFile(&stopsFile, directory + "/stops.txt");
+  int stopIdColumn = RequireColumn(stopsFile, "stop_id");
+  int latColumn = RequireColumn(stopsFile, "stop_lat");
+  int lonColumn = RequireColumn(stopsFile, "stop_lon");
+  std::vector<std::vector<GtfsStop> > stopChunks(numThreads_);
+  stopsFile.ForEachRow(numThreads_, [&](int chunk, const CsvRow& row) {
+    // Entrances and generic nodes may have no position, no bus stops there
+    if (row[latColumn].IsEmpty() && row[lonColumn].IsEmpty()) return;
+    GtfsStop stop;
+    stop.id = row[stopIdColumn].ToString();
+    if (!row[latColumn].ToDouble(&stop.latitude)) {
+      throw std::runtime_error("bad stop_lat");
+    }
+    if (!row[lonColumn].ToDouble(&stop.longitude)) {
+      throw std::runtime_error("bad stop_lon");
+    }
+    stopChunks[chunk].push_back(stop);
+  });
+  std::vector<GtfsStop> stops;
+  std::unordered_map<std::string, int> stopIds;
+  for (int i = 0; i < numThreads_; i++) {
+    for (int j = 0; j < static_cast<int>(stopChunks[i].size()); j++) {
+      if (stopIds.emplace(stopChunks[i][j].id,
+                          static_cast<int>(stops.size())).second) {
+        stops.push_back(stopChunks[i][j]);
+      }
+    }
+    std::vector<GtfsStop>().swap(stopChunks[i]);
+  }
+
+  // Routes, a short file read in order
+  CsvReader routesFile;
+  OpenFeedFile(&routesFile, directory + "/routes.txt");
+  int routeIdColumn = RequireColumn(routesFile, "route_id");
+  int shortNameColumn = routesFile.GetColumn("route_short_name");
+  int longNameColumn = routesFile.GetColumn("route_long_name");
+  std::vector<GtfsRoute> routes;
+  std::unordered_map<std::string, int> routeIds;
+  routesFile.ForEachRow(1, [&](int, const CsvRow& row) {
+    GtfsRoute route;
+    route.id = row[routeIdColumn].ToString();
+    route.name = row[shortNameColumn].ToString();
+    if (route.name.empty()) route.name = row[longNameColumn].ToString();
+    if (route.name.empty()) route.name = route.id;
+    if (routeIds.emplace(route.id, static_cast<int>(routes.size())).second) {
+      routes.push_back(route);
+    }
+  });
+
+  // Trips
+  CsvReader tripsFile;
+  OpenFeedFile(&tripsFile, directory + "/trips.txt");
+  int tripIdColumn = RequireColumn(tripsFile, "trip_id");
+  int tripRouteColumn = RequireColumn(tripsFile, "route_id");
+  int directionColumn = tripsFile.GetColumn("direction_id");
+  int headsignColumn = tripsFile.GetColumn("trip_headsign");
+  std::vector<std::vector<GtfsTrip> > tripChunks(numThreads_);
+  std::vector<std::string> keys(numThreads_);
+  tripsFile.ForEachRow(numThreads_, [&](int chunk, const CsvRow& row) {
+    GtfsTrip trip;
+    trip.id = row[tripIdColumn].ToString();
+    trip.route = FindId(routeIds, row[tripRouteColumn], &keys[chunk],
+                        "route_id");
+    trip.direction = 0;
+    if (!row[directionColumn].IsEmpty() &&
+        (!row[directionColumn].ToInt(&trip.direction)
+         || trip.direction < 0 || trip.direction > 1)) {
+      throw std::runtime_error("bad direction_id");
+    }
+    trip.headsign = row[headsignColumn].ToString();
+    tripChunks[chunk].push_back(trip);
+  });
+  std::vector<GtfsTrip> trips;
+  std::unordered_map<std::string, int> tripIds;
+  for (int i = 0; i < numThreads_; i++) {
+    for (int j = 0; j < static_cast<int>(tripChunks[i].size()); j++) {
+      if (tripIds.emplace(tripChunks[i][j].id,
+                          static_cast<int>(trips.size())).second) {
+        trips.push_back(tripChunks[i][j]);
+      }
+    }
+    std::vector<GtfsTrip>().swap(tripChunks[i]);
+  }
+
+  // First pass over the schedule, count the stops of every trip
+  CsvReader stopTimesFile;
+  OpenFeedFile(&stopTimesFile, directory + "/stop_times.txt");
+  int timeTripColumn = RequireColumn(stopTimesFile, "trip_id");
+  int timeStopColumn = RequireColumn(stopTimesFile, "stop_id");
+  int sequenceColumn = RequireColumn(stopTimesFile, "stop_sequence");
+  std::vector<std::vector<int> > countChunks(numThreads_);
+  stopTimesFile.ForEachRow(numThreads_, [&](int chunk, const CsvRow& row) {
+    std::vector<int>& counts = countChunks[chunk];
+    if (counts.empty()) counts.resize(trips.size(), 0);
+    counts[FindId(tripIds, row[timeTripColumn], &keys[chunk], "trip_id")]++;
+  });
+  std::vector<int> counts(trips.size(), 0);
+  for (int i = 0; i < numThreads_; i++) {
+    for (int j = 0; j < static_cast<int>(countChunks[i].size()); j++) {
+      counts[j] += countChunks[i][j];
+    }
+  }
+
+  // Every direction of a route follows its longest trip
+  std::vector<int> chosen(routes.size() * 2, -1);
+  for (int i = 0; i < static_cast<int>(trips.size()); i++) {
+    int& best = chosen[trips[i].route * 2 + trips[i].direction];
+    if (counts[i] > 0 && (best < 0 || counts[i] > counts[best])) {
+      best = i;
+    }
+  }
+  std::vector<int> tripSlots(trips.size(), -1);
+  for (int i = 0; i < static_cast<int>(chosen.size()); i++) {
+    if (chosen[i] >= 0) tripSlots[chosen[i]] = i;
+  }
+
+  // Second pass, keep the stops of the chosen trips only
+  std::vector<std::vector<GtfsStopTime> > timeChunks(numThreads_);
+  stopTimesFile.ForEachRow(numThreads_, [&](int chunk, const CsvRow& row) {
+    int trip = FindId(tripIds, row[timeTripColumn], &keys[chunk], "trip_id");
+    if (tripSlots[trip] < 0) return;
+    GtfsStopTime stopTime;
+    stopTime.slot = tripSlots[trip];
+    if (!row[sequenceColumn].ToInt(&stopTime.sequence)) {
+      throw std::runtime_error("bad stop_sequence");
+    }
+    stopTime.stop = FindId(stopIds, row[timeStopColumn], &keys[chunk],
+                           "stop_id");
+    timeChunks[chunk].push_back(stopTime);
+  });
+  std::vector<std::vector<GtfsStopTime> > slotStops(chosen.size());
+  for (int i = 0; i < numThreads_; i++) {
+    for (int j = 0; j < static_cast<int>(timeChunks[i].size()); j++) {
+      slotStops[timeChunks[i][j].slot].push_back(timeChunks[i][j]);
+    }
+  }
+  for (int i = 0; i < static_cast<int>(slotStops.size()); i++) {
+    std::stable_sort(slotStops[i].begin(), slotStops[i].end(), BySequence);
+  }
+
+  // Demand, as a generation probability: the generator tries again with
+  // p squared, cubed and so on, so it adds p / (1 - p) passengers a step
+  std::vector<double> probabilities(stops.size(), 0);
+  CsvReader demandFile;
+  OpenFeedFile(&demandFile, demandPath);
+  int demandStopColumn = RequireColumn(demandFile, "stop_id");
+  int demandColumn = RequireColumn(demandFile, "demand");
+  demandFile.ForEachRow(1, [&](int chunk, const CsvRow& row) {
+    int stop = FindId(stopIds, row[demandStopColumn], &keys[chunk],
+                      "stop_id");
+    double demand;
+    if (!row[demandColumn].ToDouble(&demand) || demand < 0) {
+      throw std::runtime_error("bad demand");
+    }
+    probabilities[stop] = demand / (1 + demand);
+  });
+
+  // Outbound and inbound route of every GTFS route, with stops of their own
+  *tables = NetworkTables();
+  int stopId = 10;
+  for (int i = 0; i < static_cast<int>(routes.size()); i++) {
+    if (slotStops[2 * i].empty() && slotStops[2 * i + 1].empty()) continue;
+    for (int direction = 0; direction < 2; direction++) {
+      std::vector<int> routeStops;
+      std::string headsign;
+      if (!slotStops[2 * i + direction].empty()) {
+        const std::vector<GtfsStopTime>& times = slotStops[2 * i + direction];
+        for (int j = 0; j < static_cast<int>(times.size()); j++) {
+          routeStops.push_back(times[j].stop);
+        }
+        headsign = trips[chosen[2 * i + direction]].headsign;
+      } else {
+        // Only one direction in the feed, come back the same way
+        const std::vector<GtfsStopTime>& times =
+          slotStops[2 * i + 1 - direction];
+        for (int j = static_cast<int>(times.size()) - 1; j >= 0; j--) {
+          routeStops.push_back(times[j].stop);
+        }
+      }
+      headsign.erase(std::remove(headsign.begin(), headsign.end(), ' '),
+                     headsign.end());
+      if (headsign.empty()) headsign = direction == 0 ? "Outbound" : "Inbound";
+      std::string name = routes[i].name + " " + headsign;
+
+      NetworkRouteRecord record;
+      record.name_offset = static_cast<uint32_t>(tables->names.size());
+      record.name_length = static_cast<uint32_t>(name.size());
+      record.first_stop = static_cast<uint32_t>(tables->route_stops.size());
+      record.num_stops = static_cast<uint32_t>(routeStops.size());
+      tables->routes.push_back(record);
+      tables->names += name;
+
+      for (int j = 0; j < static_cast<int>(routeStops.size()); j++) {
+        const GtfsStop& stop = stops[routeStops[j]];
+        NetworkStopRecord stopRecord;
+        stopRecord.id = stopId++;
+        stopRecord.reserved = 0;
+        stopRecord.latitude = stop.latitude;
+        stopRecord.longitude = stop.longitude;
+        tables->route_stops.push_back(
+          static_cast<uint32_t>(tables->stops.size()));
+        tables->stops.push_back(stopRecord);
+        tables->probabilities.push_back(probabilities[routeStops[j]]);
+      }
+    }
+  }
+  tables->MeasureSegments();
+}
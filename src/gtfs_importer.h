@@ -0,0 +1,60 @@
+/**
+ * @file gtfs_importer.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_GTFS_IMPORTER_H_
+#define SRC_GTFS_IMPORTER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+
+#include "src/network_image.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Builds a network from a GTFS feed directory.
+ *
+ * Every GTFS route becomes an outbound and an inbound Route, like a ROUTE
+ * pair of config.txt. Each direction follows the trip of that direction
+ * with the most stops, and a route with a single direction runs it
+ * backwards on the way in. Like config.txt, routes do not share stops.
+ *
+ * The demand file is a CSV with stop_id and demand columns, demand being
+ * the mean number of passengers showing up at the stop per time step.
+ * Stops it does not list get no passengers.
+ *
+ * The files are memory-mapped and parsed in parallel chunks, see
+ * CsvReader. stop_times.txt is streamed twice, once to count the stops of
+ * every trip and once to keep the stops of the chosen trips only, so the
+ * schedule is never held in memory.
+ *
+ * Calls to \ref Import function to read a feed.
+ */
+class GtfsImporter {
+ public:
+ /**
+  * @param[in] numThreads Parser threads, 0 for one per core
+  */
+  explicit GtfsImporter(int numThreads = 0);
+ /**
+  * @brief Read stops.txt, routes.txt, trips.txt and stop_times.txt.
+  *
+  * Throws ConfigError with the file and line of a malformed row.
+  *
+  * @param[in] directory GTFS feed directory
+  * @param[in] demandPath Demand file
+  * @param[out] tables Network of the feed
+  */
+  void Import(const std::string& directory, const std::string& demandPath,
+              NetworkTables * tables);
+
+ private:
+  int numThreads_;
+};
+
+#endif  // SRC_GTFS_IMPORTER_H_
@@ -11,35 +11,45 @@
  ******************************************************************************/
 #include <iostream>
 
-#include "src/iobservable.h"
 #include "src/data_structs.h"
 
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
 /**
- * @brief The abstract interface for Decorator Pattern.
- * 
+ * @brief The static interface for Decorator Pattern.
+ *
+ * Concrete components and decorators derive from IBus<Self>. Calls through
+ * the interface are resolved at compile time, there is no virtual call and
+ * decorators can live on the stack.
  */
-class IBus : public IObservable<BusData *> {
+template <typename Derived>
+class IBus {
  public:
-  virtual ~IBus() { }
   /**
   * @brief Different implementation for decorator and concrete component,
   * the implementation for decorator will change the color or intensity.
   *
   */
-  virtual void UpdateBusData() = 0;
+  void UpdateBusData() { Self()->UpdateBusData(); }
   /**
   * @brief Change the bus color.
   *
   */
-  virtual void SetColor(int red, int green, int blue) = 0;
+  void SetColor(int red, int green, int blue) {
+    Self()->SetColor(red, green, blue);
+  }
   /**
   * @brief Change the bus color intensity.
   *
   */
-  virtual void SetIntensity(int alpha) = 0;
+  void SetIntensity(int alpha) { Self()->SetIntensity(alpha); }
+
+ protected:
+  ~IBus() { }
+
+ private:
+  Derived * Self() { return static_cast<Derived *>(this); }
 };
 
 #endif  // SRC_IBUS_H_
@@ -0,0 +1,90 @@
+/**
+ * @file latency_histogram.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const int LatencyHistogram::kMaxValue;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+int LatencyHistogram::BucketOf(int value) {
+  if (value < (1 << kExactBits)) {
+    return value;
+  }
+  int top = kExactBits;  // highest set bit of value
+  while ((value >> (top + 1)) != 0) {
+    top++;
+  }
+  int shift = top - kSubBits;
+  return (1 << kExactBits) + (top - kExactBits) * (1 << kSubBits)
+         + ((value >> shift) - (1 << kSubBits));
+}
+
+int LatencyHistogram::HighestOf(int bucket) {
+  if (bucket < (1 << kExactBits)) {
+    return bucket;
+  }
+  int index = bucket - (1 << kExactBits);
+  int top = kExactBits + index / (1 << kSubBits);
+  int shift = top - kSubBits;
+  int sub = (1 << kSubBits) + index % (1 << kSubBits);
+  return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int value) {
+  value = std::min(std::max(value, 0), kMaxValue);
+  counts_[BucketOf(value)]++;
+  count_++;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (int i = 0; i < kNumBuckets; i++) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Clear() {
+  std::fill(counts_, counts_ + kNumBuckets, 0);
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+double LatencyHistogram::GetMean() const {
+  return count_ > 0 ? static_cast<double>(sum_) / count_ : 0;
+}
+
+int LatencyHistogram::GetPercentile(double percent) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percent = std::min(std::max(percent, 0.0), 100.0);
+  // Rank of the duration, the first one for percentile 0
+  int64_t rank = std::max<int64_t>(
+    1, static_cast<int64_t>(std::ceil(percent / 100 * count_)));
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::min(HighestOf(i), max_);
+    }
+  }
+  return max_;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file latency_histogram.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_LATENCY_HISTOGRAM_H_
+#define SRC_LATENCY_HISTOGRAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Counts of durations in time steps, in constant memory.
+ *
+ * Buckets are laid out like an HDR histogram: durations below 32 have a
+ * bucket each, every power of two above is split in 16 buckets, so a
+ * percentile is within 1/16 of the duration it stands for. Durations past
+ * kMaxValue count as kMaxValue. Count, mean and largest are exact.
+ *
+ * Calls to \ref Record function to count a duration.
+ * Calls to \ref Merge function to add the counts of another histogram.
+ * Calls to \ref GetPercentile function for a percentile.
+ */
+class LatencyHistogram {
+ public:
+  static const int kMaxValue = (1 << 20) - 1;
+
+  LatencyHistogram() { Clear(); }
+  void Record(int value);
+  void Merge(const LatencyHistogram& other);
+  void Clear();
+  int64_t GetCount() const { return count_; }
+  double GetMean() const;
+  int GetMax() const { return max_; }
+ /**
+  * @brief Smallest duration that percent of the counts are not above.
+  *
+  * @param[in] percent Between 0 and 100
+  * @return The largest duration of its bucket, at most GetMax, 0 if
+  * nothing was recorded.
+  */
+  int GetPercentile(double percent) const;
+
+ private:
+  static const int kExactBits = 5;  // durations below 2^5 are exact
+  static const int kSubBits = 4;  // 2^4 buckets per power of two above
+  static const int kNumBuckets =
+    (1 << kExactBits) + (20 - kExactBits) * (1 << kSubBits);
+  static int BucketOf(int value);
+  // Largest duration counted in a bucket
+  static int HighestOf(int bucket);
+  uint32_t counts_[kNumBuckets];
+  int64_t count_;
+  int64_t sum_;
+  int max_;
+};
+
+#endif  // SRC_LATENCY_HISTOGRAM_H_
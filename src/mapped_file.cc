@@ -0,0 +1,53 @@
+/**
+ * @file mapped_file.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool MappedFile::Open(const std::string& path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return false;
+  }
+
+  // An empty file cannot be mapped, but it is a valid file
+  if (info.st_size > 0) {
+    void * data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    data_ = static_cast<const char *>(data);
+    size_ = info.st_size;
+  }
+  // The mapping stays valid once the descriptor is closed
+  close(fd);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+  data_ = NULL;
+  size_ = 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file mapped_file.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_MAPPED_FILE_H_
+#define SRC_MAPPED_FILE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <string>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Lets loaders walk a large file in place, without reading it through a
+ * stream or copying it. The mapping is released with the object.
+ *
+ * Calls to \ref Open function to map a file.
+ * Calls to \ref GetData and \ref GetSize function to access its bytes.
+ */
+class MappedFile {
+ public:
+  MappedFile() : data_(NULL), size_(0) {}
+  ~MappedFile() { Close(); }
+ /**
+  * @brief Map a file, replacing the current mapping.
+  *
+  * @param[in] path Path of the file
+  * @return false if the file cannot be opened or mapped.
+  */
+  bool Open(const std::string& path);
+  void Close();
+  // Contents of the file, not NUL terminated, NULL for an empty file
+  const char * GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+ private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  const char * data_;
+  size_t size_;
+};
+
+#endif  // SRC_MAPPED_FILE_H_
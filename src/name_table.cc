@@ -0,0 +1,50 @@
+/**
+ * @file name_table.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include "src/name_table.h"
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const int NameTable::kNoId;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+int NameTable::Intern(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Names are interned once, on entity creation
+  std::unordered_map<std::string, int>::iterator it = ids_.find(name);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  int id = static_cast<int>(names_.size());
+  names_.push_back(name);
+  ids_[name] = id;
+  return id;
+}
+
+int NameTable::Find(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<std::string, int>::const_iterator it = ids_.find(name);
+  if (it == ids_.end()) {
+    return kNoId;
+  }
+  return it->second;
+}
+
+const std::string& NameTable::GetName(int id) const {
+  static const std::string empty_name = "";
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (id < 0 || id >= static_cast<int>(names_.size())) {
+    return empty_name;
+  }
+  return names_[id];
+}
+
+NameTable * NameTable::GetDefault() {
+  static NameTable names;
+  return &names;
+}
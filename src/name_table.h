@@ -0,0 +1,77 @@
+/**
+ * @file name_table.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_NAME_TABLE_H_
+#define SRC_NAME_TABLE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Table of the interned entity names of one network.
+ *
+ * Buses, stops and routes are identified by dense integer ids inside the
+ * simulation. Their names are only needed when serializing or displaying
+ * data, so they live here once instead of in every snapshot struct.
+ *
+ * A network owns its table, see ConfigManager::GetNames, so simulations on
+ * several threads neither share ids nor contend on a lock. The lock of a
+ * table is only shared by the threads of its own simulation.
+ *
+ * Calls to \ref Intern function to get the id of a name.
+ * Calls to \ref Find function to look up the id of a name from the client.
+ * Calls to \ref GetName function to get the name back for display.
+ */
+class NameTable {
+ public:
+  NameTable() {}
+ /**
+  * @brief Get the id of a name, adding the name if it is new.
+  *
+  * @param[in] name Entity name
+  * @return Dense integer id of the name.
+  */
+  int Intern(const std::string& name);
+ /**
+  * @brief Look up the id of a name without adding it.
+  *
+  * @param[in] name Entity name
+  * @return Id of the name, or kNoId if the name was never interned.
+  */
+  int Find(const std::string& name) const;
+ /**
+  * @brief Get the name of an id.
+  *
+  * @param[in] id Id returned by \ref Intern
+  * @return The interned name, or an empty string for an unknown id.
+  */
+  const std::string& GetName(int id) const;
+ /**
+  * @brief Table of the entities built without one.
+  *
+  * Shared by all of them, only for the tests and the drivers.
+  */
+  static NameTable * GetDefault();
+
+  static const int kNoId = -1;
+
+ private:
+  NameTable(const NameTable&) = delete;
+  NameTable& operator=(const NameTable&) = delete;
+  // deque keeps references to the names valid as the table grows
+  std::deque<std::string> names_;
+  std::unordered_map<std::string, int> ids_;
+  mutable std::mutex mutex_;
+};
+
+#endif  // SRC_NAME_TABLE_H_
@@ -0,0 +1,230 @@
+/**
+ * @file network_image.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/network_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "src/util.h"
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const uint32_t NetworkImage::kVersion;
+
+static const char kMagic[8] = {'B', 'U', 'S', 'N', 'E', 'T', '\0', '\0'};
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+// Bytes after the header, in section order
+static uint64_t BodySize(const NetworkHeader& header) {
+  return static_cast<uint64_t>(header.num_stops) * sizeof(NetworkStopRecord)
+       + static_cast<uint64_t>(header.num_route_stops) * sizeof(double) * 3
+       + static_cast<uint64_t>(header.num_routes) * sizeof(NetworkRouteRecord)
+       + static_cast<uint64_t>(header.num_windows) *
+           sizeof(NetworkWindowRecord)
+       + static_cast<uint64_t>(header.num_route_stops) * sizeof(uint32_t)
+       + header.names_size;
+}
+
+bool NetworkImage::Write(const std::string& path, const NetworkTables& tables,
+                         std::string * error) {
+  NetworkHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_stops = static_cast<uint32_t>(tables.stops.size());
+  header.num_routes = static_cast<uint32_t>(tables.routes.size());
+  header.num_route_stops = static_cast<uint32_t>(tables.route_stops.size());
+  header.num_windows = static_cast<uint32_t>(tables.windows.size());
+  header.names_size = static_cast<uint32_t>(tables.names.size());
+
+  // Sections in image order
+  const void * data[] = {
+    tables.stops.data(), tables.distances.data(), tables.bearings.data(),
+    tables.probabilities.data(), tables.routes.data(),
+    tables.windows.data(), tables.route_stops.data(), tables.names.data()
+  };
+  const uint64_t sizes[] = {
+    tables.stops.size() * sizeof(NetworkStopRecord),
+    tables.distances.size() * sizeof(double),
+    tables.bearings.size() * sizeof(double),
+    tables.probabilities.size() * sizeof(double),
+    tables.routes.size() * sizeof(NetworkRouteRecord),
+    tables.windows.size() * sizeof(NetworkWindowRecord),
+    tables.route_stops.size() * sizeof(uint32_t),
+    tables.names.size()
+  };
+  const int numSections = sizeof(sizes) / sizeof(sizes[0]);
+
+  // FNV-1a, continued over every section in turn
+  header.checksum = Util::kChecksumSeed;
+  for (int i = 0; i < numSections; i++) {
+    header.checksum = Util::Checksum(header.checksum, data[i], sizes[i]);
+  }
+
+  // Written aside and renamed over the image, so a process mapping the old
+  // one keeps it whole and a failed write leaves it as it was
+  std::string partial = path + ".partial";
+  std::ofstream out(partial.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (int i = 0; i < numSections; i++) {
+    out.write(static_cast<const char *>(data[i]), sizes[i]);
+  }
+  out.close();
+  if (!out) {
+    std::remove(partial.c_str());
+    *error = "cannot write the image";
+    return false;
+  }
+  if (std::rename(partial.c_str(), path.c_str()) != 0) {
+    std::remove(partial.c_str());
+    *error = "cannot replace the image";
+    return false;
+  }
+  return true;
+}
+
+NetworkView NetworkTables::GetView() const {
+  NetworkView view;
+  view.stops = stops.data();
+  view.num_stops = static_cast<uint32_t>(stops.size());
+  view.distances = distances.data();
+  view.bearings = bearings.data();
+  view.probabilities = probabilities.data();
+  view.route_stops = route_stops.data();
+  view.num_route_stops = static_cast<uint32_t>(route_stops.size());
+  view.routes = routes.data();
+  view.num_routes = static_cast<uint32_t>(routes.size());
+  view.windows = windows.data();
+  view.num_windows = static_cast<uint32_t>(windows.size());
+  view.names = names.data();
+  return view;
+}
+
+void NetworkTables::Assign(const NetworkView& view) {
+  stops.assign(view.stops, view.stops + view.num_stops);
+  distances.assign(view.distances, view.distances + view.num_route_stops);
+  bearings.assign(view.bearings, view.bearings + view.num_route_stops);
+  probabilities.assign(view.probabilities,
+                       view.probabilities + view.num_route_stops);
+  routes.assign(view.routes, view.routes + view.num_routes);
+  windows.assign(view.windows, view.windows + view.num_windows);
+  route_stops.assign(view.route_stops,
+                     view.route_stops + view.num_route_stops);
+  // Names are not terminated, they end with the last route name
+  size_t namesSize = 0;
+  for (uint32_t i = 0; i < view.num_routes; i++) {
+    namesSize = std::max<size_t>(namesSize, view.routes[i].name_offset
+                                            + view.routes[i].name_length);
+  }
+  names.assign(view.names, namesSize);
+}
+
+void NetworkTables::MeasureSegments() {
+  // All routes are measured as one polyline, then the segments that would
+  // join the end of a route to the start of the next are dropped
+  std::vector<double> latitudes(route_stops.size());
+  std::vector<double> longitudes(route_stops.size());
+  for (size_t i = 0; i < route_stops.size(); i++) {
+    latitudes[i] = stops[route_stops[i]].latitude;
+    longitudes[i] = stops[route_stops[i]].longitude;
+  }
+  distances.resize(route_stops.size());
+  bearings.resize(route_stops.size());
+  Util::MeasureSegments(latitudes.data(), longitudes.data(),
+                        static_cast<int>(route_stops.size()),
+                        distances.data(), bearings.data());
+  for (size_t i = 0; i < routes.size(); i++) {
+    distances[routes[i].first_stop] = 0;
+    bearings[routes[i].first_stop] = 0;
+  }
+}
+
+bool NetworkImage::Open(const std::string& path, std::string * error) {
+  std::memset(&view_, 0, sizeof(view_));
+  if (!file_.Open(path)) {
+    *error = "cannot open the image";
+    return false;
+  }
+  if (file_.GetSize() < sizeof(NetworkHeader)) {
+    *error = "truncated image";
+    return false;
+  }
+  const char * data = file_.GetData();
+  const NetworkHeader * header =
+    reinterpret_cast<const NetworkHeader *>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    *error = "not a network image";
+    return false;
+  }
+  if (header->version != kVersion) {
+    *error = "image version " + std::to_string(header->version)
+           + ", expected " + std::to_string(kVersion);
+    return false;
+  }
+  uint64_t bodySize = BodySize(*header);
+  if (file_.GetSize() != sizeof(NetworkHeader) + bodySize) {
+    *error = "truncated image";
+    return false;
+  }
+  if (Util::Checksum(Util::kChecksumSeed, data + sizeof(NetworkHeader),
+                     bodySize)
+      != header->checksum) {
+    *error = "checksum mismatch";
+    return false;
+  }
+
+  // The mapping is page aligned and the sections keep their alignment
+  NetworkView view;
+  const char * section = data + sizeof(NetworkHeader);
+  view.stops = reinterpret_cast<const NetworkStopRecord *>(section);
+  view.num_stops = header->num_stops;
+  section += header->num_stops * sizeof(NetworkStopRecord);
+  view.distances = reinterpret_cast<const double *>(section);
+  section += header->num_route_stops * sizeof(double);
+  view.bearings = reinterpret_cast<const double *>(section);
+  section += header->num_route_stops * sizeof(double);
+  view.probabilities = reinterpret_cast<const double *>(section);
+  section += header->num_route_stops * sizeof(double);
+  view.routes = reinterpret_cast<const NetworkRouteRecord *>(section);
+  view.num_routes = header->num_routes;
+  section += header->num_routes * sizeof(NetworkRouteRecord);
+  view.windows = reinterpret_cast<const NetworkWindowRecord *>(section);
+  view.num_windows = header->num_windows;
+  section += header->num_windows * sizeof(NetworkWindowRecord);
+  view.route_stops = reinterpret_cast<const uint32_t *>(section);
+  view.num_route_stops = header->num_route_stops;
+  section += header->num_route_stops * sizeof(uint32_t);
+  view.names = section;
+
+  // A valid checksum does not make the indices safe to follow
+  for (uint32_t i = 0; i < view.num_routes; i++) {
+    const NetworkRouteRecord& route = view.routes[i];
+    if (route.num_stops == 0
+        || route.first_stop > view.num_route_stops
+        || route.num_stops > view.num_route_stops - route.first_stop
+        || route.name_offset > header->names_size
+        || route.name_length > header->names_size - route.name_offset) {
+      *error = "route " + std::to_string(i) + " out of range";
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < view.num_route_stops; i++) {
+    if (view.route_stops[i] >= view.num_stops) {
+      *error = "route stop " + std::to_string(i) + " out of range";
+      return false;
+    }
+  }
+  view_ = view;
+  return true;
+}
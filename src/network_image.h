@@ -0,0 +1,141 @@
+/**
+ * @file network_image.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_NETWORK_IMAGE_H_
+#define SRC_NETWORK_IMAGE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "src/mapped_file.h"
+
+/*******************************************************************************
+ * Image Records
+ ******************************************************************************/
+// Plain data laid out as on disk, so a mapped image is read in place.
+// Sections follow the header in this order: stops, distances, bearings,
+// probabilities, routes, dispatch windows, route stops, names. Every
+// section size is a multiple of 8 bytes but the last two.
+struct NetworkHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t checksum;  // FNV-1a of everything after the header
+  uint32_t num_stops;
+  uint32_t num_routes;
+  uint32_t num_route_stops;  // entries of the per route stop tables
+  uint32_t num_windows;
+  uint32_t names_size;
+  uint32_t reserved;
+};
+
+struct NetworkStopRecord {
+  int32_t id;
+  int32_t reserved;
+  double latitude;
+  double longitude;
+};
+
+// The stops of a route are entries [first_stop, first_stop + num_stops) of
+// the route stop, distance, bearing and probability tables
+struct NetworkRouteRecord {
+  uint32_t name_offset;
+  uint32_t name_length;
+  uint32_t first_stop;
+  uint32_t num_stops;
+};
+
+struct NetworkWindowRecord {
+  int32_t start_time;
+  int32_t strategy;
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The sections of a network, read in place from an image or from
+ * NetworkTables.
+ */
+struct NetworkView {
+  const NetworkStopRecord * stops;
+  uint32_t num_stops;
+  const double * distances;
+  const double * bearings;
+  const double * probabilities;
+  const uint32_t * route_stops;
+  uint32_t num_route_stops;
+  const NetworkRouteRecord * routes;
+  uint32_t num_routes;
+  const NetworkWindowRecord * windows;
+  uint32_t num_windows;
+  const char * names;
+};
+
+/**
+ * @brief The tables of a compiled network, built while reading a config.
+ *
+ * Distances and bearings are per route stop, from the previous stop of
+ * the route, and 0 for the first one, so a route reads them straight from
+ * the tables.
+ */
+struct NetworkTables {
+  std::vector<NetworkStopRecord> stops;
+  std::vector<double> distances;
+  std::vector<double> bearings;
+  std::vector<double> probabilities;
+  std::vector<NetworkRouteRecord> routes;
+  std::vector<NetworkWindowRecord> windows;
+  std::vector<uint32_t> route_stops;  // index into stops
+  std::string names;
+
+  NetworkView GetView() const;
+  // Copies every section of a view, such as the one of a mapped image
+  void Assign(const NetworkView& view);
+  // Fills distances and bearings from the stop positions, for every route
+  // at once, see Util::MeasureSegments
+  void MeasureSegments();
+};
+
+/**
+ * @brief Versioned, checksummed binary image of a compiled network.
+ *
+ * Calls to \ref Write function to save the tables of a network.
+ * Calls to \ref Open function to map and validate an image.
+ * Calls to \ref GetView function to read its sections in place.
+ */
+class NetworkImage {
+ public:
+  static const uint32_t kVersion = 2;
+
+ /**
+  * @brief Save the tables of a network as an image.
+  *
+  * @param[in] path Image file, replaced once fully written
+  * @param[out] error Reason of a failure
+  * @return false if the file cannot be written.
+  */
+  static bool Write(const std::string& path, const NetworkTables& tables,
+                    std::string * error);
+ /**
+  * @brief Map an image and check its version, sizes, indices and checksum.
+  *
+  * @param[out] error Reason of a failure
+  * @return false if the image cannot be used.
+  */
+  bool Open(const std::string& path, std::string * error);
+
+  const NetworkView& GetView() const { return view_; }
+
+ private:
+  MappedFile file_;
+  NetworkView view_ = NetworkView();
+};
+
+#endif  // SRC_NETWORK_IMAGE_H_
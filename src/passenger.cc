@@ -7,7 +7,7 @@
 #include <string>
 #include "src/passenger.h"
 
-int Passenger::count_ = 0;
+std::atomic<int> Passenger::count_(0);
 
 // Passenger::Passenger(Stop * dest = NULL, std::string name = "Nobody") {
 Passenger::Passenger(int destination_stop_id, std::string name) {
@@ -15,8 +15,7 @@ Passenger::Passenger(int destination_stop_id, std::string name) {
   destination_stop_id_ = destination_stop_id;
   wait_at_stop_ = 0;
   time_on_bus_ = 0;
-  id_ = count_;
-  count_++;
+  id_ = count_++;
 }
 
 void Passenger::Update() {
@@ -54,3 +53,28 @@ void Passenger::Report(std::ostream& out) const {
   out << "\tWait at Stop: " << wait_at_stop_ << std::endl;
   out << "\tTime on bus: " << time_on_bus_ << std::endl;
 }
+
+void Passenger::Save(CheckpointWriter * out) const {
+  out->WriteString(name_);
+  out->WriteInt(destination_stop_id_);
+  out->WriteInt(wait_at_stop_);
+  out->WriteInt(time_on_bus_);
+  out->WriteInt(id_);
+}
+
+Passenger * Passenger::Load(CheckpointReader * in) {
+  std::string name = in->ReadString();
+  int destination = in->ReadInt();
+  int wait_at_stop = in->ReadInt();
+  int time_on_bus = in->ReadInt();
+  int id = in->ReadInt();
+  if (!in->IsOk()) {
+    return NULL;
+  }
+  // The caller restores count_ once every passenger is back
+  Passenger * passenger = new Passenger(destination, name);
+  passenger->wait_at_stop_ = wait_at_stop;
+  passenger->time_on_bus_ = time_on_bus;
+  passenger->id_ = id;
+  return passenger;
+}
@@ -9,9 +9,12 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <atomic>
 #include <iostream>
 #include <string>
 
+#include "src/checkpoint.h"
+
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
@@ -32,15 +35,26 @@ class Passenger {  // : public Reporter {
   void Update();
   void GetOnBus();
   int GetTotalWait() const;
+  int GetWaitAtStop() const { return wait_at_stop_; }
+  int GetTimeOnBus() const { return time_on_bus_; }
   bool IsOnBus() const;
   int GetDestination() const;
   void Report(std::ostream&) const;
+  // Checkpoint of the passenger, read back by Load
+  void Save(CheckpointWriter * out) const;
+  // Passenger saved by Save, or NULL if the reader failed
+  static Passenger * Load(CheckpointReader * in);
+  // Number of passengers created so far, the ID of the next one. Shared by
+  // every simulation of the process, so IDs stay unique across threads
+  static int GetCount() { return count_; }
+  static void SetCount(int count) { count_ = count; }
  private:
   std::string name_;
   int destination_stop_id_;
   int wait_at_stop_;
   int time_on_bus_;
   int id_;
-  static int count_;  // global count, used to set ID for new instances
+  // global count, used to set ID for new instances
+  static std::atomic<int> count_;
 };
 #endif  // SRC_PASSENGER_H_
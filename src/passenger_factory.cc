@@ -3,7 +3,6 @@
  *
  * @copyright 2019 3081 Staff, All rights reserved.
  */
-#include <random>
 #include <string>
 #include "src/passenger_factory.h"
 
@@ -14,11 +13,6 @@
  */
 // #define CONSTPASS 1
 
-std::random_device dev;
-std::mt19937 e(dev());
-std::uniform_int_distribution<std::mt19937::result_type> dist(1, 1000);
-
-
 // Here I will create an array of prefixes to help generate names.
 // I am banking on multiplication to ensure a large number of names
 // by using 7 prefixes and 20 stems, and 16 suffixes I should be able to
@@ -55,14 +49,19 @@ static const char* NameStemsArray[20] = {
  ******************************************************************************/
 // Code for name generation adapted from:
 // https://www.dreamincode.net/forums/topic/27024-data-modeling-for-games-in-c-part-ii/
-Passenger * PassengerFactory::Generate(int curr_stop, int last_stop) {
-  std::string new_name = NameGeneration();
+Passenger * PassengerFactory::Generate(int curr_stop, int last_stop,
+                                       RandomStreams * random) {
+  if (!random) {
+    random = RandomStreams::GetDefault();
+  }
+  std::string new_name = NameGeneration(random);
 
   // common use of random integer generation to determine
   //  what stop the passenger will depart the bus
 
 #ifndef CONSTPASS
-  int destination = (dist(e) % (last_stop - curr_stop)) + curr_stop + 1;
+  int destination = (random->NextPassenger() % (last_stop - curr_stop))
+                  + curr_stop + 1;
 #endif
 
 #ifdef CONSTPASS
@@ -72,12 +71,15 @@ Passenger * PassengerFactory::Generate(int curr_stop, int last_stop) {
   return new Passenger(destination, new_name);
 }
 
-std::string PassengerFactory::NameGeneration() {
-  // assume rand is seeded
+std::string PassengerFactory::NameGeneration(RandomStreams * random) {
 #ifndef CONSTPASS
-  std::string name = std::string(NamePrefixArray[(dist(e) % 7)]) +
-                     std::string(NameStemsArray[(dist(e) % 20)]) +
-                     std::string(NameSuffixArray[(dist(e) % 16)]);
+  // Drawn in turn, a seeded stream gives the same name on every compiler
+  int prefix = random->NextPassenger() % 7;
+  int stem = random->NextPassenger() % 20;
+  int suffix = random->NextPassenger() % 16;
+  std::string name = std::string(NamePrefixArray[prefix]) +
+                     std::string(NameStemsArray[stem]) +
+                     std::string(NameSuffixArray[suffix]);
 #endif
 
 #ifdef CONSTPASS
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "src/passenger.h"
+#include "src/random_streams.h"
 
 /*******************************************************************************
  * Class Definitions
@@ -31,16 +32,17 @@ class PassengerFactory {
   *
   * @param[in] curr_stop Current stop, left bound (not-inclusive)
   * @param[in] last_stop Last stop, right bound (inclusive)
+  * @param[in] random Streams of the network, or NULL for the default ones
   *
   * @return Passenger object with name and destination.
   */
-  static Passenger * Generate(int, int);
+  static Passenger * Generate(int, int, RandomStreams * random = NULL);
  private:
  /**
   * @brief Generation of randomized passenger name from prefix, stems and suffixes.
   *
   * @return Randomized passenger name.
   */
-  static std::string NameGeneration();
+  static std::string NameGeneration(RandomStreams * random);
 };
 #endif  // SRC_PASSENGER_FACTORY_H_
@@ -9,7 +9,8 @@
 #include "src/passenger.h"
 
 PassengerGenerator::PassengerGenerator(std::list<double> probs,
-   std::list<Stop *> stops) {
+   std::list<Stop *> stops, RandomStreams * random) {
   generation_probabilities_ = probs;
   stops_ = stops;
+  random_ = random ? random : RandomStreams::GetDefault();
 }
@@ -9,18 +9,23 @@
 
 #include <list>
 #include "src/passenger_factory.h"
+#include "src/random_streams.h"
 #include "src/stop.h"
 
 class Stop;  // forward declaration
 
 class PassengerGenerator {
  public:
-  PassengerGenerator(std::list<double>, std::list<Stop *>);
+  // Without streams of its own the generator draws from the default ones
+  PassengerGenerator(std::list<double>, std::list<Stop *>,
+                     RandomStreams * random = NULL);
+  virtual ~PassengerGenerator() {}
   // Makes the class abstract, cannot instantiate and forces subclass override
   virtual int GeneratePassengers() = 0;  // pure virtual
  protected:
   std::list<double> generation_probabilities_;
   std::list<Stop *> stops_;
+  RandomStreams * random_;  // not owned
 
   // should we be using a singleton here somehow?
   // PassengerFactory * pass_factory;
@@ -6,7 +6,9 @@
 #include "src/passenger_unloader.h"
 
 int PassengerUnloader::UnloadPassengers(std::list<Passenger *>* passengers,
-                                        Stop * current_stop) {
+                                        Stop * current_stop,
+                                        EventBus * events, int bus_id,
+                                        int route_id) {
   // TODO(wendt): may need to do end-of-life here
   // instead of in Passenger or Simulator
   int passengers_unloaded = 0;
@@ -14,14 +16,21 @@ int PassengerUnloader::UnloadPassengers(std::list<Passenger *>* passengers,
       it != passengers->end();
       it++) {
     if ((*it)->GetDestination() == current_stop->GetId()) {
-      pass_ss.str("");  // empty the ostringstream
-      (*it)->Report(pass_ss);
-      // Passing the passenger information and write to the log file
-      // for passenger data
-      instance->Write(passenger_file_name, Util::ProcessOutput(pass_ss));
-      // could be used to inform scheduler of end-of-life?
-      // This could be a destructor issue as well.
-      // *it->FinalUpdate();
+      if (instance) {
+        pass_ss.str("");  // empty the ostringstream
+        (*it)->Report(pass_ss);
+        // Passing the passenger information and write to the log file
+        // for passenger data
+        instance->Write(passenger_file_name, Util::ProcessOutput(pass_ss));
+      }
+      if (events && events->HasSubscribers<PassengerAlightedEvent>()) {
+        events->Publish(current_stop->GetStopData().id,
+                        PassengerAlightedEvent(bus_id, route_id,
+                          current_stop->GetStopData().id,
+                          (*it)->GetWaitAtStop(), (*it)->GetTimeOnBus()));
+      }
+      // End of life, nothing refers to a passenger once it got off
+      delete *it;
       it = passengers->erase(it);
       // getting seg faults, probably due to reference deleted objects
       // here
@@ -13,6 +13,8 @@
 #include "src/file_writer.h"
 #include "src/file_writer_manager.h"
 #include "src/util.h"
+#include "src/event_bus.h"
+#include "src/name_table.h"
 
 class Stop;
 class Passenger;
@@ -26,7 +28,13 @@ class PassengerUnloader {
     instance = FileWriterManager::GetInstance();
   }
   // UnloadPassengers returns the number of passengers removed from the bus.
-  int UnloadPassengers(std::list<Passenger*>* passengers, Stop * current_stop);
+  // A PassengerAlightedEvent is published for each of them if events is set.
+  int UnloadPassengers(std::list<Passenger*>* passengers, Stop * current_stop,
+                       EventBus * events = NULL,
+                       int bus_id = NameTable::kNoId,
+                       int route_id = NameTable::kNoId);
+  // Log the passengers are reported to, NULL reports none
+  void SetLog(FileWriter * log) { instance = log; }
 
  private:
   // Stringstream for logging purpose
@@ -6,11 +6,10 @@
 
 #include "src/random_passenger_generator.h"
 
-std::minstd_rand0 RandomPassengerGenerator::my_rand(time(0));
-
 // Nothing to do here, just pass args along
 RandomPassengerGenerator::RandomPassengerGenerator(std::list<double> probs,
-    std::list<Stop *> stops) : PassengerGenerator(probs, stops) {}
+    std::list<Stop *> stops, RandomStreams * random) :
+    PassengerGenerator(probs, stops, random) {}
 
 /*
  *  GeneratePassengers uses the route's passenger generation probabilities per stop to determine how many passengers to create.
@@ -32,7 +31,6 @@ int RandomPassengerGenerator::GeneratePassengers() {
   stop_iter--;
   int last_stop_index = (*stop_iter)->GetId();
   // TODO(Staff): check for accuracy
-  std::cout << "Time to generate!" << std::endl;
   for (prob_iter = generation_probabilities_.begin(),
                           stop_iter = stops_.begin();
        prob_iter != generation_probabilities_.end()
@@ -41,13 +39,14 @@ int RandomPassengerGenerator::GeneratePassengers() {
     // get this stop's probability
     double initial_generation_probability = *prob_iter;
     double current_generation_probability = initial_generation_probability;
+    int attempt = 0;
 
     // while there is still a (>.01%) chance of generating a passenger, try
     while (current_generation_probability > .0001
             && stop_index != last_stop_index) {
       // generate a random double value_comp
       double generation_value =
-               ((my_rand() - my_rand.min()) / (my_rand.max() * 1.0));
+        random_->NextArrival((*stop_iter)->GetId(), attempt++);
       // e.g. `.54234234 < .90`, generate a passenger
       // `.912353254 !< .90`, don't generate
       // this gives us a 90% chance of creating a passenger
@@ -56,7 +55,7 @@ int RandomPassengerGenerator::GeneratePassengers() {
         // return value is 1 if passenger was added, 0 if it wasn't
         Passenger * tmp = PassengerFactory::
                           Generate(stop_index,
-                                 last_stop_index);
+                                 last_stop_index, random_);
         passengers_added += (*stop_iter)->AddPassengers(tmp);
       }
       // whether you generated or not, square the probability (reducing it)
@@ -8,8 +8,6 @@
 #define SRC_RANDOM_PASSENGER_GENERATOR_H_
 
 #include <list>
-#include <random>
-#include <ctime>
 
 #include "src/passenger_generator.h"
 #include "src/stop.h"
@@ -18,11 +16,9 @@ class Stop;  // forward declaration
 
 class RandomPassengerGenerator : public PassengerGenerator{
  public:
-  RandomPassengerGenerator(std::list<double>, std::list<Stop *>);
+  RandomPassengerGenerator(std::list<double>, std::list<Stop *>,
+                           RandomStreams * random = NULL);
   int GeneratePassengers() override;
-
- private:
-  static std:: minstd_rand0 my_rand;
 };
 
 #endif  // SRC_RANDOM_PASSENGER_GENERATOR_H_
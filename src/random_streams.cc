@@ -0,0 +1,167 @@
+/**
+ * @file random_streams.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/random_streams.h"
+
+#include <ctime>
+#include <sstream>
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+// SplitMix64 finalizer, a well mixed 64 bit value of every 64 bit value
+static uint64_t Mix(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+static uint64_t Hash(uint64_t first, uint64_t second) {
+  return Mix(Mix(first) ^ second);
+}
+
+// First dimension of the Sobol sequence, its index with the bits reversed
+static uint32_t ReverseBits(uint32_t value) {
+  value = ((value >> 1) & 0x55555555u) | ((value & 0x55555555u) << 1);
+  value = ((value >> 2) & 0x33333333u) | ((value & 0x33333333u) << 2);
+  value = ((value >> 4) & 0x0f0f0f0fu) | ((value & 0x0f0f0f0fu) << 4);
+  value = ((value >> 8) & 0x00ff00ffu) | ((value & 0x00ff00ffu) << 8);
+  return (value >> 16) | (value << 16);
+}
+
+RandomStreams::RandomStreams() :
+  seed_(static_cast<uint32_t>(time(0))), mode_(kSequential),
+  antithetic_(false), arrivals_(seed_), passengers_(std::random_device()()),
+  passengerDist_(1, 1000), arrivalKey_(0), passengerDraws_(0) {
+}
+
+RandomStreams::RandomStreams(uint32_t seed) :
+  mode_(kSequential), antithetic_(false), passengerDist_(1, 1000) {
+  Seed(seed);
+}
+
+void RandomStreams::Seed(uint32_t seed) {
+  seed_ = seed;
+  arrivals_.seed(seed);
+  // Spread over the whole state, a small seed would leave most of it zero
+  std::seed_seq sequence = {seed};
+  passengers_.seed(sequence);
+  passengerDist_.reset();
+  steps_.clear();
+  arrivalKey_ = 0;
+  passengerDraws_ = 0;
+}
+
+void RandomStreams::SetArrivalMode(ArrivalMode mode, bool antithetic) {
+  mode_ = mode;
+  antithetic_ = antithetic;
+}
+
+double RandomStreams::NextArrival(int stop, int attempt) {
+  if (mode_ == kSequential) {
+    std::minstd_rand0::result_type value = arrivals_();
+    if (antithetic_) {
+      value = arrivals_.max() - value + arrivals_.min();
+    }
+    return (value - arrivals_.min()) / (arrivals_.max() * 1.0);
+  }
+
+  // The step of the stop, counted by its own draws so that it does not
+  // depend on what other stops or busses do
+  size_t index = stop < 0 ? 0 : static_cast<size_t>(stop);
+  if (index >= steps_.size()) {
+    steps_.resize(index + 1, 0);
+  }
+  if (attempt == 0) {
+    steps_[index]++;
+  }
+  uint32_t step = steps_[index] == 0 ? 0 : steps_[index] - 1;
+  uint64_t attemptKey = Hash(Hash(seed_, index), attempt);
+  arrivalKey_ = Hash(attemptKey, step);
+  passengerDraws_ = 0;
+
+  if (mode_ == kSobol) {
+    // Shifted by a random digit mask of the stop and attempt, every step
+    // count still splits [0, 1) as evenly as the unshifted sequence
+    uint32_t value = ReverseBits(step) ^ static_cast<uint32_t>(attemptKey);
+    if (antithetic_) {
+      value = ~value;
+    }
+    return value * (1.0 / 4294967296.0);
+  }
+  uint64_t value = arrivalKey_ >> 11;
+  if (antithetic_) {
+    value = ((1ULL << 53) - 1) - value;
+  }
+  return value * (1.0 / 9007199254740992.0);
+}
+
+int RandomStreams::NextPassenger() {
+  if (mode_ == kSequential) {
+    return passengerDist_(passengers_);
+  }
+  uint64_t value = Hash(arrivalKey_, ++passengerDraws_);
+  return static_cast<int>(value % 1000) + 1;
+}
+
+std::string RandomStreams::GetState() const {
+  std::ostringstream state;
+  state << static_cast<int>(mode_) << ' ' << (antithetic_ ? 1 : 0) << ' '
+        << seed_ << ' ' << arrivals_ << ' ' << passengers_ << ' '
+        << passengerDist_ << ' ' << arrivalKey_ << ' ' << passengerDraws_
+        << ' ' << steps_.size();
+  for (size_t i = 0; i < steps_.size(); i++) {
+    state << ' ' << steps_[i];
+  }
+  return state.str();
+}
+
+bool RandomStreams::SetState(const std::string& state) {
+  // Parsed into copies, a bad state leaves the streams as they were
+  std::istringstream in(state);
+  int mode;
+  int antithetic;
+  uint32_t seed;
+  std::minstd_rand0 arrivals;
+  std::mt19937 passengers;
+  std::uniform_int_distribution<int> passengerDist;
+  uint64_t arrivalKey;
+  uint32_t passengerDraws;
+  size_t numSteps;
+  // The engine reads its state without skipping the space before it
+  if (!(in >> mode >> antithetic >> seed >> std::ws >> arrivals >> passengers
+           >> passengerDist >> arrivalKey >> passengerDraws >> numSteps)
+      || mode < kSequential || mode > kSobol
+      || (antithetic != 0 && antithetic != 1)) {
+    return false;
+  }
+  std::vector<uint32_t> steps;
+  for (size_t i = 0; i < numSteps; i++) {
+    uint32_t step;
+    if (!(in >> step)) {
+      return false;
+    }
+    steps.push_back(step);
+  }
+  mode_ = static_cast<ArrivalMode>(mode);
+  antithetic_ = antithetic != 0;
+  seed_ = seed;
+  arrivals_ = arrivals;
+  passengers_ = passengers;
+  passengerDist_ = passengerDist;
+  arrivalKey_ = arrivalKey;
+  passengerDraws_ = passengerDraws;
+  steps_.swap(steps);
+  return true;
+}
+
+RandomStreams * RandomStreams::GetDefault() {
+  static RandomStreams streams;
+  return &streams;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file random_streams.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_RANDOM_STREAMS_H_
+#define SRC_RANDOM_STREAMS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The random numbers of one simulated network.
+ *
+ * Passenger arrivals and passenger names and destinations come from two
+ * streams of their own. A network owns its streams, so simulations on
+ * several threads neither share nor race on a generator, and a run is
+ * reproduced from its seed.
+ *
+ * Arrivals are drawn in one of three modes, see ArrivalMode, and may be
+ * antithetic, 1 - u for every u the same seed would draw, so a pair of
+ * runs with negatively correlated arrivals averages out faster.
+ *
+ * Calls to \ref Seed function to restart both streams from a seed.
+ * Calls to \ref SetArrivalMode function to choose how arrivals are drawn.
+ * Calls to \ref NextArrival function to draw an arrival chance.
+ * Calls to \ref NextPassenger function to draw for a new passenger.
+ * Calls to \ref GetState and \ref SetState functions for a checkpoint.
+ */
+class RandomStreams {
+ public:
+  enum ArrivalMode {
+    // One sequence for the whole network, in draw order
+    kSequential = 0,
+    // A number of its own for every attempt of every stop at every step,
+    // so runs of the same seed replay the same arrivals whatever their
+    // headways or demand: common random numbers across scenarios
+    kCommon = 1,
+    // Like kCommon, but the steps of an attempt of a stop follow a
+    // randomly shifted Sobol sequence, which covers [0, 1) more evenly
+    // than independent numbers
+    kSobol = 2
+  };
+
+  // Seeded from the clock and the system, like the generators it replaces
+  RandomStreams();
+  explicit RandomStreams(uint32_t seed);
+  // Restarts every stream, keeping the arrival mode
+  void Seed(uint32_t seed);
+  void SetArrivalMode(ArrivalMode mode, bool antithetic = false);
+  ArrivalMode GetArrivalMode() const { return mode_; }
+  bool IsAntithetic() const { return antithetic_; }
+ /**
+  * @brief Draw the chance a passenger arrives, compared to a probability.
+  *
+  * @param[in] stop Id of the stop the passenger would arrive at
+  * @param[in] attempt Attempt of the stop in this step, 0 starts a step
+  * @return A value in [0, 1).
+  */
+  double NextArrival(int stop, int attempt);
+ /**
+  * @brief Draw a number a passenger name or destination is picked with.
+  *
+  * Outside kSequential, the draws after an arrival depend on that arrival
+  * only, so the same passenger arrives in every run replaying it.
+  *
+  * @return A value in [1, 1000].
+  */
+  int NextPassenger();
+  std::string GetState() const;
+ /**
+  * @brief Restore a state of GetState, arrival mode included.
+  *
+  * @return false, leaving the streams as they were, if it cannot be parsed.
+  */
+  bool SetState(const std::string& state);
+ /**
+  * @brief Streams of the generators built without any.
+  *
+  * Shared by all of them, only for single threaded use such as the tests
+  * and the drivers.
+  */
+  static RandomStreams * GetDefault();
+
+ private:
+  uint32_t seed_;
+  ArrivalMode mode_;
+  bool antithetic_;
+  std::minstd_rand0 arrivals_;
+  std::mt19937 passengers_;
+  std::uniform_int_distribution<int> passengerDist_;
+  // Steps drawn so far, by stop id, outside kSequential
+  std::vector<uint32_t> steps_;
+  // The last arrival and the passenger draws made since, outside
+  // kSequential
+  uint64_t arrivalKey_;
+  uint32_t passengerDraws_;
+};
+
+#endif  // SRC_RANDOM_STREAMS_H_
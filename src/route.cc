@@ -9,27 +9,38 @@
 #include <vector>
 
 #include "src/route.h"
+#include "src/name_table.h"
 
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
-Route::Route(std::string name, Stop ** stops, double * distances, int num_stops,
-                                               PassengerGenerator * generator) {
+Route::Route(std::string name, Stop ** stops, const double * distances,
+             int num_stops, PassengerGenerator * generator,
+             const double * bearings, NameTable * names) {
   // Get a collection of stops on the route
   for (int i = 0; i < num_stops; i++) {
     stops_.push_back(stops[i]);
   }
-  // Get a collection of distence between two stops
-  for (int i = 0; i < num_stops - 1; i++) {
-    distances_between_.push_back(distances[i]);
+  // Get a collection of distence between two stops, and of headings
+  if (num_stops > 1) {
+    distances_between_.assign(distances, distances + num_stops - 1);
+    if (bearings) {
+      bearings_between_.assign(bearings, bearings + num_stops - 1);
+    } else {
+      bearings_between_.assign(num_stops - 1, 0);
+    }
   }
 
   name_ = name;
+  // Interned here, so the clones handed to busses have it too
+  names_ = names ? names : NameTable::GetDefault();
+  id_ = names_->Intern(name_);
   generator_ = generator;
   num_stops_ = num_stops;
   // Need to see if this (next statement) is right. How does first stop work?
   destination_stop_index_ = 0;
   destination_stop_ = stops[0];
+  changed_ = false;
 }
 
 Route * Route::Clone() {
@@ -44,18 +55,32 @@ Route * Route::Clone() {
     stop_index++;
   }
 
-  // constructor needs distance *, we have list<double>
-  double * distances = new double[distances_between_.size()];
-  int distance_index = 0;
-  // Type conversion of stops
-  for (std::list<double>::iterator it = distances_between_.begin();
-      it != distances_between_.end();
-      it++) {
-    distances[distance_index] = *it;
-    distance_index++;
-  }
+  // The constructor copies the arrays into its own storage
+  Route * clone = new Route(name_, stops, distances_between_.data(),
+                            num_stops_, generator_, bearings_between_.data(),
+                            names_);
+  delete[] stops;
+  return clone;
+}
 
-  return new Route(name_, stops, distances, num_stops_, generator_);
+void Route::ResetCursor() {
+  destination_stop_index_ = 0;
+  destination_stop_ = stops_.front();
+}
+
+bool Route::SetCursor(int index) {
+  if (index < 0 || index > num_stops_) {
+    return false;
+  }
+  destination_stop_index_ = index;
+  if (index < num_stops_) {
+    std::list<Stop *>::const_iterator iter = stops_.begin();
+    std::advance(iter, index);
+    destination_stop_ = *iter;
+  } else {
+    destination_stop_ = NULL;
+  }
+  return true;
 }
 
 void Route::Update() {
@@ -134,7 +159,7 @@ Stop * Route::GetDestinationStop() const {
 double Route::GetTotalRouteDistance() const {
   int total_distance = 0;
   // Sum up the distances between stops
-  for (std::list<double>::const_iterator iter = distances_between_.begin();
+  for (std::vector<double>::const_iterator iter = distances_between_.begin();
       iter != distances_between_.end();
       iter++) {
     total_distance += *iter;
@@ -144,15 +169,23 @@ double Route::GetTotalRouteDistance() const {
 
 double Route::GetNextStopDistance() const {
   // Check whether it is the next stop
-  if (destination_stop_index_ > 0) {
-      std::list<double>::const_iterator iter = distances_between_.begin();
-      std::advance(iter, destination_stop_index_-1);
-      return *iter;  // resolving the iterator gets you the Stop * from the list
-  // return distances_between_[destination_stop_index_ - 1];
-  // CAN'T DO THIS (return statement above) ; see NextStop()
+  if (destination_stop_index_ > 0
+      && destination_stop_index_ <= static_cast<int>(
+           distances_between_.size())) {
+    return distances_between_[destination_stop_index_ - 1];
   } else {
-        return 0;
-    }
+    return 0;
+  }
+}
+
+double Route::GetNextStopBearing() const {
+  if (destination_stop_index_ > 0
+      && destination_stop_index_ <= static_cast<int>(
+           bearings_between_.size())) {
+    return bearings_between_[destination_stop_index_ - 1];
+  } else {
+    return 0;
+  }
 }
 
 int Route::GenerateNewPassengers() {
@@ -160,28 +193,34 @@ int Route::GenerateNewPassengers() {
   return generator_->GeneratePassengers();
 }
 
-void Route::UpdateRouteData() {
-    route_data_.id = name_;
+void Route::InitRouteData() {
+    route_data_.id = id_;
 
-    std::vector<StopData> stopDataVec = std::vector<StopData>();
-    // Update all stops on the route
+    // Stop metadata is owned by the stops, so only keep a view of it
+    route_data_.stops.clear();
+    route_data_.stops.reserve(stops_.size());
     for (auto* s : stops_) {
-        StopData stopData;
-
-        stopData.id = std::to_string(s->GetId());
-
-        Position p;
-        p.x = s->GetLongitude();
-        p.y = s->GetLatitude();
-        stopData.position = p;
-
-        stopData.num_people = static_cast<int>(s->GetNumPassengersPresent());
-
-        stopDataVec.push_back(stopData);
+        route_data_.stops.push_back(&s->GetStopData());
     }
-    route_data_.stops = stopDataVec;
+    route_data_.num_people.assign(stops_.size(), 0);
+    route_data_.dirty.assign(stops_.size(), false);
 }
 
-RouteData Route::GetRouteData() const {
-    return route_data_;
+void Route::UpdateRouteData() {
+    // Prototype routes build their static data on the first update, while
+    // the clones handed to busses never pay for it
+    if (route_data_.stops.size() != stops_.size()) {
+        InitRouteData();
+    }
+
+    // Per tick only the waiting counts are refreshed
+    int i = 0;
+    changed_ = false;
+    for (auto* s : stops_) {
+        int num_people = static_cast<int>(s->GetNumPassengersPresent());
+        route_data_.dirty[i] = (route_data_.num_people[i] != num_people);
+        changed_ = changed_ || route_data_.dirty[i];
+        route_data_.num_people[i] = num_people;
+        i++;
+    }
 }
@@ -9,18 +9,23 @@
 #include <list>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "./data_structs.h"
 
 #include "./passenger_generator.h"
 #include "./stop.h"
 
+class NameTable;
 class PassengerGenerator;
 
 class Route {
  public:
-  Route(std::string name, Stop ** stops, double * distances, int num_stops,
-        PassengerGenerator *);
+  // bearings, like distances, has num_stops - 1 entries, or is NULL. The
+  // name is interned in names, NameTable::GetDefault if NULL
+  Route(std::string name, Stop ** stops, const double * distances,
+        int num_stops, PassengerGenerator *,
+        const double * bearings = NULL, NameTable * names = NULL);
   Route * Clone();
   void Update();
   void Report(std::ostream&);
@@ -28,27 +33,44 @@ class Route {
 
   Stop *  PrevStop();  // Returns stop before destination stop
   void ToNextStop();  // Change destination_stop_ to next stop
+  void ResetCursor();  // Back to the first stop, for a recycled bus
+  // Index of the destination stop, num_stops once at the end
+  int GetCursor() const { return destination_stop_index_; }
+  bool SetCursor(int index);  // false if out of range, for a checkpoint
   Stop * GetDestinationStop() const;    // Get pointer to next stop
   double GetTotalRouteDistance() const;
   double GetNextStopDistance() const;
+  // Heading towards the next stop, degrees clockwise from north
+  double GetNextStopBearing() const;
 
   // Vis Getters
   std::string GetName() const { return name_; }
-  std::list<Stop *> GetStops() const { return stops_; }
+  // Interned name, see NameTable
+  int GetId() const { return id_; }
+  // Table of the network of the route, the busses on it intern theirs there
+  NameTable * GetNames() const { return names_; }
+  const std::list<Stop *>& GetStops() const { return stops_; }
   void UpdateRouteData();
-  RouteData GetRouteData() const;
+  const RouteData& GetRouteData() const { return route_data_; }
+  // Whether a waiting count changed in the last UpdateRouteData
+  bool HasChanged() const { return changed_; }
 
  private:
   int GenerateNewPassengers();       // generates passengers on its route
+  void InitRouteData();  // builds the static part of route_data_ once
   PassengerGenerator * generator_;
   std::list<Stop *> stops_;
-  std::list<double> distances_between_;  // length = num_stops_ - 1
+  std::vector<double> distances_between_;  // length = num_stops_ - 1
+  std::vector<double> bearings_between_;  // length = num_stops_ - 1
   std::string name_;
+  int id_;
+  NameTable * names_;  // not owned
   int num_stops_;
   int destination_stop_index_;  // always starts at zero, no init needed
   Stop * destination_stop_;
   // double trip_time_; // derived data - total distance travelled on route
   RouteData route_data_;
+  bool changed_;
 };
 #endif  // SRC_ROUTE_H_
 
@@ -0,0 +1,55 @@
+/**
+ * @file running_stats.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/running_stats.h"
+
+#include <cmath>
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+// 97.5% quantiles of the Student t distribution, by degrees of freedom
+static const double kTQuantiles[30] = {
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void RunningStats::Add(double sample) {
+  count_++;
+  double delta = sample - mean_;
+  mean_ += delta / count_;
+  squares_ += delta * (sample - mean_);
+}
+
+double RunningStats::GetVariance() const {
+  return count_ > 1 ? squares_ / (count_ - 1) : 0;
+}
+
+double RunningStats::GetHalfWidth() const {
+  if (count_ < 2) {
+    return 0;
+  }
+  int freedom = count_ - 1;
+  double t;
+  if (freedom <= 30) {
+    t = kTQuantiles[freedom - 1];
+  } else {
+    // Cornish-Fisher expansion around the normal quantile, within 0.001
+    // past 30 degrees of freedom
+    const double z = 1.959964;
+    double z3 = z * z * z;
+    double z5 = z3 * z * z;
+    t = z + (z3 + z) / (4.0 * freedom)
+          + (5 * z5 + 16 * z3 + 3 * z) / (96.0 * freedom * freedom);
+  }
+  return t * std::sqrt(GetVariance() / count_);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file running_stats.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_RUNNING_STATS_H_
+#define SRC_RUNNING_STATS_H_
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Mean and confidence interval of a stream of samples.
+ *
+ * Samples are folded in one at a time with Welford's update, so the
+ * statistics are exact at every point of the stream without keeping the
+ * samples, and do not lose precision over a long one.
+ *
+ * Calls to \ref Add function to fold a sample in.
+ * Calls to \ref GetMean and \ref GetHalfWidth functions for the interval.
+ */
+class RunningStats {
+ public:
+  RunningStats() : count_(0), mean_(0), squares_(0) {}
+  void Add(double sample);
+  int GetCount() const { return count_; }
+  double GetMean() const { return mean_; }
+  // Sample variance, 0 below two samples
+  double GetVariance() const;
+ /**
+  * @brief Half the width of the 95% confidence interval of the mean.
+  *
+  * Uses the Student t distribution, the samples being independent runs of
+  * a few, not many, replications.
+  *
+  * @return The half width, 0 below two samples.
+  */
+  double GetHalfWidth() const;
+
+ private:
+  int count_;
+  double mean_;
+  double squares_;  // sum of squared distances to the mean
+};
+
+#endif  // SRC_RUNNING_STATS_H_
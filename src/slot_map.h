@@ -0,0 +1,133 @@
+/**
+ * @file slot_map.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_SLOT_MAP_H_
+#define SRC_SLOT_MAP_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Stable reference to a value of a SlotMap.
+ *
+ * A handle goes stale once its value is removed, even if the slot is
+ * reused by a later value.
+ */
+struct SlotHandle {
+  SlotHandle() : slot(-1), generation(0) {}
+  SlotHandle(int slot, unsigned int generation) :
+    slot(slot), generation(generation) {}
+  int slot;
+  unsigned int generation;
+};
+
+/**
+ * @brief Dense storage with stable handles and O(1) insert and remove.
+ *
+ * The values are kept contiguous for iteration, removing one moves the
+ * last value into its place. Handles go through a slot table that follows
+ * the moves, and the slots of removed values are reused, so a map that
+ * stays the same size stops allocating.
+ *
+ * Calls to \ref Insert function to add a value and get its handle.
+ * Calls to \ref Remove function to swap-remove a value.
+ * Calls to \ref Get function to resolve a handle.
+ */
+template <typename T>
+class SlotMap {
+ public:
+  /**
+   * @brief Add a value at the end of the dense order.
+   *
+   * @return Handle of the value
+   */
+  SlotHandle Insert(const T& value) {
+    int slot;
+    if (free_slots_.empty()) {
+      slot = static_cast<int>(slots_.size());
+      slots_.push_back(Slot());
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    slots_[slot].index = static_cast<int>(values_.size());
+    values_.push_back(value);
+    value_slots_.push_back(slot);
+    return SlotHandle(slot, slots_[slot].generation);
+  }
+  /**
+   * @brief Remove the value of a handle, if it is still there.
+   */
+  bool Remove(SlotHandle handle) {
+    if (!Contains(handle)) return false;
+    RemoveAt(slots_[handle.slot].index);
+    return true;
+  }
+  /**
+   * @brief Remove the value at a position of the dense order.
+   *
+   * The last value takes its place, so iterate backwards to remove while
+   * iterating.
+   */
+  void RemoveAt(int index) {
+    int slot = value_slots_[index];
+    int last = static_cast<int>(values_.size()) - 1;
+    if (index != last) {
+      values_[index] = values_[last];
+      value_slots_[index] = value_slots_[last];
+      slots_[value_slots_[index]].index = index;
+    }
+    values_.pop_back();
+    value_slots_.pop_back();
+    // Stales every handle to the removed value
+    slots_[slot].generation++;
+    slots_[slot].index = -1;
+    free_slots_.push_back(slot);
+  }
+  /**
+   * @brief Get the value of a handle, or NULL if it was removed.
+   */
+  T * Get(SlotHandle handle) {
+    return Contains(handle) ? &values_[slots_[handle.slot].index] : NULL;
+  }
+  bool Contains(SlotHandle handle) const {
+    return handle.slot >= 0 && handle.slot < static_cast<int>(slots_.size())
+        && slots_[handle.slot].generation == handle.generation
+        && slots_[handle.slot].index >= 0;
+  }
+  /**
+   * @brief Get the handle of the value at a position of the dense order.
+   */
+  SlotHandle HandleAt(int index) const {
+    int slot = value_slots_[index];
+    return SlotHandle(slot, slots_[slot].generation);
+  }
+  T& operator[](int index) { return values_[index]; }
+  const T& operator[](int index) const { return values_[index]; }
+  int Size() const { return static_cast<int>(values_.size()); }
+  void Clear() {
+    while (!values_.empty()) {
+      RemoveAt(static_cast<int>(values_.size()) - 1);
+    }
+  }
+
+ private:
+  struct Slot {
+    Slot() : index(-1), generation(0) {}
+    int index;  // position in values_, -1 while free
+    unsigned int generation;
+  };
+  std::vector<T> values_;
+  std::vector<int> value_slots_;  // slot of each value, parallel to values_
+  std::vector<Slot> slots_;
+  std::vector<int> free_slots_;
+};
+
+#endif  // SRC_SLOT_MAP_H_
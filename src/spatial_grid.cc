@@ -0,0 +1,113 @@
+/**
+ * @file spatial_grid.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/spatial_grid.h"
+
+#include <cmath>
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+SpatialGrid::SpatialGrid(double cellSize) : cellSize_(cellSize) {}
+
+int64_t SpatialGrid::CellOf(double x, double y) const {
+  return CellKey(static_cast<int64_t>(std::floor(x / cellSize_)),
+             static_cast<int64_t>(std::floor(y / cellSize_)));
+}
+
+void SpatialGrid::Unlink(const Entry& entry) {
+  // Swap-remove, the entity moved into the slot is told its new place
+  std::vector<int>& cell = cells_[entry.cell];
+  int moved = cell.back();
+  cell[entry.slot] = moved;
+  entries_[moved].slot = entry.slot;
+  cell.pop_back();
+  if (cell.empty()) {
+    cells_.erase(entry.cell);
+  }
+}
+
+void SpatialGrid::Update(int id, double x, double y) {
+  if (id < 0) return;
+  if (id >= static_cast<int>(entries_.size())) {
+    Entry absent = {0, -1, 0, 0};
+    entries_.resize(id + 1, absent);
+  }
+  Entry& entry = entries_[id];
+  int64_t cell = CellOf(x, y);
+  entry.x = x;
+  entry.y = y;
+  if (entry.slot >= 0) {
+    if (entry.cell == cell) {
+      return;
+    }
+    Unlink(entry);
+  } else {
+    size_++;
+  }
+  std::vector<int>& list = cells_[cell];
+  entry.cell = cell;
+  entry.slot = static_cast<int>(list.size());
+  list.push_back(id);
+}
+
+void SpatialGrid::Remove(int id) {
+  if (!Contains(id)) return;
+  Unlink(entries_[id]);
+  entries_[id].slot = -1;
+  size_--;
+}
+
+bool SpatialGrid::Contains(int id) const {
+  return id >= 0 && id < static_cast<int>(entries_.size())
+      && entries_[id].slot >= 0;
+}
+
+void SpatialGrid::Query(const BoundingBox& box,
+                        std::vector<int> * ids) const {
+  if (box.max_x < box.min_x || box.max_y < box.min_y) return;
+  double minColumn = std::floor(box.min_x / cellSize_);
+  double maxColumn = std::floor(box.max_x / cellSize_);
+  double minRow = std::floor(box.min_y / cellSize_);
+  double maxRow = std::floor(box.max_y / cellSize_);
+
+  // A box covering more cells than are occupied, zoomed out, is cheaper to
+  // answer by walking the occupied cells
+  double numCells = (maxColumn - minColumn + 1) * (maxRow - minRow + 1);
+  if (numCells > static_cast<double>(cells_.size())) {
+    for (std::unordered_map<int64_t, std::vector<int> >::const_iterator it =
+         cells_.begin(); it != cells_.end(); it++) {
+      for (int i = 0; i < static_cast<int>(it->second.size()); i++) {
+        const Entry& entry = entries_[it->second[i]];
+        if (box.Contains(entry.x, entry.y)) ids->push_back(it->second[i]);
+      }
+    }
+    return;
+  }
+
+  for (int64_t column = static_cast<int64_t>(minColumn);
+       column <= static_cast<int64_t>(maxColumn); column++) {
+    for (int64_t row = static_cast<int64_t>(minRow);
+         row <= static_cast<int64_t>(maxRow); row++) {
+      std::unordered_map<int64_t, std::vector<int> >::const_iterator it =
+        cells_.find(CellKey(column, row));
+      if (it == cells_.end()) continue;
+      // Only border cells can hold entities outside the box
+      for (int i = 0; i < static_cast<int>(it->second.size()); i++) {
+        const Entry& entry = entries_[it->second[i]];
+        if (box.Contains(entry.x, entry.y)) ids->push_back(it->second[i]);
+      }
+    }
+  }
+}
+
+void SpatialGrid::Clear() {
+  entries_.clear();
+  cells_.clear();
+  size_ = 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file spatial_grid.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_SPATIAL_GRID_H_
+#define SRC_SPATIAL_GRID_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief An axis aligned box, in the same coordinates as Position.
+ */
+struct BoundingBox {
+  BoundingBox() : min_x(0), min_y(0), max_x(0), max_y(0) {}
+  BoundingBox(double min_x, double min_y, double max_x, double max_y) :
+    min_x(min_x), min_y(min_y), max_x(max_x), max_y(max_y) {}
+  bool Contains(double x, double y) const {
+    return x >= min_x && x <= max_x && y >= min_y && y <= max_y;
+  }
+  // The box grown by a fraction of its size on every side
+  BoundingBox Expand(double fraction) const {
+    double dx = (max_x - min_x) * fraction;
+    double dy = (max_y - min_y) * fraction;
+    return BoundingBox(min_x - dx, min_y - dy, max_x + dx, max_y + dy);
+  }
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+};
+
+/**
+ * @brief Uniform grid over entities keyed by interned id.
+ *
+ * Only occupied cells are stored, so the grid covers any area. Each entity
+ * remembers its cell and its place in the cell, so moving an entity inside
+ * its cell is a store and moving it to another cell is O(1).
+ *
+ * Calls to \ref Update function to add or move an entity.
+ * Calls to \ref Remove function to drop it.
+ * Calls to \ref Query function to find the entities in a box.
+ */
+class SpatialGrid {
+ public:
+ /**
+  * @param[in] cellSize Width and height of a cell
+  */
+  explicit SpatialGrid(double cellSize = 0.01);
+ /**
+  * @brief Add an entity at a position, or move it there.
+  *
+  * @param[in] id Interned id, see NameTable
+  */
+  void Update(int id, double x, double y);
+ /**
+  * @brief Drop an entity, if it is in the grid.
+  */
+  void Remove(int id);
+  bool Contains(int id) const;
+ /**
+  * @brief Append the id of every entity inside a box.
+  *
+  * Ids come in no particular order.
+  *
+  * @param[in] box Area to search
+  * @param[out] ids Ids found
+  */
+  void Query(const BoundingBox& box, std::vector<int> * ids) const;
+  void Clear();
+  int Size() const { return size_; }
+
+  // Key of the cell at a column and row, columns and rows of any map fit
+  // in 32 bits with room to spare
+  static int64_t CellKey(int64_t column, int64_t row) {
+    // Packed unsigned, shifting a negative column is undefined
+    return static_cast<int64_t>((static_cast<uint64_t>(column) << 32)
+                                | static_cast<uint32_t>(row));
+  }
+  static int32_t CellColumn(int64_t key) {
+    return static_cast<int32_t>(static_cast<uint64_t>(key) >> 32);
+  }
+  static int32_t CellRow(int64_t key) {
+    return static_cast<int32_t>(key & 0xffffffff);
+  }
+
+ private:
+  struct Entry {
+    int64_t cell;
+    int slot;  // index in the entity list of the cell, -1 if absent
+    double x;
+    double y;
+  };
+  int64_t CellOf(double x, double y) const;
+  void Unlink(const Entry& entry);
+
+  double cellSize_;
+  std::vector<Entry> entries_;  // indexed by id
+  std::unordered_map<int64_t, std::vector<int> > cells_;
+  int size_ = 0;
+};
+
+#endif  // SRC_SPATIAL_GRID_H_
@@ -4,14 +4,25 @@
  * @copyright 2019 3081 Staff, All rights reserved.
  */
 #include <iostream>
+#include <string>
 #include <vector>
 #include "src/stop.h"
+#include "src/name_table.h"
 
 // Defaults to Westbound Coffman Union stop
 Stop::Stop(int id, double longitude,
-        double latitude) : id_(id), longitude_(longitude), latitude_(latitude) {
+        double latitude, NameTable * names) : id_(id), longitude_(longitude),
+        latitude_(latitude) {
   // no initialization of list of passengers necessary
   passengers_.clear();
+
+  // The name and position never change, so build them only once
+  if (!names) {
+    names = NameTable::GetDefault();
+  }
+  stop_data_.id = names->Intern(std::to_string(id_));
+  stop_data_.position.x = longitude_;
+  stop_data_.position.y = latitude_;
 }
 
 int Stop::LoadPassengers(Bus * bus) {
@@ -51,7 +62,6 @@ void Stop::Update() {
   }
 
   UpdateStopData();
-  NotifyObservers(&stop_data_);
 }
 
 int Stop::GetId() const {
@@ -67,21 +77,44 @@ void Stop::Report(std::ostream& out) const {
   }
 }
 
-// Update the stop_data_ variable
-void Stop::UpdateStopData() {
-  // Due to type mismatch, we need to convert explicitly
-  stop_data_.id = std::to_string(id_);
+void Stop::Save(CheckpointWriter * out) const {
+  out->WriteInt(id_);
+  out->WriteInt(static_cast<int>(passengers_.size()));
+  for (std::list<Passenger *>::const_iterator it = passengers_.begin();
+                                        it != passengers_.end(); it++) {
+    (*it)->Save(out);
+  }
+}
 
-  // Get the stop position, which is fixed
-  Position p;
-  p.x = GetLongitude();
-  p.y = GetLatitude();
-  stop_data_.position = p;
+bool Stop::Load(CheckpointReader * in) {
+  if (in->ReadInt() != id_) {
+    return in->Fail("checkpoint of another network, no stop "
+                    + std::to_string(id_));
+  }
+  ClearPassengers();
+  int count = in->ReadCount(5 * sizeof(int));
+  for (int i = 0; i < count; i++) {
+    Passenger * passenger = Passenger::Load(in);
+    if (!passenger) {
+      break;
+    }
+    passengers_.push_back(passenger);
+  }
+  UpdateStopData();
+  return in->IsOk();
+}
 
-  // Number of passengers waiting at the stop
-  stop_data_.num_people = static_cast<int>(passengers_.size());
+void Stop::ClearPassengers() {
+  for (std::list<Passenger *>::iterator it = passengers_.begin();
+                                    it != passengers_.end(); it++) {
+    delete *it;
+  }
+  passengers_.clear();
+  UpdateStopData();
 }
 
-StopData Stop::GetStopData() const {
-  return stop_data_;
+// Update the stop_data_ variable
+void Stop::UpdateStopData() {
+  // Only the number of passengers waiting at the stop changes over time
+  stop_data_.num_people = static_cast<int>(passengers_.size());
 }
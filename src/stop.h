@@ -10,15 +10,18 @@
 #include <iostream>
 
 #include "src/bus.h"
+#include "src/checkpoint.h"
 #include "src/passenger.h"
-#include "src/iobservable.h"
 
 
 class Bus;
+class NameTable;
 
-class Stop : public IObservable<StopData *> {
+class Stop {
  public:
-  explicit Stop(int, double = 44.973723, double = -93.235365);
+  // The id is interned in names, NameTable::GetDefault if NULL
+  explicit Stop(int, double = 44.973723, double = -93.235365,
+                NameTable * names = NULL);
   int LoadPassengers(Bus *);  // Removing passengers from stop
   // and onto a bus
   int AddPassengers(Passenger *);  // Adding passengers
@@ -26,10 +29,17 @@ class Stop : public IObservable<StopData *> {
   void Update();
   int GetId() const;
   void Report(std::ostream&) const;
+  // Checkpoint of the waiting passengers, in queue order
+  void Save(CheckpointWriter * out) const;
+  // Replaces the waiting passengers with the ones saved by Save, fails the
+  // reader if they were saved by another stop
+  bool Load(CheckpointReader * in);
+  // Deletes the waiting passengers, the stop is the only one holding them
+  void ClearPassengers();
 
   // Vis Getters
   void UpdateStopData();
-  StopData GetStopData() const;
+  const StopData& GetStopData() const { return stop_data_; }
   double GetLongitude() const { return longitude_; }
   double GetLatitude() const { return latitude_; }
   size_t GetNumPassengersPresent() { return passengers_.size(); }
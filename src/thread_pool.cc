@@ -0,0 +1,68 @@
+/**
+ * @file thread_pool.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/thread_pool.h"
+
+#include <algorithm>
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+ThreadPool::ThreadPool(int numThreads) : running_(0), stopping_(false) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < numThreads; i++) {
+    threads_.push_back(std::thread(&ThreadPool::Work, this));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_all();
+  for (int i = 0; i < static_cast<int>(threads_.size()); i++) {
+    threads_[i].join();
+  }
+}
+
+void ThreadPool::Submit(const std::function<void()>& task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(task);
+  }
+  queued_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return tasks_.empty() && running_ == 0; });
+}
+
+void ThreadPool::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queued_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+    // Stopping only once the queue is drained
+    if (tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = tasks_.front();
+    tasks_.pop_front();
+    running_++;
+    lock.unlock();
+    task();
+    lock.lock();
+    running_--;
+    if (tasks_.empty() && running_ == 0) {
+      done_.notify_all();
+    }
+  }
+}
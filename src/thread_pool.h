@@ -0,0 +1,57 @@
+/**
+ * @file thread_pool.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_THREAD_POOL_H_
+#define SRC_THREAD_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Fixed set of threads running queued tasks, in queue order.
+ *
+ * Tasks must not throw, a task reports its failure through what it writes.
+ *
+ * Calls to \ref Submit function to queue a task.
+ * Calls to \ref Wait function to wait for every queued task.
+ */
+class ThreadPool {
+ public:
+  // numThreads 0 starts one thread per core
+  explicit ThreadPool(int numThreads = 0);
+  // Runs the tasks still queued, then stops the threads
+  ~ThreadPool();
+  void Submit(const std::function<void()>& task);
+ /**
+  * @brief Wait until every task submitted so far has run.
+  */
+  void Wait();
+  int GetNumThreads() const { return static_cast<int>(threads_.size()); }
+
+ private:
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  void Work();
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;  // guards every member below
+  std::condition_variable queued_;  // a task was queued, or stopping_ set
+  std::condition_variable done_;  // the queue ran empty and no task runs
+  std::deque<std::function<void()> > tasks_;
+  int running_;
+  bool stopping_;
+};
+
+#endif  // SRC_THREAD_POOL_H_
@@ -5,6 +5,13 @@
  */
 #include "src/util.h"
 
+#include <cmath>
+
+/*******************************************************************************
+ * Static Variable Initialization
+ ******************************************************************************/
+const uint32_t Util::kChecksumSeed;
+
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
@@ -19,3 +26,59 @@ std::vector<std::string> Util::ProcessOutput(const std::ostringstream &ss) {
 
   return csv_vec;
 }
+
+void Util::MeasureSegments(const double * latitudes,
+                           const double * longitudes, int count,
+                           double * lengths, double * bearings) {
+  if (count <= 0) return;
+  const double kRadians = M_PI / 180;
+  // Mean earth radius in miles, two simulation units to the mile
+  const double kUnitsPerRadian = 3958.8 * 2;
+
+  // Every point as a unit vector, with the sines and cosines its segment
+  // needs for the local north and east directions
+  std::vector<double> sinLat(count), cosLat(count), sinLon(count),
+                      cosLon(count);
+  for (int i = 0; i < count; i++) {
+    sinLat[i] = std::sin(latitudes[i] * kRadians);
+    cosLat[i] = std::cos(latitudes[i] * kRadians);
+    sinLon[i] = std::sin(longitudes[i] * kRadians);
+    cosLon[i] = std::cos(longitudes[i] * kRadians);
+  }
+
+  // Squared chord between the points, and its east and north parts at the
+  // start point, which point along the initial great circle heading. No
+  // library calls here, so the loop vectorizes
+  std::vector<double> east(count), north(count);
+  lengths[0] = 0;
+  east[0] = 0;
+  north[0] = 1;
+  for (int i = 1; i < count; i++) {
+    double dx = cosLat[i] * cosLon[i] - cosLat[i - 1] * cosLon[i - 1];
+    double dy = cosLat[i] * sinLon[i] - cosLat[i - 1] * sinLon[i - 1];
+    double dz = sinLat[i] - sinLat[i - 1];
+    lengths[i] = dx * dx + dy * dy + dz * dz;
+    east[i] = dy * cosLon[i - 1] - dx * sinLon[i - 1];
+    north[i] = dz * cosLat[i - 1]
+             - sinLat[i - 1] * (dx * cosLon[i - 1] + dy * sinLon[i - 1]);
+  }
+
+  // A chord c spans an arc of 2 asin(c / 2), the haversine formula
+  for (int i = 1; i < count; i++) {
+    lengths[i] = 2 * std::asin(std::min(1.0, std::sqrt(lengths[i]) / 2))
+               * kUnitsPerRadian;
+  }
+  for (int i = 0; i < count; i++) {
+    double bearing = std::atan2(east[i], north[i]) / kRadians;
+    bearings[i] = bearing < 0 ? bearing + 360 : bearing;
+  }
+  bearings[0] = 0;
+}
+
+uint32_t Util::Checksum(uint32_t hash, const void * data, uint64_t size) {
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for (uint64_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
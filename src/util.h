@@ -9,6 +9,8 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <stdint.h>
+
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -22,6 +24,8 @@
  * @brief The main class for parsing the output to csv format.
  *
  * Calls to \ref ProcessOutput function to parse the output to csv format.
+ * Calls to \ref MeasureSegments function to get the distances between stops.
+ * Calls to \ref Checksum function to checksum the bytes of a binary file.
  */
 class Util {
  public:  // public reporter
@@ -34,6 +38,33 @@ class Util {
   * @return vector string to store the parsed output
   */
   static std::vector<std::string> ProcessOutput(const std::ostringstream &ss);
+ /**
+  * @brief Get the length and bearing of every segment of a polyline.
+  *
+  * Segment i runs from point i - 1 to point i, along the great circle.
+  * Lengths are in simulation units, a speed of 1 moving half a mile per
+  * time step, and bearings in degrees clockwise from north. Entry 0 has
+  * no segment and is 0 in both.
+  *
+  * The whole polyline is measured in one batch: the trigonometry is done
+  * once per point, the per segment arithmetic runs over plain arrays the
+  * compiler can vectorize.
+  *
+  * @param[in] latitudes, longitudes Points, in degrees
+  * @param[in] count Number of points
+  * @param[out] lengths, bearings count entries each
+  */
+  static void MeasureSegments(const double * latitudes,
+                              const double * longitudes, int count,
+                              double * lengths, double * bearings);
+ /**
+  * @brief Continue an FNV-1a checksum over some bytes.
+  *
+  * Start from kChecksumSeed, then pass the result of every call to the
+  * next one to checksum several blocks in turn.
+  */
+  static uint32_t Checksum(uint32_t hash, const void * data, uint64_t size);
+  static const uint32_t kChecksumSeed = 2166136261u;
 };
 
 #endif  // SRC_UTIL_H_
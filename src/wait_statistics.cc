@@ -0,0 +1,108 @@
+/**
+ * @file wait_statistics.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/wait_statistics.h"
+
+#include <algorithm>
+#include <string>
+
+#include "src/name_table.h"
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+WaitPercentiles::WaitPercentiles(const LatencyHistogram& histogram) :
+  count(histogram.GetCount()), mean(histogram.GetMean()),
+  p50(histogram.GetPercentile(50)), p95(histogram.GetPercentile(95)),
+  p99(histogram.GetPercentile(99)), max(histogram.GetMax()) {
+}
+
+void WaitStatistics::Attach(EventBus * events) {
+  events->Subscribe<PassengerAlightedEvent, WaitStatistics,
+                    &WaitStatistics::OnAlighted>(this);
+}
+
+void WaitStatistics::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  network_ = Histograms();
+  byRoute_.clear();
+  byStop_.clear();
+}
+
+void WaitStatistics::OnAlighted(const PassengerAlightedEvent& event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Record(event, &network_);
+  Record(event, &byRoute_[event.route_id]);
+  Record(event, &byStop_[event.stop_id]);
+}
+
+void WaitStatistics::Record(const PassengerAlightedEvent& event,
+                            Histograms * histograms) {
+  histograms->waitAtStop.Record(event.wait_at_stop);
+  histograms->ride.Record(event.time_on_bus);
+  histograms->total.Record(event.total_wait);
+}
+
+WaitSummary WaitStatistics::Summarize(WaitSummary::Scope scope, int id,
+                                      const Histograms& histograms) {
+  WaitSummary summary;
+  summary.scope = scope;
+  summary.id = id;
+  summary.waitAtStop = WaitPercentiles(histograms.waitAtStop);
+  summary.ride = WaitPercentiles(histograms.ride);
+  summary.total = WaitPercentiles(histograms.total);
+  return summary;
+}
+
+std::vector<WaitSummary> WaitStatistics::GetSummaries() const {
+  std::vector<WaitSummary> summaries;
+  std::lock_guard<std::mutex> lock(mutex_);
+  summaries.push_back(Summarize(WaitSummary::kNetwork, NameTable::kNoId,
+                                network_));
+  const std::unordered_map<int, Histograms> * scopes[2] = {
+    &byRoute_, &byStop_
+  };
+  for (int s = 0; s < 2; s++) {
+    std::vector<int> ids;
+    for (std::unordered_map<int, Histograms>::const_iterator it =
+           scopes[s]->begin();
+         it != scopes[s]->end();
+         it++) {
+      ids.push_back(it->first);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (int i = 0; i < static_cast<int>(ids.size()); i++) {
+      summaries.push_back(Summarize(
+        s == 0 ? WaitSummary::kRoute : WaitSummary::kStop, ids[i],
+        scopes[s]->at(ids[i])));
+    }
+  }
+  return summaries;
+}
+
+void WaitStatistics::WriteTable(std::ostream& out,
+                                const std::vector<WaitSummary>& summaries,
+                                const NameTable& names) {
+  static const char * const kScopes[] = {"network", "route", "stop"};
+  static const char * const kMeasures[] = {"wait_at_stop", "ride", "total"};
+  out << "scope,id,measure,count,mean,p50,p95,p99,max" << std::endl;
+  for (int i = 0; i < static_cast<int>(summaries.size()); i++) {
+    const WaitSummary& summary = summaries[i];
+    const WaitPercentiles * measures[3] = {
+      &summary.waitAtStop, &summary.ride, &summary.total
+    };
+    std::string id = summary.id == NameTable::kNoId
+                   ? "" : names.GetName(summary.id);
+    for (int m = 0; m < 3; m++) {
+      out << kScopes[summary.scope] << "," << id << "," << kMeasures[m]
+          << "," << measures[m]->count << "," << measures[m]->mean << ","
+          << measures[m]->p50 << "," << measures[m]->p95 << ","
+          << measures[m]->p99 << "," << measures[m]->max << std::endl;
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file wait_statistics.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef SRC_WAIT_STATISTICS_H_
+#define SRC_WAIT_STATISTICS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "src/event_bus.h"
+#include "src/latency_histogram.h"
+#include "src/name_table.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+// Percentiles of one kind of duration, in time steps
+struct WaitPercentiles {
+  WaitPercentiles() : count(0), mean(0), p50(0), p95(0), p99(0), max(0) {}
+  explicit WaitPercentiles(const LatencyHistogram& histogram);
+  int64_t count;
+  double mean;
+  int p50;
+  int p95;
+  int p99;
+  int max;
+};
+
+// Percentiles of the delivered passengers of the network, a route or a stop
+struct WaitSummary {
+  enum Scope { kNetwork = 0, kRoute = 1, kStop = 2 };
+  Scope scope;
+  int id;  // interned route or stop name, NameTable::kNoId for the network
+  WaitPercentiles waitAtStop;
+  WaitPercentiles ride;
+  WaitPercentiles total;  // waiting plus riding
+};
+
+/**
+ * @brief Histograms of the wait at the stop, the ride and the total time
+ * of the passengers delivered, for the network, every route and every
+ * stop they got off at.
+ *
+ * Filled from PassengerAlightedEvent on the simulation thread, its memory
+ * depends on the number of routes and stops only, not on the passengers.
+ * Summaries can be taken from any thread at any time.
+ *
+ * Calls to \ref Attach function to follow the passengers of an event bus.
+ * Calls to \ref Clear function to forget them.
+ * Calls to \ref GetSummaries function for their percentiles.
+ * Calls to \ref WriteTable function to write them as a CSV table.
+ */
+class WaitStatistics {
+ public:
+  void Attach(EventBus * events);
+  void Clear();
+ /**
+  * @brief Percentiles of the network, then of every route and every stop
+  * with a delivered passenger, each ordered by id.
+  */
+  std::vector<WaitSummary> GetSummaries() const;
+  // The route and stop ids are written as their names in names
+  static void WriteTable(std::ostream& out,
+                         const std::vector<WaitSummary>& summaries,
+                         const NameTable& names);
+
+ private:
+  struct Histograms {
+    LatencyHistogram waitAtStop;
+    LatencyHistogram ride;
+    LatencyHistogram total;
+  };
+  void OnAlighted(const PassengerAlightedEvent& event);
+  static void Record(const PassengerAlightedEvent& event,
+                     Histograms * histograms);
+  static WaitSummary Summarize(WaitSummary::Scope scope, int id,
+                               const Histograms& histograms);
+  mutable std::mutex mutex_;  // guards the histograms
+  Histograms network_;
+  std::unordered_map<int, Histograms> byRoute_;
+  std::unordered_map<int, Histograms> byStop_;
+};
+
+#endif  // SRC_WAIT_STATISTICS_H_
@@ -0,0 +1,65 @@
+/**
+ * @file batch_queue_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "../web_code/web/batch_queue.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(BatchQueueTests, PushTests) {
+  BatchQueue<vector<int> > queue;
+  vector<vector<int> > batches;
+  queue.TakeAll(&batches);
+  EXPECT_TRUE(batches.empty());
+
+  // two publishes before a read, both arrive, oldest first
+  vector<int> observed(1, 1);
+  queue.Push(&observed);
+  EXPECT_TRUE(observed.empty());
+  observed.push_back(2);
+  observed.push_back(3);
+  queue.Push(&observed);
+  queue.TakeAll(&batches);
+  ASSERT_EQ(batches.size(), 2u);
+  EXPECT_EQ(batches[0], vector<int>(1, 1));
+  ASSERT_EQ(batches[1].size(), 2u);
+  EXPECT_EQ(batches[1][1], 3);
+
+  // taken batches are gone
+  batches.clear();
+  queue.TakeAll(&batches);
+  EXPECT_TRUE(batches.empty());
+}
+
+TEST(BatchQueueTests, ThreadTests) {
+  BatchQueue<vector<int> > queue;
+  const int numBatches = 10000;
+  thread writer([&queue]() {
+    for (int i = 0; i < numBatches; i++) {
+      vector<int> batch(1, i);
+      queue.Push(&batch);
+    }
+  });
+  // every batch arrives once, in order
+  vector<vector<int> > batches;
+  while (static_cast<int>(batches.size()) < numBatches) {
+    queue.TakeAll(&batches);
+  }
+  writer.join();
+  for (int i = 0; i < numBatches; i++) {
+    ASSERT_EQ(batches[i][0], i);
+  }
+}
@@ -21,6 +21,7 @@
 #include "../src/route.h"
 #include "../src/stop.h"
 #include "../src/bus.h"
+#include "../src/name_table.h"
 
 using namespace std;
 
@@ -86,13 +87,15 @@ TEST_F(BusTests, ConstructorTests) {
   bus = new Bus("MyBus", out, in);
   // test GetBusData
   BusData bus_data = bus->GetBusData();
-  EXPECT_EQ(bus_data.id, "");
+  EXPECT_EQ(bus_data.id, -1);
   EXPECT_EQ(bus_data.num_passengers, 0);
   EXPECT_EQ(bus_data.capacity, 0);
   EXPECT_EQ(bus_data.position.x-0 < 1e-6, true);
   EXPECT_EQ(bus_data.position.y-0 < 1e-6, true);
   // test GetName
   EXPECT_EQ(bus->GetName(), "MyBus");
+  // test GetId
+  EXPECT_EQ(NameTable::GetDefault()->GetName(bus->GetId()), "MyBus");
   // test GetNextStop
   Stop * next_stop = bus->GetNextStop();
   EXPECT_EQ(next_stop, stops_out[0]);
@@ -266,3 +269,107 @@ TEST_F(BusTests, LoadPassengerTests) {
   }
   delete [] stops_in;
 }
+
+// test HasChanged
+TEST_F(BusTests, HasChangedTests) {
+  string route_name_out = "MyOutRoute";
+  int num_stops_out = 2;
+  double distances_out[1] = {0.5};
+  Stop **stops_out = new Stop*[num_stops_out];
+  for (int i=0; i < num_stops_out; i++) {
+      stops_out[i] = new Stop(i+3);
+  }
+  out = new Route
+    (route_name_out, stops_out, distances_out, num_stops_out, pass_generator);
+
+  string route_name_in = "MyInRoute";
+  int num_stops_in = 2;
+  double distances_in[1] = {0.5};
+  Stop **stops_in = new Stop*[num_stops_in];
+  for (int i=0; i < num_stops_in; i++) {
+      stops_in[i] = new Stop(i);
+  }
+  in = new Route
+    (route_name_in, stops_in, distances_in, num_stops_in, pass_generator);
+
+  bus = new Bus("MyBus", out, in);
+  EXPECT_EQ(bus->HasChanged(), false);
+  // the first update always reports the bus
+  bus->Update();
+  EXPECT_EQ(bus->HasChanged(), true);
+  while (!bus->IsTripComplete()) {
+    bus->Update();
+  }
+  // a finished bus stays where it is
+  bus->Update();
+  EXPECT_EQ(bus->HasChanged(), false);
+
+  // free memory
+  delete bus;
+  delete in;
+  delete out;
+  for (int i=0; i < num_stops_out; i++) {
+      delete stops_out[i];
+  }
+  delete [] stops_out;
+  for (int i=0; i < num_stops_in; i++) {
+      delete stops_in[i];
+  }
+  delete [] stops_in;
+}
+
+// test SetColorPolicy
+TEST_F(BusTests, ColorPolicyTests) {
+  string route_name_out = "MyOutRoute";
+  int num_stops_out = 3;
+  double distances_out[2] = {2.0, 2.0};
+  Stop **stops_out = new Stop*[num_stops_out];
+  for (int i=0; i < num_stops_out; i++) {
+      stops_out[i] = new Stop(i+3);
+  }
+  out = new Route
+    (route_name_out, stops_out, distances_out, num_stops_out, pass_generator);
+
+  string route_name_in = "MyInRoute";
+  int num_stops_in = 2;
+  double distances_in[1] = {2.0};
+  Stop **stops_in = new Stop*[num_stops_in];
+  for (int i=0; i < num_stops_in; i++) {
+      stops_in[i] = new Stop(i);
+  }
+  in = new Route
+    (route_name_in, stops_in, distances_in, num_stops_in, pass_generator);
+
+  bus = new Bus("MyBus", out, in);
+  // the default policy paints outgoing busses maroon
+  bus->Update();
+  EXPECT_EQ(bus->GetBusData().color.red, 196);
+  EXPECT_EQ(bus->GetBusData().color.green, 34);
+  EXPECT_EQ(bus->GetBusData().color.alpha, 100);
+  // the policy can be swapped at runtime
+  bus->SetColorPolicy(&GoldMaroonColorPolicy::Apply<Bus>);
+  bus->Update();
+  EXPECT_EQ(bus->GetBusData().color.red, 206);
+  EXPECT_EQ(bus->GetBusData().color.green, 163);
+  // calls through IBus reach the concrete decorator, which may decorate
+  // another decorator
+  BusColorMaroonDecorator<Bus> maroon(bus);
+  BusDefaultDecorator<BusColorMaroonDecorator<Bus> > decorator(&maroon);
+  Decorate(&decorator);
+  EXPECT_EQ(bus->GetBusData().color.red, 196);
+  EXPECT_EQ(bus->GetBusData().color.green, 34);
+  EXPECT_EQ(bus->GetBusData().color.alpha, 255);
+
+  // free memory
+  delete bus;
+  delete in;
+  delete out;
+  for (int i=0; i < num_stops_out; i++) {
+      delete stops_out[i];
+  }
+  delete [] stops_out;
+  for (int i=0; i < num_stops_in; i++) {
+      delete stops_in[i];
+  }
+  delete [] stops_in;
+}
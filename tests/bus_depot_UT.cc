@@ -0,0 +1,120 @@
+/**
+ * @file bus_depot_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <list>
+#include <string>
+
+#include "../src/bus_depot.h"
+#include "../src/random_passenger_generator.h"
+#include "../src/route.h"
+#include "../src/stop.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class BusDepotTests : public ::testing::Test {
+ protected:
+  PassengerGenerator* pass_generator;
+  Stop * stops[2];
+  double distances[1];
+  Route * route;
+  list<double> generator_probs;
+  list<Stop *> generator_stops;
+
+  virtual void SetUp() {
+    pass_generator =
+      new RandomPassengerGenerator(generator_probs, generator_stops);
+    stops[0] = new Stop(0);
+    stops[1] = new Stop(1);
+    distances[0] = 1.0;
+    route = new Route("DepotRoute", stops, distances, 2, pass_generator);
+  }
+
+  virtual void TearDown() {
+    delete route;
+    delete stops[0];
+    delete stops[1];
+    delete pass_generator;
+  }
+
+  // Generates a bus and returns its capacity, which tells its type
+  int NextCapacity(BusDepot * depot) {
+    Bus * bus = depot->Generate("DepotBus", route, route, 1);
+    int capacity = bus->GetCapacity();
+    delete bus;
+    return capacity;
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(BusDepotTests, RotationTests) {
+  BusDepot depot;
+  // strategy 3 rotates small, medium and large busses
+  depot.SetStrategy(3);
+  EXPECT_EQ(NextCapacity(&depot), 30);
+  EXPECT_EQ(NextCapacity(&depot), 60);
+  EXPECT_EQ(NextCapacity(&depot), 90);
+  EXPECT_EQ(NextCapacity(&depot), 30);
+  // strategy 4, the default, only deploys small busses
+  depot.SetStrategy(4);
+  EXPECT_EQ(NextCapacity(&depot), 30);
+  EXPECT_EQ(NextCapacity(&depot), 30);
+  // switching back carries on the rotation
+  depot.SetStrategy(3);
+  EXPECT_EQ(NextCapacity(&depot), 60);
+}
+
+TEST_F(BusDepotTests, IndependentDepotTests) {
+  BusDepot depot, depot1;
+  depot.SetStrategy(1);
+  depot1.SetStrategy(1);
+  // every depot has its own rotation
+  EXPECT_EQ(NextCapacity(&depot), 30);
+  EXPECT_EQ(NextCapacity(&depot), 60);
+  EXPECT_EQ(NextCapacity(&depot1), 30);
+  depot.SetStrategy(2);
+  EXPECT_EQ(NextCapacity(&depot), 60);
+  EXPECT_EQ(NextCapacity(&depot), 90);
+  EXPECT_EQ(NextCapacity(&depot1), 60);
+}
+
+TEST_F(BusDepotTests, RecycleTests) {
+  BusDepot depot;
+  depot.SetStrategy(1);
+  Bus * small = depot.Deploy("SmallBus", route, route, 1);
+  Bus * medium = depot.Deploy("MediumBus", route, route, 1);
+  EXPECT_EQ(depot.GetNumOwned(), 2);
+  while (!small->IsTripComplete()) {
+    small->Update();
+  }
+  depot.Retire(small);
+
+  // the next small bus is the retired one, back at the first stop
+  Bus * recycled = depot.Deploy("RecycledBus", route, route, 1);
+  EXPECT_EQ(recycled, small);
+  EXPECT_EQ(depot.GetNumOwned(), 2);
+  // under its own name and id
+  EXPECT_EQ(recycled->GetName(), "SmallBus");
+  NameTable * names = NameTable::GetDefault();
+  EXPECT_EQ(recycled->GetId(), names->Find("SmallBus"));
+  EXPECT_EQ(names->Find("RecycledBus"), NameTable::kNoId);
+  EXPECT_FALSE(recycled->IsTripComplete());
+  EXPECT_EQ(recycled->GetNextStop(), stops[0]);
+  EXPECT_EQ(recycled->GetNumPassengers(), 0u);
+
+  // no retired medium bus, so a new one is allocated
+  EXPECT_NE(depot.Deploy("MediumBus1", route, route, 1), medium);
+  EXPECT_EQ(depot.GetNumOwned(), 3);
+}
@@ -0,0 +1,228 @@
+/**
+ * @file checkpoint_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <sstream>
+#include <string>
+
+#include "../src/bus.h"
+#include "../src/checkpoint.h"
+#include "../src/passenger.h"
+#include "../src/passenger_factory.h"
+#include "../src/random_passenger_generator.h"
+#include "../src/random_streams.h"
+#include "../src/route.h"
+#include "../src/stop.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class CheckpointTests : public ::testing::Test {
+ protected:
+  string file_name = "checkpoint_UT.ckpt";
+  list<double> probs;
+  list<Stop *> generator_stops;
+  PassengerGenerator * generator;
+  Stop * stops_out[3];
+  Stop * stops_in[3];
+  Route * out;
+  Route * in;
+
+  virtual void SetUp() {
+    generator = new RandomPassengerGenerator(probs, generator_stops);
+    double distances[2] = {1.5, 2.5};
+    for (int i = 0; i < 3; i++) {
+      stops_out[i] = new Stop(i, -93.24 + i * 0.01, 44.97);
+      stops_in[i] = new Stop(3 + i, -93.22 - i * 0.01, 44.98);
+    }
+    out = new Route("Out", stops_out, distances, 3, generator);
+    in = new Route("In", stops_in, distances, 3, generator);
+  }
+
+  virtual void TearDown() {
+    delete out;
+    delete in;
+    for (int i = 0; i < 3; i++) {
+      delete stops_out[i];
+      delete stops_in[i];
+    }
+    remove(file_name.c_str());
+  }
+
+  string Report(Bus * bus) {
+    ostringstream report;
+    bus->Report(report);
+    return report.str();
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(CheckpointTests, ValuesRoundTrip) {
+  CheckpointWriter writer;
+  writer.WriteInt(-7);
+  writer.WriteDouble(2.25);
+  writer.WriteString("Coffman");
+  writer.WriteString("");
+
+  CheckpointReader reader(writer.GetData());
+  EXPECT_EQ(reader.ReadInt(), -7);
+  EXPECT_EQ(reader.ReadDouble(), 2.25);
+  EXPECT_EQ(reader.ReadString(), "Coffman");
+  EXPECT_EQ(reader.ReadString(), "");
+  EXPECT_TRUE(reader.IsOk());
+  EXPECT_TRUE(reader.AtEnd());
+
+  // Past the end every read fails the reader
+  EXPECT_EQ(reader.ReadInt(), 0);
+  EXPECT_FALSE(reader.IsOk());
+  EXPECT_EQ(reader.GetError(), "truncated checkpoint");
+}
+
+TEST_F(CheckpointTests, CountsMustFit) {
+  CheckpointWriter writer;
+  writer.WriteInt(1000000);
+  writer.WriteInt(1);
+  CheckpointReader reader(writer.GetData());
+  EXPECT_EQ(reader.ReadCount(sizeof(int)), 0);
+  EXPECT_FALSE(reader.IsOk());
+
+  CheckpointWriter fits;
+  fits.WriteInt(2);
+  fits.WriteInt(1);
+  fits.WriteInt(2);
+  CheckpointReader fitsReader(fits.GetData());
+  EXPECT_EQ(fitsReader.ReadCount(sizeof(int)), 2);
+  EXPECT_TRUE(fitsReader.IsOk());
+}
+
+TEST_F(CheckpointTests, FileIsValidated) {
+  string body = "some checkpoint body";
+  string error;
+  ASSERT_TRUE(Checkpoint::Write(file_name, body, &error)) << error;
+
+  string read;
+  ASSERT_TRUE(Checkpoint::Read(file_name, &read, &error)) << error;
+  EXPECT_EQ(read, body);
+
+  // A flipped byte of the body
+  {
+    fstream file(file_name.c_str(),
+                 ios::in | ios::out | ios::binary);
+    file.seekp(sizeof(CheckpointHeader) + 3);
+    file.put('X');
+  }
+  EXPECT_FALSE(Checkpoint::Read(file_name, &read, &error));
+  EXPECT_EQ(error, "checksum mismatch");
+
+  // A cut body
+  ASSERT_TRUE(Checkpoint::Write(file_name, body, &error)) << error;
+  {
+    ifstream in(file_name.c_str(), ios::binary);
+    string whole((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ofstream cut(file_name.c_str(), ios::binary | ios::trunc);
+    cut.write(whole.data(), whole.size() - 4);
+  }
+  EXPECT_FALSE(Checkpoint::Read(file_name, &read, &error));
+  EXPECT_EQ(error, "truncated checkpoint");
+
+  EXPECT_FALSE(Checkpoint::Read("no_such_checkpoint.ckpt", &read, &error));
+}
+
+TEST_F(CheckpointTests, StopRoundTrip) {
+  stops_out[0]->AddPassengers(new Passenger(2, "Goldy"));
+  stops_out[0]->AddPassengers(new Passenger(1, "Gopher"));
+  stops_out[0]->Update();
+  ostringstream before;
+  stops_out[0]->Report(before);
+
+  CheckpointWriter writer;
+  stops_out[0]->Save(&writer);
+  // Passengers waiting when the checkpoint is loaded are replaced
+  stops_out[0]->AddPassengers(new Passenger(2, "Late"));
+
+  CheckpointReader reader(writer.GetData());
+  EXPECT_TRUE(stops_out[0]->Load(&reader));
+  EXPECT_TRUE(reader.AtEnd());
+  ostringstream after;
+  stops_out[0]->Report(after);
+  EXPECT_EQ(after.str(), before.str());
+  EXPECT_EQ(stops_out[0]->GetStopData().num_people, 2);
+
+  // Another stop refuses it
+  CheckpointReader other(writer.GetData());
+  EXPECT_FALSE(stops_out[1]->Load(&other));
+  EXPECT_FALSE(other.IsOk());
+}
+
+TEST_F(CheckpointTests, BusRoundTrip) {
+  stops_out[1]->AddPassengers(new Passenger(2, "Goldy"));
+  Route * bus_out = out->Clone();
+  Route * bus_in = in->Clone();
+  Bus bus("1000", bus_out, bus_in, 60, 1);
+  for (int i = 0; i < 3; i++) {
+    bus.Update();
+  }
+  ASSERT_EQ(bus.GetNumPassengers(), 1u);
+
+  CheckpointWriter writer;
+  bus.Save(&writer);
+
+  Route * copy_out = out->Clone();
+  Route * copy_in = in->Clone();
+  Bus copy("1000", copy_out, copy_in, 60, 1);
+  CheckpointReader reader(writer.GetData());
+  ASSERT_TRUE(copy.Load(&reader));
+  EXPECT_TRUE(reader.AtEnd());
+  EXPECT_EQ(Report(&copy), Report(&bus));
+  EXPECT_EQ(copy.GetNextStop(), bus.GetNextStop());
+  EXPECT_EQ(copy.GetBusData().position.x, bus.GetBusData().position.x);
+  EXPECT_EQ(copy.GetBusData().position.y, bus.GetBusData().position.y);
+  EXPECT_FALSE(copy.HasChanged());
+
+  // Both go on the same way
+  for (int i = 0; i < 6; i++) {
+    bus.Update();
+    copy.Update();
+    EXPECT_EQ(Report(&copy), Report(&bus));
+    EXPECT_EQ(copy.IsTripComplete(), bus.IsTripComplete());
+  }
+
+  delete bus_out;
+  delete bus_in;
+  delete copy_out;
+  delete copy_in;
+}
+
+TEST_F(CheckpointTests, RandomStateRoundTrip) {
+  RandomStreams random(7);
+  string state = random.GetState();
+  Passenger * first = PassengerFactory::Generate(0, 10, &random);
+  ostringstream first_report;
+  first->Report(first_report);
+  double arrival = random.NextArrival(0, 0);
+
+  ASSERT_TRUE(random.SetState(state));
+  Passenger * again = PassengerFactory::Generate(0, 10, &random);
+  ostringstream again_report;
+  again->Report(again_report);
+  EXPECT_EQ(again_report.str(), first_report.str());
+  EXPECT_EQ(random.NextArrival(0, 0), arrival);
+
+  EXPECT_FALSE(random.SetState("not a state"));
+  delete first;
+  delete again;
+}
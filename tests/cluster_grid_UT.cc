@@ -0,0 +1,131 @@
+/**
+ * @file cluster_grid_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../src/cluster_grid.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class ClusterGridTests : public ::testing::Test {
+ protected:
+  ClusterGrid grid = ClusterGrid(1.0);
+  static const int kMaroon = 0x800000;
+  static const int kGold = 0xffd700;
+
+  // Tiles sorted by column then row
+  vector<ClusterTile> Tiles() {
+    vector<ClusterTile> tiles;
+    grid.GetTiles(&tiles);
+    sort(tiles.begin(), tiles.end(),
+         [](const ClusterTile& a, const ClusterTile& b) {
+           return a.column != b.column ? a.column < b.column : a.row < b.row;
+         });
+    return tiles;
+  }
+};
+
+const int ClusterGridTests::kMaroon;
+const int ClusterGridTests::kGold;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(ClusterGridTests, BusTests) {
+  grid.UpdateBus(0, 0.5, 0.5, 10, 30, kMaroon);
+  grid.UpdateBus(1, 0.2, 0.7, 5, 60, kGold);
+  grid.UpdateBus(2, 0.9, 0.1, 0, 30, kGold);
+  grid.UpdateBus(3, -0.5, 2.5, 8, 8, kMaroon);
+
+  vector<ClusterTile> tiles = Tiles();
+  ASSERT_EQ(tiles.size(), 2u);
+  EXPECT_EQ(tiles[0].column, -1);
+  EXPECT_EQ(tiles[0].row, 2);
+  EXPECT_EQ(tiles[1].column, 0);
+  EXPECT_EQ(tiles[1].row, 0);
+  EXPECT_EQ(tiles[1].num_busses, 3);
+  EXPECT_EQ(tiles[1].num_passengers, 15);
+  EXPECT_EQ(tiles[1].capacity, 120);
+  EXPECT_EQ(tiles[1].color, kGold);
+
+  // a move takes the old contribution out, an empty cell is dropped
+  grid.UpdateBus(3, 0.5, 0.5, 2, 8, kMaroon);
+  grid.UpdateBus(1, 0.2, 0.7, 6, 60, kMaroon);
+  tiles = Tiles();
+  ASSERT_EQ(tiles.size(), 1u);
+  EXPECT_EQ(tiles[0].num_busses, 4);
+  EXPECT_EQ(tiles[0].num_passengers, 18);
+  EXPECT_EQ(tiles[0].capacity, 128);
+  EXPECT_EQ(tiles[0].color, kMaroon);
+
+  grid.RemoveBus(0);
+  grid.RemoveBus(1);
+  grid.RemoveBus(3);
+  grid.RemoveBus(3);
+  tiles = Tiles();
+  ASSERT_EQ(tiles.size(), 1u);
+  EXPECT_EQ(tiles[0].num_busses, 1);
+  EXPECT_EQ(tiles[0].color, kGold);
+  grid.RemoveBus(2);
+  EXPECT_EQ(grid.GetNumCells(), 0);
+}
+
+TEST_F(ClusterGridTests, NegativeTests) {
+  // Tiles west of Greenwich, longitude first
+  ClusterGrid campus(0.01);
+  campus.UpdateBus(0, -93.235, 44.973, 3, 30, kMaroon);
+  campus.UpdateBus(1, -93.232, 44.978, 4, 30, kMaroon);
+  campus.UpdateStop(5, -93.215, 44.976, 6);
+
+  vector<ClusterTile> tiles;
+  campus.GetTiles(&tiles);
+  sort(tiles.begin(), tiles.end(),
+       [](const ClusterTile& a, const ClusterTile& b) {
+         return a.column < b.column;
+       });
+  ASSERT_EQ(tiles.size(), 2u);
+  EXPECT_EQ(tiles[0].column, -9324);
+  EXPECT_EQ(tiles[0].row, 4497);
+  EXPECT_EQ(tiles[0].num_busses, 2);
+  EXPECT_EQ(tiles[0].num_passengers, 7);
+  EXPECT_EQ(tiles[1].column, -9322);
+  EXPECT_EQ(tiles[1].num_stops, 1);
+  EXPECT_EQ(tiles[1].num_waiting, 6);
+}
+
+TEST_F(ClusterGridTests, StopTests) {
+  grid.UpdateStop(7, 3.5, 3.5, 4);
+  grid.UpdateStop(8, 3.1, 3.9, 1);
+  grid.UpdateBus(0, 3.5, 3.2, 1, 30, kGold);
+  grid.UpdateStop(7, 3.5, 3.5, 2);
+
+  vector<ClusterTile> tiles = Tiles();
+  ASSERT_EQ(tiles.size(), 1u);
+  EXPECT_EQ(tiles[0].num_stops, 2);
+  EXPECT_EQ(tiles[0].num_waiting, 3);
+  EXPECT_EQ(tiles[0].num_busses, 1);
+
+  // the cell stays while a bus is left in it
+  grid.RemoveStop(7);
+  grid.RemoveStop(8);
+  tiles = Tiles();
+  ASSERT_EQ(tiles.size(), 1u);
+  EXPECT_EQ(tiles[0].num_stops, 0);
+  EXPECT_EQ(tiles[0].num_waiting, 0);
+  EXPECT_EQ(tiles[0].color, kGold);
+
+  grid.Clear();
+  EXPECT_EQ(grid.GetNumCells(), 0);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file config_manager_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../src/config_manager.h"
+#include "../src/route.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class ConfigManagerTests : public ::testing::Test {
+ protected:
+  string file_name = "config_manager_UT.txt";
+
+  void WriteConfig(const string& contents) {
+    ofstream file(file_name.c_str());
+    file << contents;
+  }
+
+  virtual void TearDown() {
+    remove(file_name.c_str());
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(ConfigManagerTests, ReadTests) {
+  WriteConfig(
+    "Stop Name, Lat, Long, Pass Gen Prob\n"
+    "DISPATCH, 30, 2\n"
+    "ROUTE_GENERAL, Campus Connector\n"
+    "ROUTE, East Bound\n"
+    "STOP, Blegen Hall, 44.972392, -93.243774, .15\n"
+    "STOP, Coffman, 44.973580, -93.235071, .3\r\n"
+    "STOP, Blegen Hall, 44.972392, -93.243774, 0\n"
+    "ROUTE, West Bound\n"
+    "STOP, Coffman, 44.973580, -93.235071, .3\n"
+    "STOP, Blegen Hall, 44.972392, -93.243774, 0");
+  ConfigManager config;
+  config.ReadConfigFile(file_name);
+
+  vector<Route *> routes = config.GetRoutes();
+  ASSERT_EQ(routes.size(), 2u);
+  EXPECT_EQ(routes[0]->GetName(), " Campus Connector EastBound");
+  EXPECT_EQ(routes[1]->GetName(), " Campus Connector WestBound");
+
+  // a stop listed twice on a route is one stop, routes do not share stops
+  const list<Stop *>& east = routes[0]->GetStops();
+  ASSERT_EQ(east.size(), 3u);
+  EXPECT_EQ(east.front(), east.back());
+  EXPECT_EQ(east.front()->GetId(), 10);
+  EXPECT_EQ(routes[1]->GetStops().front()->GetId(), 12);
+  EXPECT_EQ(config.GetNumStops(), 4);
+
+  ASSERT_EQ(config.GetDispatchPlan().GetWindows().size(), 1u);
+  EXPECT_EQ(config.GetDispatchPlan().GetWindows()[0].start_time, 30);
+  EXPECT_EQ(config.GetDispatchPlan().GetWindows()[0].strategy, 2);
+}
+
+TEST_F(ConfigManagerTests, ErrorTests) {
+  WriteConfig(
+    "ROUTE, East Bound\n"
+    "STOP, Blegen Hall, 44.972392, -93.243774, .15\n"
+    "\n"
+    "STOP, Coffman, north, -93.235071, .3\n");
+  ConfigManager config;
+  try {
+    config.ReadConfigFile(file_name);
+    FAIL() << "the bad latitude was accepted";
+  } catch (const ConfigError& error) {
+    EXPECT_EQ(error.GetLine(), 4);
+    EXPECT_EQ(string(error.what()),
+              file_name + ":4: bad stop latitude");
+  }
+
+  ConfigManager missing;
+  EXPECT_THROW(missing.ReadConfigFile("no_such_config.txt"), ConfigError);
+}
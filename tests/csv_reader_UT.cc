@@ -0,0 +1,108 @@
+/**
+ * @file csv_reader_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../src/config_manager.h"
+#include "../src/csv_reader.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class CsvReaderTests : public ::testing::Test {
+ protected:
+  string file_name = "csv_reader_UT.txt";
+
+  void WriteFile(const string& contents) {
+    ofstream file(file_name.c_str(), ios::binary);
+    file << contents;
+  }
+
+  virtual void TearDown() {
+    remove(file_name.c_str());
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(CsvReaderTests, FieldTests) {
+  WriteFile("\xEF\xBB\xBFid, name ,value\r\n"
+            "1,\"Oak, \"\"Street\"\"\",\" 2.5\"\r\n"
+            "\r\n"
+            "2,,x\n");
+  CsvReader reader;
+  ASSERT_TRUE(reader.Open(file_name));
+  EXPECT_EQ(reader.GetColumn("id"), 0);
+  EXPECT_EQ(reader.GetColumn("name"), 1);
+  EXPECT_EQ(reader.GetColumn("missing"), -1);
+
+  vector<string> names;
+  vector<double> values;
+  reader.ForEachRow(1, [&](int, const CsvRow& row) {
+    names.push_back(row[1].ToString());
+    double value = -1;
+    if (row[2].ToDouble(&value)) values.push_back(value);
+    EXPECT_TRUE(row[7].IsEmpty());
+  });
+  // the blank line is skipped, quotes are removed and unescaped
+  EXPECT_EQ(names, vector<string>({"Oak, \"Street\"", ""}));
+  EXPECT_EQ(values, vector<double>({2.5}));
+}
+
+TEST_F(CsvReaderTests, ChunkTests) {
+  string contents = "value\n";
+  for (int i = 0; i < 1000; i++) {
+    contents += to_string(i) + "\n";
+  }
+  WriteFile(contents);
+  CsvReader reader;
+  ASSERT_TRUE(reader.Open(file_name));
+
+  // every row is visited exactly once, whatever the number of chunks
+  for (int chunks = 1; chunks <= 16; chunks *= 4) {
+    vector<vector<int> > seen(chunks);
+    reader.ForEachRow(chunks, [&](int chunk, const CsvRow& row) {
+      int value;
+      ASSERT_TRUE(row[0].ToInt(&value));
+      seen[chunk].push_back(value);
+    });
+    vector<int> all;
+    for (int i = 0; i < chunks; i++) {
+      all.insert(all.end(), seen[i].begin(), seen[i].end());
+    }
+    ASSERT_EQ(all.size(), 1000u);
+    for (int i = 0; i < 1000; i++) {
+      EXPECT_EQ(all[i], i);
+    }
+  }
+}
+
+TEST_F(CsvReaderTests, ErrorTests) {
+  WriteFile("value\n1\n2\nx\n4\n");
+  CsvReader reader;
+  ASSERT_TRUE(reader.Open(file_name));
+  try {
+    reader.ForEachRow(2, [](int, const CsvRow& row) {
+      int value;
+      if (!row[0].ToInt(&value)) throw runtime_error("bad value");
+    });
+    FAIL() << "the bad row was accepted";
+  } catch (const ConfigError& error) {
+    EXPECT_EQ(error.GetLine(), 4);
+  }
+  EXPECT_FALSE(reader.Open("no_such_file.txt"));
+}
@@ -0,0 +1,52 @@
+/**
+ * @file dispatch_plan_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include "../src/dispatch_plan.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(DispatchPlanTests, AddWindowTests) {
+  DispatchPlan plan;
+  plan.AddWindow(30, 2);
+  plan.AddWindow(0, 1);
+  plan.AddWindow(60, 3);
+  // windows are kept by start time
+  ASSERT_EQ((int)plan.GetWindows().size(), 3);
+  EXPECT_EQ(plan.GetWindows()[0].start_time, 0);
+  EXPECT_EQ(plan.GetWindows()[1].start_time, 30);
+  EXPECT_EQ(plan.GetWindows()[2].strategy, 3);
+}
+
+TEST(DispatchPlanTests, CursorTests) {
+  DispatchPlan plan;
+  plan.AddWindow(5, 1);
+  plan.AddWindow(10, 2);
+  plan.AddWindow(12, 3);
+  DispatchCursor cursor(&plan);
+  // default strategy before the first window
+  EXPECT_EQ(cursor.Advance(0), false);
+  EXPECT_EQ(cursor.GetStrategy(), DispatchPlan::kDefaultStrategy);
+  EXPECT_EQ(cursor.Advance(5), true);
+  EXPECT_EQ(cursor.GetStrategy(), 1);
+  EXPECT_EQ(cursor.Advance(9), false);
+  EXPECT_EQ(cursor.GetStrategy(), 1);
+  // skipping over a whole window lands in the latest one
+  EXPECT_EQ(cursor.Advance(20), true);
+  EXPECT_EQ(cursor.GetStrategy(), 3);
+
+  // without a plan the default strategy is used all along
+  DispatchCursor no_plan;
+  EXPECT_EQ(no_plan.Advance(100), false);
+  EXPECT_EQ(no_plan.GetStrategy(), DispatchPlan::kDefaultStrategy);
+}
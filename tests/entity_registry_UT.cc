@@ -0,0 +1,47 @@
+/**
+ * @file entity_registry_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include "../src/entity_registry.h"
+#include "../src/stop.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(EntityRegistryTests, AddRemoveTests) {
+  EntityRegistry<Stop> registry;
+  Stop stop(1), stop1(2);
+  EXPECT_EQ(registry.Find(3), (Stop *)NULL);
+  EXPECT_EQ(registry.Find(-1), (Stop *)NULL);
+
+  registry.Add(3, &stop);
+  registry.Add(10, &stop1);
+  EXPECT_EQ(registry.Find(3), &stop);
+  EXPECT_EQ(registry.Find(10), &stop1);
+  EXPECT_EQ(registry.Find(4), (Stop *)NULL);
+  EXPECT_EQ(registry.Size(), 2);
+  // the first entity of an id is kept
+  registry.Add(3, &stop1);
+  EXPECT_EQ(registry.Find(3), &stop);
+  EXPECT_EQ(registry.Size(), 2);
+
+  registry.Remove(3);
+  EXPECT_EQ(registry.Find(3), (Stop *)NULL);
+  EXPECT_EQ(registry.Size(), 1);
+  // removing an unknown id does nothing
+  registry.Remove(42);
+  EXPECT_EQ(registry.Size(), 1);
+
+  registry.Clear();
+  EXPECT_EQ(registry.Find(10), (Stop *)NULL);
+  EXPECT_EQ(registry.Size(), 0);
+}
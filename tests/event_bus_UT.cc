@@ -0,0 +1,92 @@
+/**
+ * @file event_bus_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/event_bus.h"
+
+using namespace std;
+
+// Records the ids of the events it receives
+class RecordingSubscriber {
+ public:
+  void OnBusMoved(const BusMovedEvent& event) {
+    busses.push_back(event.bus.id);
+  }
+  void OnPassengerAlighted(const PassengerAlightedEvent& event) {
+    alighted.push_back(event.bus_id);
+  }
+  vector<int> busses;
+  vector<int> alighted;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(EventBusTests, EntityFilterTests) {
+  EventBus events;
+  RecordingSubscriber watcher, everything;
+  EXPECT_FALSE(events.HasSubscribers<BusMovedEvent>());
+
+  events.Subscribe<BusMovedEvent, RecordingSubscriber,
+                   &RecordingSubscriber::OnBusMoved>(&watcher, 7);
+  events.Subscribe<BusMovedEvent, RecordingSubscriber,
+                   &RecordingSubscriber::OnBusMoved>(&everything);
+  EXPECT_TRUE(events.HasSubscribers<BusMovedEvent>());
+
+  BusData bus7, bus8;
+  bus7.id = 7;
+  bus8.id = 8;
+  events.Publish(7, BusMovedEvent(bus7));
+  events.Publish(8, BusMovedEvent(bus8));
+
+  // only the matching entity reaches the filtered subscriber
+  EXPECT_EQ(watcher.busses, vector<int>({7}));
+  EXPECT_EQ(everything.busses, vector<int>({7, 8}));
+}
+
+TEST(EventBusTests, TopicTests) {
+  EventBus events;
+  RecordingSubscriber subscriber;
+  events.Subscribe<PassengerAlightedEvent, RecordingSubscriber,
+                   &RecordingSubscriber::OnPassengerAlighted>(&subscriber);
+
+  // topics are independent of each other
+  EXPECT_FALSE(events.HasSubscribers<BusMovedEvent>());
+  EXPECT_FALSE(events.HasSubscribers<StopCountChangedEvent>());
+  BusData bus;
+  bus.id = 3;
+  events.Publish(3, BusMovedEvent(bus));
+  events.Publish(5, PassengerAlightedEvent(3, 1, 5, 4, 8));
+  EXPECT_TRUE(subscriber.busses.empty());
+  EXPECT_EQ(subscriber.alighted, vector<int>({3}));
+}
+
+TEST(EventBusTests, UnsubscribeTests) {
+  EventBus events;
+  RecordingSubscriber first, second;
+  events.Subscribe<BusMovedEvent, RecordingSubscriber,
+                   &RecordingSubscriber::OnBusMoved>(&first, 4);
+  events.Subscribe<BusMovedEvent, RecordingSubscriber,
+                   &RecordingSubscriber::OnBusMoved>(&second, 4);
+  EXPECT_TRUE(events.HasSubscribers<BusMovedEvent>(4));
+  EXPECT_FALSE(events.HasSubscribers<BusMovedEvent>(5));
+
+  events.Unsubscribe<BusMovedEvent>(&first, 4);
+  BusData bus;
+  bus.id = 4;
+  events.Publish(4, BusMovedEvent(bus));
+  EXPECT_TRUE(first.busses.empty());
+  EXPECT_EQ(second.busses, vector<int>({4}));
+
+  events.Unsubscribe<BusMovedEvent>(&second, 4);
+  EXPECT_FALSE(events.HasSubscribers<BusMovedEvent>());
+}
@@ -0,0 +1,143 @@
+/**
+ * @file gtfs_importer_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "../src/config_manager.h"
+#include "../src/gtfs_importer.h"
+#include "../src/route.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class GtfsImporterTests : public ::testing::Test {
+ protected:
+  string feed = "gtfs_importer_UT";
+  string demand = "gtfs_importer_UT_demand.txt";
+
+  void WriteFile(const string& name, const string& contents) {
+    ofstream file(name.c_str());
+    file << contents;
+  }
+
+  virtual void SetUp() {
+    mkdir(feed.c_str(), 0755);
+    WriteFile(feed + "/stops.txt",
+      "stop_id,stop_name,stop_lat,stop_lon\n"
+      "A,Blegen Hall,44.972392,-93.243774\n"
+      "B,Coffman,44.973580,-93.235071\n"
+      "C,Oak Street,44.975392,-93.226632\n"
+      "E,Entrance,,\n");
+    WriteFile(feed + "/routes.txt",
+      "route_id,route_short_name,route_long_name\n"
+      "R1,121,Campus Connector\n"
+      "R2,,Loop\n");
+    WriteFile(feed + "/trips.txt",
+      "route_id,trip_id,direction_id,trip_headsign\n"
+      "R1,T1,0,East Bound\n"
+      "R1,T2,0,East Bound\n"
+      "R1,T3,1,\n"
+      "R2,T4,0,\n");
+    // T2 is the longest eastbound trip, its stop times are out of order
+    WriteFile(feed + "/stop_times.txt",
+      "trip_id,arrival_time,departure_time,stop_id,stop_sequence\n"
+      "T1,08:00:00,08:00:00,A,1\n"
+      "T1,08:05:00,08:05:00,B,2\n"
+      "T2,09:10:00,09:10:00,C,30\n"
+      "T2,09:00:00,09:00:00,A,10\n"
+      "T2,09:05:00,09:05:00,B,20\n"
+      "T3,10:00:00,10:00:00,C,1\n"
+      "T3,10:10:00,10:10:00,A,2\n"
+      "T4,11:00:00,11:00:00,B,1\n"
+      "T4,11:05:00,11:05:00,C,2\n");
+    WriteFile(demand, "stop_id,demand\nA,1\nB,0.25\n");
+  }
+
+  virtual void TearDown() {
+    remove((feed + "/stops.txt").c_str());
+    remove((feed + "/routes.txt").c_str());
+    remove((feed + "/trips.txt").c_str());
+    remove((feed + "/stop_times.txt").c_str());
+    rmdir(feed.c_str());
+    remove(demand.c_str());
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(GtfsImporterTests, ImportTests) {
+  NetworkTables tables;
+  GtfsImporter(1).Import(feed, demand, &tables);
+
+  // an outbound and an inbound route per GTFS route
+  ASSERT_EQ(tables.routes.size(), 4u);
+  const NetworkRouteRecord& east = tables.routes[0];
+  EXPECT_EQ(tables.names.substr(east.name_offset, east.name_length),
+            "121 EastBound");
+  const NetworkRouteRecord& loop = tables.routes[3];
+  EXPECT_EQ(tables.names.substr(loop.name_offset, loop.name_length),
+            "Loop Inbound");
+
+  // the longest trip, in stop_sequence order, with stops of its own
+  ASSERT_EQ(east.num_stops, 3u);
+  EXPECT_EQ(tables.stops[tables.route_stops[0]].latitude, 44.972392);
+  EXPECT_EQ(tables.stops[tables.route_stops[2]].latitude, 44.975392);
+  EXPECT_EQ(tables.stops[tables.route_stops[0]].id, 10);
+  EXPECT_EQ(tables.distances[0], 0);
+  EXPECT_GT(tables.distances[1], 0);
+
+  // demand d becomes the probability d / (1 + d)
+  EXPECT_DOUBLE_EQ(tables.probabilities[0], 0.5);
+  EXPECT_DOUBLE_EQ(tables.probabilities[1], 0.2);
+  EXPECT_DOUBLE_EQ(tables.probabilities[2], 0);
+
+  // a route with one direction comes back the same way
+  EXPECT_EQ(tables.stops[tables.route_stops[loop.first_stop]].latitude,
+            44.975392);
+}
+
+TEST_F(GtfsImporterTests, ThreadTests) {
+  NetworkTables serial, parallel;
+  GtfsImporter(1).Import(feed, demand, &serial);
+  GtfsImporter(4).Import(feed, demand, &parallel);
+  EXPECT_EQ(serial.names, parallel.names);
+  EXPECT_EQ(serial.route_stops, parallel.route_stops);
+  EXPECT_EQ(serial.distances, parallel.distances);
+  EXPECT_EQ(serial.probabilities, parallel.probabilities);
+}
+
+TEST_F(GtfsImporterTests, ConfigManagerTests) {
+  ConfigManager config;
+  config.ReadGtfs(feed, demand, 2);
+  ASSERT_EQ(config.GetRoutes().size(), 4u);
+  EXPECT_EQ(config.GetRoutes()[1]->GetName(), "121 Inbound");
+  EXPECT_EQ(config.GetNumStops(), 9);
+}
+
+TEST_F(GtfsImporterTests, ErrorTests) {
+  WriteFile(demand, "stop_id,demand\nA,1\nZ,2\n");
+  NetworkTables tables;
+  try {
+    GtfsImporter(2).Import(feed, demand, &tables);
+    FAIL() << "the unknown stop was accepted";
+  } catch (const ConfigError& error) {
+    EXPECT_EQ(string(error.what()), demand + ":3: unknown stop_id Z");
+  }
+  EXPECT_THROW(GtfsImporter(2).Import("no_such_feed", demand, &tables),
+               ConfigError);
+}
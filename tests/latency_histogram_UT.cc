@@ -0,0 +1,68 @@
+/**
+ * @file latency_histogram_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include "../src/latency_histogram.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(LatencyHistogramTests, SmallDurationsAreExact) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetPercentile(50), 0);
+  for (int i = 1; i <= 20; i++) {
+    histogram.Record(i);
+  }
+  EXPECT_EQ(histogram.GetCount(), 20);
+  EXPECT_DOUBLE_EQ(histogram.GetMean(), 10.5);
+  EXPECT_EQ(histogram.GetPercentile(0), 1);
+  EXPECT_EQ(histogram.GetPercentile(50), 10);
+  EXPECT_EQ(histogram.GetPercentile(95), 19);
+  EXPECT_EQ(histogram.GetPercentile(100), 20);
+  EXPECT_EQ(histogram.GetMax(), 20);
+}
+
+TEST(LatencyHistogramTests, LargeDurationsWithinBucket) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 100000; i++) {
+    histogram.Record(i);
+  }
+  // Every percentile is within a sixteenth of the exact duration
+  double percents[4] = {50, 90, 99, 99.9};
+  for (int i = 0; i < 4; i++) {
+    double exact = percents[i] * 1000;
+    EXPECT_GE(histogram.GetPercentile(percents[i]), exact);
+    EXPECT_LE(histogram.GetPercentile(percents[i]), exact * 17 / 16);
+  }
+  EXPECT_EQ(histogram.GetPercentile(100), 100000);
+
+  // Past the largest duration tracked, durations count as the largest
+  histogram.Record(LatencyHistogram::kMaxValue + 5);
+  EXPECT_EQ(histogram.GetMax(), LatencyHistogram::kMaxValue);
+}
+
+TEST(LatencyHistogramTests, MergeAddsCounts) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (int i = 0; i < 10; i++) {
+    first.Record(2);
+    second.Record(40);
+  }
+  first.Merge(second);
+  EXPECT_EQ(first.GetCount(), 20);
+  EXPECT_EQ(first.GetPercentile(50), 2);
+  EXPECT_EQ(first.GetMax(), 40);
+  EXPECT_GE(first.GetPercentile(99), 40);
+  first.Clear();
+  EXPECT_EQ(first.GetCount(), 0);
+  EXPECT_EQ(first.GetMax(), 0);
+}
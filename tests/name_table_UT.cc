@@ -0,0 +1,52 @@
+/**
+ * @file name_table_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../src/name_table.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(NameTableTests, InternTests) {
+  NameTable names;
+  int id = names.Intern("NameTableBus");
+  int id1 = names.Intern("NameTableStop");
+  // the same name always gets the same id
+  EXPECT_EQ(names.Intern("NameTableBus"), id);
+  EXPECT_NE(id, id1);
+  // test GetName
+  EXPECT_EQ(names.GetName(id), "NameTableBus");
+  EXPECT_EQ(names.GetName(id1), "NameTableStop");
+  EXPECT_EQ(names.GetName(-1), "");
+}
+
+TEST(NameTableTests, FindTests) {
+  NameTable names;
+  int id = names.Intern("NameTableRoute");
+  EXPECT_EQ(names.Find("NameTableRoute"), id);
+  // Find never adds a name
+  EXPECT_EQ(names.Find("NameTableMissing"), NameTable::kNoId);
+  EXPECT_EQ(names.Find("NameTableMissing"), NameTable::kNoId);
+}
+
+TEST(NameTableTests, IndependentTests) {
+  NameTable names;
+  NameTable names1;
+  int id = names.Intern("NameTableBus");
+  // a name interned in one table is not in the other
+  EXPECT_EQ(names1.Find("NameTableBus"), NameTable::kNoId);
+  EXPECT_EQ(names1.Intern("NameTableStop"), id);
+  EXPECT_EQ(names.GetName(id), "NameTableBus");
+  EXPECT_EQ(names1.GetName(id), "NameTableStop");
+}
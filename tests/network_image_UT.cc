@@ -0,0 +1,182 @@
+/**
+ * @file network_image_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../src/config_manager.h"
+#include "../src/network_image.h"
+#include "../src/route.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class NetworkImageTests : public ::testing::Test {
+ protected:
+  string config_name = "network_image_UT.txt";
+  string image_name = "network_image_UT.bin";
+
+  virtual void SetUp() {
+    ofstream file(config_name.c_str());
+    file << "DISPATCH, 0, 3\n"
+         << "ROUTE_GENERAL, Campus Connector\n"
+         << "ROUTE, East Bound\n"
+         << "STOP, Blegen Hall, 44.972392, -93.243774, .15\n"
+         << "STOP, Coffman, 44.973580, -93.235071, .3\n"
+         << "STOP, Oak Street, 44.975392, -93.226632, 0\n"
+         << "ROUTE, West Bound\n"
+         << "STOP, Oak Street, 44.975392, -93.226632, .2\n"
+         << "STOP, Coffman, 44.973580, -93.235071, 0\n";
+  }
+
+  virtual void TearDown() {
+    remove(config_name.c_str());
+    remove(image_name.c_str());
+  }
+
+  // Flip one byte of the image
+  void Corrupt(long offset) {
+    fstream file(image_name.c_str(),
+                 ios::in | ios::out | ios::binary);
+    file.seekg(offset);
+    char byte = file.get();
+    file.seekp(offset);
+    file.put(static_cast<char>(byte ^ 0x5a));
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(NetworkImageTests, RoundTripTests) {
+  ConfigManager text;
+  text.ReadConfigFile(config_name);
+  text.WriteNetwork(image_name);
+
+  ConfigManager image;
+  image.ReadNetwork(image_name);
+
+  vector<Route *> expected = text.GetRoutes();
+  vector<Route *> routes = image.GetRoutes();
+  ASSERT_EQ(routes.size(), expected.size());
+  EXPECT_EQ(image.GetNumStops(), text.GetNumStops());
+  for (int i = 0; i < static_cast<int>(routes.size()); i++) {
+    EXPECT_EQ(routes[i]->GetName(), expected[i]->GetName());
+    EXPECT_EQ(routes[i]->GetTotalRouteDistance(),
+              expected[i]->GetTotalRouteDistance());
+    ASSERT_EQ(routes[i]->GetStops().size(), expected[i]->GetStops().size());
+    // walk both routes, stop by stop
+    while (!expected[i]->IsAtEnd()) {
+      EXPECT_EQ(routes[i]->GetDestinationStop()->GetId(),
+                expected[i]->GetDestinationStop()->GetId());
+      EXPECT_DOUBLE_EQ(routes[i]->GetNextStopDistance(),
+                       expected[i]->GetNextStopDistance());
+      EXPECT_DOUBLE_EQ(routes[i]->GetNextStopBearing(),
+                       expected[i]->GetNextStopBearing());
+      routes[i]->ToNextStop();
+      expected[i]->ToNextStop();
+    }
+  }
+  ASSERT_EQ(image.GetDispatchPlan().GetWindows().size(), 1u);
+  EXPECT_EQ(image.GetDispatchPlan().GetWindows()[0].strategy, 3);
+}
+
+TEST_F(NetworkImageTests, ValidationTests) {
+  ConfigManager text;
+  text.ReadConfigFile(config_name);
+  text.WriteNetwork(image_name);
+
+  // a flipped byte in the body fails the checksum
+  Corrupt(sizeof(NetworkHeader) + 3);
+  ConfigManager corrupted;
+  try {
+    corrupted.ReadNetwork(image_name);
+    FAIL() << "the corrupted image was accepted";
+  } catch (const ConfigError& error) {
+    EXPECT_EQ(string(error.what()), image_name + ":0: checksum mismatch");
+  }
+
+  // so does an image of another version
+  text.WriteNetwork(image_name);
+  Corrupt(8);
+  ConfigManager old;
+  EXPECT_THROW(old.ReadNetwork(image_name), ConfigError);
+
+  // a text config is not an image
+  ConfigManager wrong;
+  EXPECT_THROW(wrong.ReadNetwork(config_name), ConfigError);
+}
+
+TEST_F(NetworkImageTests, TablesTests) {
+  ConfigManager text;
+  text.ReadConfigFile(config_name);
+  text.WriteNetwork(image_name);
+  ConfigManager image;
+  image.ReadNetwork(image_name);
+
+  // Both give the tables they were built from, windows included
+  NetworkTables tables = text.GetNetwork();
+  NetworkTables mapped = image.GetNetwork();
+  EXPECT_EQ(mapped.names, tables.names);
+  EXPECT_EQ(mapped.route_stops, tables.route_stops);
+  EXPECT_EQ(mapped.probabilities, tables.probabilities);
+  ASSERT_EQ(mapped.windows.size(), 1u);
+  EXPECT_EQ(mapped.windows[0].strategy, 3);
+
+  // A network built from them is the same network
+  ConfigManager copy;
+  copy.ReadTables(mapped);
+  vector<Route *> expected = text.GetRoutes();
+  vector<Route *> routes = copy.GetRoutes();
+  ASSERT_EQ(routes.size(), expected.size());
+  for (int i = 0; i < static_cast<int>(routes.size()); i++) {
+    EXPECT_EQ(routes[i]->GetName(), expected[i]->GetName());
+    EXPECT_EQ(routes[i]->GetTotalRouteDistance(),
+              expected[i]->GetTotalRouteDistance());
+  }
+  ASSERT_EQ(copy.GetDispatchPlan().GetWindows().size(), 1u);
+  EXPECT_EQ(copy.GetNetwork().windows.size(), 1u);
+  EXPECT_THROW(copy.ReadTables(mapped), ConfigError);
+}
+
+TEST_F(NetworkImageTests, ReplaceTests) {
+  ConfigManager text;
+  text.ReadConfigFile(config_name);
+  NetworkTables tables = text.GetNetwork();
+  string error;
+  ASSERT_TRUE(NetworkImage::Write(image_name, tables, &error));
+  NetworkImage mapped;
+  ASSERT_TRUE(mapped.Open(image_name, &error));
+
+  // an image written over a mapped one leaves the mapping whole
+  NetworkTables changed = tables;
+  changed.probabilities.assign(changed.probabilities.size(), 0.5);
+  ASSERT_TRUE(NetworkImage::Write(image_name, changed, &error));
+  EXPECT_FALSE(ifstream((image_name + ".partial").c_str()).good());
+  NetworkTables before;
+  before.Assign(mapped.GetView());
+  EXPECT_EQ(before.probabilities, tables.probabilities);
+
+  NetworkImage replaced;
+  ASSERT_TRUE(replaced.Open(image_name, &error));
+  NetworkTables after;
+  after.Assign(replaced.GetView());
+  EXPECT_EQ(after.probabilities, changed.probabilities);
+
+  // a file that cannot be written fails the write
+  EXPECT_FALSE(NetworkImage::Write("no_such_dir/" + image_name, changed,
+                                   &error));
+  EXPECT_EQ(error, "cannot write the image");
+}
@@ -0,0 +1,172 @@
+/**
+ * @file random_streams_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/random_passenger_generator.h"
+#include "../src/random_streams.h"
+#include "../src/stop.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(RandomStreamsTests, SeedRepeats) {
+  RandomStreams first(42);
+  RandomStreams second(42);
+  RandomStreams other(43);
+  bool differs = false;
+  for (int i = 0; i < 100; i++) {
+    double arrival = first.NextArrival(0, 0);
+    int passenger = first.NextPassenger();
+    EXPECT_GE(arrival, 0.0);
+    EXPECT_LT(arrival, 1.0);
+    EXPECT_GE(passenger, 1);
+    EXPECT_LE(passenger, 1000);
+    EXPECT_EQ(second.NextArrival(0, 0), arrival);
+    EXPECT_EQ(second.NextPassenger(), passenger);
+    differs = differs || other.NextArrival(0, 0) != arrival;
+  }
+  EXPECT_TRUE(differs);
+
+  // Seeding again starts over
+  first.Seed(42);
+  RandomStreams fresh(42);
+  EXPECT_EQ(first.NextArrival(0, 0), fresh.NextArrival(0, 0));
+  EXPECT_EQ(first.NextPassenger(), fresh.NextPassenger());
+}
+
+TEST(RandomStreamsTests, NetworksDrawApart) {
+  // Two copies of a route, each with streams of its own
+  Stop * stops_a[3];
+  Stop * stops_b[3];
+  for (int i = 0; i < 3; i++) {
+    stops_a[i] = new Stop(i);
+    stops_b[i] = new Stop(i);
+  }
+  list<double> probs = {0.9, 0.9, 0.0};
+  RandomStreams random_a(5);
+  RandomStreams random_b(5);
+  RandomPassengerGenerator generator_a(probs,
+    list<Stop *>(stops_a, stops_a + 3), &random_a);
+  RandomPassengerGenerator generator_b(probs,
+    list<Stop *>(stops_b, stops_b + 3), &random_b);
+
+  // Draws of one network leave the other alone
+  random_b.NextArrival(0, 0);
+  random_b.Seed(5);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(generator_a.GeneratePassengers(),
+              generator_b.GeneratePassengers());
+  }
+  for (int i = 0; i < 3; i++) {
+    ostringstream report_a;
+    ostringstream report_b;
+    stops_a[i]->Report(report_a);
+    stops_b[i]->Report(report_b);
+    EXPECT_EQ(report_a.str(), report_b.str());
+    stops_a[i]->ClearPassengers();
+    stops_b[i]->ClearPassengers();
+    delete stops_a[i];
+    delete stops_b[i];
+  }
+}
+
+TEST(RandomStreamsTests, CommonArrivalsFollowDemand) {
+  // The same stop with two demands, arrivals of the same seed are shared
+  Stop * stops_low[2] = {new Stop(0), new Stop(1)};
+  Stop * stops_high[2] = {new Stop(0), new Stop(1)};
+  list<double> probs_low = {0.3, 0.0};
+  list<double> probs_high = {0.6, 0.0};
+  RandomStreams random_low(11);
+  RandomStreams random_high(11);
+  random_low.SetArrivalMode(RandomStreams::kCommon);
+  random_high.SetArrivalMode(RandomStreams::kCommon);
+  RandomPassengerGenerator generator_low(probs_low,
+    list<Stop *>(stops_low, stops_low + 2), &random_low);
+  RandomPassengerGenerator generator_high(probs_high,
+    list<Stop *>(stops_high, stops_high + 2), &random_high);
+
+  // Every passenger of the low demand also arrives with the high one
+  int low = 0;
+  int high = 0;
+  for (int i = 0; i < 200; i++) {
+    int added_low = generator_low.GeneratePassengers();
+    int added_high = generator_high.GeneratePassengers();
+    EXPECT_LE(added_low, added_high);
+    low += added_low;
+    high += added_high;
+  }
+  EXPECT_GT(low, 0);
+  EXPECT_GT(high, low);
+  for (int i = 0; i < 2; i++) {
+    stops_low[i]->ClearPassengers();
+    stops_high[i]->ClearPassengers();
+    delete stops_low[i];
+    delete stops_high[i];
+  }
+}
+
+TEST(RandomStreamsTests, AntitheticMirrors) {
+  RandomStreams::ArrivalMode modes[3] = {RandomStreams::kSequential,
+    RandomStreams::kCommon, RandomStreams::kSobol};
+  for (int m = 0; m < 3; m++) {
+    RandomStreams plain(3);
+    RandomStreams mirror(3);
+    plain.SetArrivalMode(modes[m]);
+    mirror.SetArrivalMode(modes[m], true);
+    EXPECT_TRUE(mirror.IsAntithetic());
+    for (int i = 0; i < 50; i++) {
+      double arrival = plain.NextArrival(i % 5, i % 3);
+      double mirrored = mirror.NextArrival(i % 5, i % 3);
+      EXPECT_GE(mirrored, 0.0);
+      EXPECT_LT(mirrored, 1.0);
+      EXPECT_NEAR(arrival + mirrored, 1.0, 1e-6);
+    }
+  }
+}
+
+TEST(RandomStreamsTests, SobolStratifies) {
+  RandomStreams random(9);
+  random.SetArrivalMode(RandomStreams::kSobol);
+  // Every 2^k steps of an attempt put one draw in each of 2^k intervals
+  vector<int> hits(64, 0);
+  for (int step = 0; step < 64; step++) {
+    double arrival = random.NextArrival(4, 0);
+    EXPECT_EQ(random.NextArrival(4, 1) == arrival, false);
+    hits[static_cast<int>(arrival * 64)]++;
+  }
+  for (int i = 0; i < 64; i++) {
+    EXPECT_EQ(hits[i], 1);
+  }
+}
+
+TEST(RandomStreamsTests, StateKeepsMode) {
+  RandomStreams random(21);
+  random.SetArrivalMode(RandomStreams::kCommon, true);
+  random.NextArrival(2, 0);
+  random.NextArrival(7, 0);
+  string state = random.GetState();
+  double arrival = random.NextArrival(7, 0);
+  int passenger = random.NextPassenger();
+
+  RandomStreams restored(1);
+  ASSERT_TRUE(restored.SetState(state));
+  EXPECT_EQ(restored.GetArrivalMode(), RandomStreams::kCommon);
+  EXPECT_TRUE(restored.IsAntithetic());
+  EXPECT_EQ(restored.NextArrival(7, 0), arrival);
+  EXPECT_EQ(restored.NextPassenger(), passenger);
+  EXPECT_FALSE(restored.SetState("2 1 5"));
+}
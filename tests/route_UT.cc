@@ -20,6 +20,7 @@
 #include "../src/passenger.h"
 #include "../src/stop.h"
 #include <../src/route.h>
+#include "../src/name_table.h"
 
 using namespace std;
 
@@ -141,3 +142,72 @@ TEST_F(RouteTests, IsAtEndTests) {
   delete [] stops;
 }
 
+
+// test GetNextStopBearing
+TEST_F(RouteTests, BearingTests) {
+  string route_name = "MyRoute";
+  int num_stops = 3;
+  double distances[2] = {1.5, 2.5};
+  double bearings[2] = {90, 270};
+  Stop **stops = new Stop*[num_stops];
+  for (int i=0; i<num_stops; i++) {
+      stops[i] = new Stop(i);
+  }
+  route = new Route(route_name, stops, distances, num_stops, pass_generator,
+                    bearings);
+  EXPECT_EQ(route->GetNextStopBearing(), 0);
+  route->ToNextStop();
+  EXPECT_EQ(route->GetNextStopDistance(), 1.5);
+  EXPECT_EQ(route->GetNextStopBearing(), 90);
+  // clones keep the bearings
+  Route * clone = route->Clone();
+  clone->ToNextStop();
+  clone->ToNextStop();
+  EXPECT_EQ(clone->GetNextStopDistance(), 2.5);
+  EXPECT_EQ(clone->GetNextStopBearing(), 270);
+  clone->ToNextStop();
+  EXPECT_EQ(clone->GetNextStopDistance(), 0);
+  delete clone;
+  for (int i=0; i<num_stops; i++) {
+      delete stops[i];
+  }
+  delete [] stops;
+}
+
+// test UpdateRouteData
+TEST_F(RouteTests, UpdateRouteDataTests) {
+  // supposing 3 stops there
+  string route_name = "MyRoute";
+  int num_stops = 3;
+  double distances[2] = {5.0, 10.0};
+  Stop **stops = NULL;
+  stops = new Stop*[num_stops];
+  for (int i=0; i<num_stops; i++) {
+      stops[i] = new Stop(i);
+  }
+  route = new Route(route_name, stops, distances, num_stops, pass_generator);
+  // static data is shared with the stops
+  route->UpdateRouteData();
+  const RouteData& route_data = route->GetRouteData();
+  EXPECT_EQ(NameTable::GetDefault()->GetName(route_data.id), route_name);
+  EXPECT_EQ((int)route_data.stops.size(), num_stops);
+  EXPECT_EQ(route_data.stops[1], &stops[1]->GetStopData());
+  EXPECT_EQ(NameTable::GetDefault()->GetName(route_data.stops[1]->id), "1");
+  // only the stop whose count changed is flagged
+  Passenger passenger;
+  stops[1]->AddPassengers(&passenger);
+  route->UpdateRouteData();
+  EXPECT_EQ(route_data.num_people[0], 0);
+  EXPECT_EQ(route_data.num_people[1], 1);
+  EXPECT_EQ(route_data.dirty[0], false);
+  EXPECT_EQ(route_data.dirty[1], true);
+  EXPECT_EQ(route->HasChanged(), true);
+  route->UpdateRouteData();
+  EXPECT_EQ(route_data.dirty[1], false);
+  EXPECT_EQ(route->HasChanged(), false);
+  // free memory
+  for (int i=0; i<num_stops; i++) {
+      delete stops[i];
+  }
+  delete [] stops;
+}
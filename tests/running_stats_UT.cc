@@ -0,0 +1,56 @@
+/**
+ * @file running_stats_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "../src/running_stats.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(RunningStatsTests, MeanAndVariance) {
+  RunningStats stats;
+  EXPECT_EQ(stats.GetCount(), 0);
+  EXPECT_EQ(stats.GetHalfWidth(), 0);
+
+  stats.Add(4);
+  EXPECT_EQ(stats.GetMean(), 4);
+  EXPECT_EQ(stats.GetVariance(), 0);
+  EXPECT_EQ(stats.GetHalfWidth(), 0);
+
+  double samples[7] = {7, 13, 16, 2, 4, 9, 1};
+  for (int i = 0; i < 7; i++) {
+    stats.Add(samples[i]);
+  }
+  EXPECT_EQ(stats.GetCount(), 8);
+  EXPECT_DOUBLE_EQ(stats.GetMean(), 7);
+  // (9 + 0 + 36 + 81 + 25 + 9 + 4 + 36) / 7
+  EXPECT_DOUBLE_EQ(stats.GetVariance(), 200.0 / 7);
+  EXPECT_NEAR(stats.GetHalfWidth(), 2.365 * sqrt(200.0 / 7 / 8), 1e-9);
+}
+
+TEST(RunningStatsTests, HalfWidthNarrows) {
+  RunningStats two;
+  two.Add(1);
+  two.Add(3);
+  EXPECT_NEAR(two.GetHalfWidth(), 12.706, 1e-9);
+
+  // Past the table the quantile goes on towards the normal one
+  RunningStats many;
+  for (int i = 0; i < 41; i++) {
+    many.Add(i % 2);
+  }
+  double t = many.GetHalfWidth() / sqrt(many.GetVariance() / 41);
+  EXPECT_NEAR(t, 2.021, 0.001);
+  EXPECT_LT(many.GetHalfWidth(), two.GetHalfWidth());
+}
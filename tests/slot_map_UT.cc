@@ -0,0 +1,56 @@
+/**
+ * @file slot_map_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include "../src/slot_map.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(SlotMapTests, SwapRemoveTests) {
+  SlotMap<int> map;
+  SlotHandle first = map.Insert(1);
+  SlotHandle second = map.Insert(2);
+  SlotHandle third = map.Insert(3);
+  EXPECT_EQ(map.Size(), 3);
+
+  // the last value moves into the hole, its handle still resolves
+  EXPECT_TRUE(map.Remove(first));
+  EXPECT_EQ(map.Size(), 2);
+  EXPECT_EQ(map[0], 3);
+  EXPECT_EQ(map[1], 2);
+  EXPECT_EQ(*map.Get(third), 3);
+  EXPECT_EQ(*map.Get(second), 2);
+  EXPECT_EQ(map.Get(first), (int *)NULL);
+  EXPECT_FALSE(map.Remove(first));
+
+  map.RemoveAt(1);
+  EXPECT_EQ(map.Size(), 1);
+  EXPECT_FALSE(map.Contains(second));
+  EXPECT_TRUE(map.Contains(map.HandleAt(0)));
+}
+
+TEST(SlotMapTests, StaleHandleTests) {
+  SlotMap<int> map;
+  SlotHandle old = map.Insert(1);
+  map.Remove(old);
+  // the slot is reused, but the old handle stays stale
+  SlotHandle reused = map.Insert(2);
+  EXPECT_EQ(reused.slot, old.slot);
+  EXPECT_FALSE(map.Contains(old));
+  EXPECT_EQ(*map.Get(reused), 2);
+  EXPECT_FALSE(map.Contains(SlotHandle()));
+
+  map.Clear();
+  EXPECT_EQ(map.Size(), 0);
+  EXPECT_FALSE(map.Contains(reused));
+}
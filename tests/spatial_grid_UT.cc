@@ -0,0 +1,113 @@
+/**
+ * @file spatial_grid_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../src/spatial_grid.h"
+
+using namespace std;
+
+/******************************************************
+* TEST FEATURE SetUp
+*******************************************************/
+class SpatialGridTests : public ::testing::Test {
+ protected:
+  SpatialGrid grid = SpatialGrid(1.0);
+
+  vector<int> Query(double min_x, double min_y, double max_x, double max_y) {
+    vector<int> ids;
+    grid.Query(BoundingBox(min_x, min_y, max_x, max_y), &ids);
+    sort(ids.begin(), ids.end());
+    return ids;
+  }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(SpatialGridTests, QueryTests) {
+  grid.Update(0, 0.5, 0.5);
+  grid.Update(1, 1.5, 0.5);
+  grid.Update(2, -3.2, -7.9);
+  grid.Update(5, 10, 10);
+  EXPECT_EQ(grid.Size(), 4);
+  EXPECT_TRUE(grid.Contains(5));
+  EXPECT_FALSE(grid.Contains(3));
+
+  EXPECT_EQ(Query(0, 0, 1, 1), vector<int>({0}));
+  // only the positions inside the box, not the whole border cells
+  EXPECT_EQ(Query(0.6, 0, 1.6, 1), vector<int>({1}));
+  EXPECT_EQ(Query(-4, -8, 2, 1), vector<int>({0, 1, 2}));
+  // a box larger than the occupied area walks the occupied cells
+  EXPECT_EQ(Query(-1000, -1000, 1000, 1000), vector<int>({0, 1, 2, 5}));
+  EXPECT_EQ(Query(2, 2, 1, 1), vector<int>());
+}
+
+TEST_F(SpatialGridTests, MoveTests) {
+  for (int i = 0; i < 10; i++) {
+    grid.Update(i, 0.5, 0.5);
+  }
+  // within the cell, then across cells
+  grid.Update(3, 0.9, 0.9);
+  EXPECT_EQ(Query(0.8, 0.8, 1, 1), vector<int>({3}));
+  grid.Update(3, 4.5, 0.5);
+  grid.Update(9, 4.6, 0.5);
+  EXPECT_EQ(Query(4, 0, 5, 1), vector<int>({3, 9}));
+  EXPECT_EQ(Query(0, 0, 1, 1), vector<int>({0, 1, 2, 4, 5, 6, 7, 8}));
+
+  grid.Remove(0);
+  grid.Remove(8);
+  grid.Remove(8);
+  EXPECT_EQ(grid.Size(), 8);
+  EXPECT_EQ(Query(0, 0, 1, 1), vector<int>({1, 2, 4, 5, 6, 7}));
+  grid.Update(0, 0.1, 0.1);
+  EXPECT_EQ(Query(0, 0, 1, 1), vector<int>({0, 1, 2, 4, 5, 6, 7}));
+
+  grid.Clear();
+  EXPECT_EQ(grid.Size(), 0);
+  EXPECT_EQ(Query(-10, -10, 10, 10), vector<int>());
+}
+
+TEST_F(SpatialGridTests, ExpandTests) {
+  BoundingBox box = BoundingBox(0, 10, 4, 12).Expand(0.25);
+  EXPECT_EQ(box.min_x, -1);
+  EXPECT_EQ(box.max_x, 5);
+  EXPECT_EQ(box.min_y, 9.5);
+  EXPECT_EQ(box.max_y, 12.5);
+  EXPECT_TRUE(box.Contains(4.5, 12.5));
+  EXPECT_FALSE(box.Contains(4.5, 12.6));
+}
+
+TEST(SpatialGridKeyTests, NegativeCellTests) {
+  // West of Greenwich and south of the equator, columns and rows go negative
+  int64_t columns[4] = {-9322, -1, 0, 2147483647};
+  int64_t rows[4] = {4497, -2147483647 - 1, -3, 0};
+  for (int i = 0; i < 4; i++) {
+    int64_t key = SpatialGrid::CellKey(columns[i], rows[i]);
+    EXPECT_EQ(SpatialGrid::CellColumn(key), columns[i]);
+    EXPECT_EQ(SpatialGrid::CellRow(key), rows[i]);
+  }
+  EXPECT_NE(SpatialGrid::CellKey(-1, 0), SpatialGrid::CellKey(0, -1));
+
+  // Positions around campus, longitude first
+  SpatialGrid grid(0.01);
+  grid.Update(0, -93.235, 44.973);
+  grid.Update(1, -93.215, 44.976);
+  grid.Update(2, 93.215, -44.976);
+  vector<int> ids;
+  grid.Query(BoundingBox(-93.24, 44.97, -93.23, 44.98), &ids);
+  EXPECT_EQ(ids, vector<int>({0}));
+  ids.clear();
+  grid.Query(BoundingBox(-93.3, 44.9, -93.2, 45), &ids);
+  sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids, vector<int>({0, 1}));
+}
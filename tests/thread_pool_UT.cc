@@ -0,0 +1,57 @@
+/**
+ * @file thread_pool_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "../src/thread_pool.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ThreadPoolTests, RunsEveryTask) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.GetNumThreads(), 4);
+  vector<int> results(100, 0);
+  for (int i = 0; i < 100; i++) {
+    pool.Submit([&results, i]() { results[i] = i * i; });
+  }
+  pool.Wait();
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(results[i], i * i);
+  }
+
+  // The pool is reused after a wait
+  atomic<int> count(0);
+  for (int i = 0; i < 10; i++) {
+    pool.Submit([&count]() { count++; });
+  }
+  pool.Wait();
+  EXPECT_EQ(count, 10);
+}
+
+TEST(ThreadPoolTests, DrainsOnDestruction) {
+  atomic<int> count(0);
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 50; i++) {
+      pool.Submit([&count]() { count++; });
+    }
+  }
+  EXPECT_EQ(count, 50);
+
+  // A pool with no task waits for nothing
+  ThreadPool idle;
+  EXPECT_GE(idle.GetNumThreads(), 1);
+  idle.Wait();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file util_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "../src/util.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(UtilTests, MeasureSegmentsTests) {
+  // North, east along the equator, then back south west
+  double latitudes[4] = {0, 1, 1, 0};
+  double longitudes[4] = {0, 0, 1, 0};
+  double lengths[4];
+  double bearings[4];
+  Util::MeasureSegments(latitudes, longitudes, 4, lengths, bearings);
+
+  // A degree of latitude is about 69.09 miles, two units to the mile
+  EXPECT_EQ(lengths[0], 0);
+  EXPECT_NEAR(lengths[1], 138.18, 0.01);
+  EXPECT_NEAR(lengths[2], 138.18 * cos(M_PI / 180), 0.01);
+  EXPECT_NEAR(lengths[3], 195.4, 0.1);
+  EXPECT_EQ(bearings[0], 0);
+  EXPECT_NEAR(bearings[1], 0, 1e-9);
+  EXPECT_NEAR(bearings[2], 90, 0.01);
+  EXPECT_NEAR(bearings[3], 225, 0.01);
+}
+
+TEST(UtilTests, MeasureSegmentsLatitudeTests) {
+  // A degree of longitude shrinks away from the equator, which a flat
+  // scale fitted to one latitude gets wrong elsewhere
+  double latitudes[4] = {44.97, 44.97, 60, 60};
+  double longitudes[4] = {-93.24, -93.23, -93.24, -93.23};
+  vector<double> lengths(4), bearings(4);
+  Util::MeasureSegments(latitudes, longitudes, 4, lengths.data(),
+                        bearings.data());
+  EXPECT_NEAR(lengths[1], 0.01 * 138.18 * cos(44.97 * M_PI / 180), 0.001);
+  EXPECT_NEAR(lengths[3], 0.01 * 138.18 * cos(60 * M_PI / 180), 0.001);
+  EXPECT_NEAR(bearings[1], 90, 0.01);
+  EXPECT_NEAR(bearings[3], 90, 0.01);
+}
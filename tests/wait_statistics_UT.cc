@@ -0,0 +1,95 @@
+/**
+ * @file wait_statistics_UT.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/event_bus.h"
+#include "../src/name_table.h"
+#include "../src/passenger.h"
+#include "../src/passenger_unloader.h"
+#include "../src/stop.h"
+#include "../src/wait_statistics.h"
+
+using namespace std;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(WaitStatisticsTests, SplitsByRouteAndStop) {
+  EventBus events;
+  WaitStatistics stats;
+  stats.Attach(&events);
+  NameTable * names = NameTable::GetDefault();
+  int route_a = names->Intern("WaitStatisticsRouteA");
+  int route_b = names->Intern("WaitStatisticsRouteB");
+  int stop = names->Intern("WaitStatisticsStop");
+  events.Publish(stop, PassengerAlightedEvent(1, route_a, stop, 2, 5));
+  events.Publish(stop, PassengerAlightedEvent(1, route_a, stop, 4, 5));
+  events.Publish(stop, PassengerAlightedEvent(2, route_b, stop, 10, 1));
+
+  vector<WaitSummary> summaries = stats.GetSummaries();
+  ASSERT_EQ(summaries.size(), 4u);
+  EXPECT_EQ(summaries[0].scope, WaitSummary::kNetwork);
+  EXPECT_EQ(summaries[0].total.count, 3);
+  EXPECT_EQ(summaries[0].waitAtStop.max, 10);
+  EXPECT_EQ(summaries[0].ride.p50, 5);
+  EXPECT_EQ(summaries[0].total.p99, 11);
+
+  EXPECT_EQ(summaries[1].scope, WaitSummary::kRoute);
+  EXPECT_EQ(summaries[1].id, route_a);
+  EXPECT_EQ(summaries[1].waitAtStop.count, 2);
+  EXPECT_DOUBLE_EQ(summaries[1].waitAtStop.mean, 3);
+  EXPECT_EQ(summaries[2].id, route_b);
+  EXPECT_EQ(summaries[2].total.p50, 11);
+  EXPECT_EQ(summaries[3].scope, WaitSummary::kStop);
+  EXPECT_EQ(summaries[3].total.count, 3);
+
+  ostringstream table;
+  WaitStatistics::WriteTable(table, summaries, *names);
+  EXPECT_NE(table.str().find("route,WaitStatisticsRouteB,total,1,11,11,11,"
+                             "11,11"), string::npos);
+
+  stats.Clear();
+  summaries = stats.GetSummaries();
+  ASSERT_EQ(summaries.size(), 1u);
+  EXPECT_EQ(summaries[0].total.count, 0);
+}
+
+TEST(WaitStatisticsTests, FilledOnAlight) {
+  EventBus events;
+  WaitStatistics stats;
+  stats.Attach(&events);
+  Stop stop(7);
+  // Waited 3 steps at its stop, then rode 2
+  Passenger * passenger = new Passenger(7, "Rider");
+  for (int i = 0; i < 3; i++) {
+    passenger->Update();
+  }
+  passenger->GetOnBus();
+  passenger->Update();
+  list<Passenger *> passengers(1, passenger);
+
+  PassengerUnloader unloader;
+  unloader.SetLog(NULL);
+  int route = NameTable::GetDefault()->Intern("WaitStatisticsRoute");
+  EXPECT_EQ(unloader.UnloadPassengers(&passengers, &stop, &events, 1, route),
+            1);
+  vector<WaitSummary> summaries = stats.GetSummaries();
+  ASSERT_EQ(summaries.size(), 3u);
+  EXPECT_EQ(summaries[0].waitAtStop.max, 3);
+  EXPECT_EQ(summaries[0].ride.max, 2);
+  EXPECT_EQ(summaries[0].total.max, 5);
+  EXPECT_EQ(summaries[1].id, route);
+  EXPECT_EQ(summaries[2].id, stop.GetStopData().id);
+}
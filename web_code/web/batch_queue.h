@@ -0,0 +1,79 @@
+/**
+ * @file batch_queue.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_BATCH_QUEUE_H_
+#define WEB_CODE_WEB_BATCH_QUEUE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Lock-free queue of batches from one writer to one reader thread.
+ *
+ * Unlike TripleBuffer, nothing is ever dropped: every batch pushed is
+ * taken by the reader, in order, however many were pushed in between.
+ * Neither side ever waits for the other.
+ *
+ * Calls to \ref Push function to queue a batch (writer only).
+ * Calls to \ref TakeAll function to get every batch queued (reader only).
+ */
+template <typename T>
+class BatchQueue {
+ public:
+  BatchQueue() : head_(nullptr) {}
+  ~BatchQueue() { Delete(head_.load(std::memory_order_acquire)); }
+  BatchQueue(const BatchQueue&) = delete;
+  BatchQueue& operator=(const BatchQueue&) = delete;
+  /**
+   * @brief Queue a batch, moved from.
+   */
+  void Push(T * batch) {
+    Node * node = new Node;
+    node->batch.swap(*batch);
+    node->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {}
+  }
+  /**
+   * @brief Append every batch queued since the last call, oldest first.
+   */
+  void TakeAll(std::vector<T> * batches) {
+    Node * node = head_.exchange(nullptr, std::memory_order_acquire);
+    // The batches were pushed on the front, newest first
+    size_t first = batches->size();
+    for (Node * it = node; it != nullptr; it = it->next) {
+      batches->push_back(T());
+      batches->back().swap(it->batch);
+    }
+    std::reverse(batches->begin() + first, batches->end());
+    Delete(node);
+  }
+
+ private:
+  struct Node {
+    T batch;
+    Node * next;
+  };
+
+  static void Delete(Node * node) {
+    while (node != nullptr) {
+      Node * next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  std::atomic<Node *> head_;
+};
+
+#endif  // WEB_CODE_WEB_BATCH_QUEUE_H_
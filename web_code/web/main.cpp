@@ -8,8 +8,10 @@
  ******************************************************************************/
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 #include <cerrno>
 
 #include "src/config_manager.h"
@@ -19,26 +21,368 @@
 #include "web_code/web/my_web_server_command.h"
 #include "web_code/web/my_web_server_session.h"
 #include "web_code/web/my_web_server.h"
+#include "web_code/web/simulation_clock.h"
+#include "web_code/web/simulation_thread.h"
+#include "web_code/web/replication_runner.h"
+#include "web_code/web/sweep_runner.h"
 
 // #define _USE_MATH_DEFINES
 // #include <cmath>
 // #include <libwebsockets.h>
 
+// Read the network from a GTFS feed, a compiled image or config.txt
+static bool ReadNetwork(ConfigManager* cm, const std::string& gtfsDirectory,
+                        const std::string& demandFile,
+                        const std::string& networkImage) {
+    try {
+        if (!gtfsDirectory.empty()) {
+            cm->ReadGtfs(gtfsDirectory, demandFile);
+            std::cout << "Using GTFS feed: " << gtfsDirectory << std::endl;
+        } else if (networkImage.empty()) {
+            cm->ReadConfig("config.txt");
+            std::cout << "Using default config file: config.txt"
+                      << std::endl;
+        } else {
+            cm->ReadNetwork(networkImage);
+            std::cout << "Using network image: " << networkImage
+                      << std::endl;
+        }
+    } catch (const ConfigError& error) {
+        std::cerr << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// A whole number of 0 or more, nothing else
+static bool ParseCount(const std::string& text, int* value) {
+    char* end;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);  // NOLINT
+    if (text.empty() || *end != '\0' || errno != 0 || parsed < 0
+        || parsed > 2147483647L) {
+        return false;
+    }
+    *value = static_cast<int>(parsed);
+    return true;
+}
+
+// Milliseconds between two ticks or frames, 0 would stop the clock
+static bool ParseRate(const std::string& text, int* value) {
+    int parsed;
+    if (!ParseCount(text, &parsed) || parsed == 0) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+// Time steps between two busses of every line, "5,3,4", one per route pair
+static bool ParseTimings(const std::string& list, std::vector<int>* timings) {
+    size_t start = 0;
+    while (start <= list.size() && !list.empty()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        int timing;
+        if (!ParseCount(list.substr(start, end - start), &timing)) {
+            return false;
+        }
+        timings->push_back(timing);
+        start = end + 1;
+    }
+    return true;
+}
+
+// One console line of the network wait, ride and total time percentiles
+static void PrintWaitPercentiles(int step, const WaitStatistics& stats) {
+    WaitSummary network = stats.GetSummaries()[0];
+    const WaitPercentiles * measures[3] = {
+        &network.waitAtStop, &network.ride, &network.total
+    };
+    const char * names[3] = {"wait_at_stop", "ride", "total"};
+    std::cout << "step " << step << ": " << network.total.count
+              << " delivered";
+    for (int i = 0; i < 3; i++) {
+        std::cout << ", " << names[i] << " p50/p95/p99 " << measures[i]->p50
+                  << "/" << measures[i]->p95 << "/" << measures[i]->p99;
+    }
+    std::cout << std::endl;
+}
+
 
 int main(int argc, char**argv) {
     // Print how to run the simulator
-    std::cout << "Usage: ./build/bin/ExampleServer 8081" << std::endl;
+    std::cout << "Usage: ./build/bin/ExampleServer 8081 [output_file]"
+              << " [--tick-ms=1000] [--frame-ms=100] [--network=image]"
+              << " [--gtfs=dir --demand=file] [--restore=checkpoint]"
+              << std::endl;
+    std::cout << "       ./build/bin/ExampleServer --compile-network=image"
+              << " [--gtfs=dir --demand=file]" << std::endl;
+    std::cout << "       ./build/bin/ExampleServer --headless=steps"
+              << " [--timings=5,5,...] [--restore=checkpoint]"
+              << " [--save=checkpoint] [--wait-stats=file]"
+              << " [--wait-stats-every=N]" << std::endl;
+    std::cout << "       ./build/bin/ExampleServer --sweep=scenarios.csv"
+              << " [--summary=file] [--threads=N]"
+              << " [--replications=N [--ci-width=0.05] [--antithetic]]"
+              << std::endl;
+
+    // Milliseconds between two simulation updates, and between two frames
+    // pushed to the subscribed browsers
+    int tickMs = 1000;
+    int frameMs = 100;
+    // Binary network image to load instead of parsing config.txt, and the
+    // image to compile config.txt into
+    std::string networkImage;
+    std::string compileNetwork;
+    // GTFS feed directory and stop demand file to build the network from
+    std::string gtfsDirectory;
+    std::string demandFile;
+    // Checkpoint to go on from, and, without the web server, time steps to
+    // run, bus timings of a new run and checkpoint to save at the end
+    std::string restoreFile;
+    int headlessSteps = -1;
+    std::string timings;
+    std::string saveFile;
+    // Without the web server, file the wait time percentiles are written
+    // to at the end ("-" for the console), and time steps between two
+    // lines of network percentiles on the console, 0 for none
+    std::string waitStatsFile;
+    int waitStatsEvery = 0;
+    // Scenarios to run side by side without the web server, the table of
+    // their results, and simulations run at once, 0 for one per core
+    std::string sweepFile;
+    std::string summaryFile;
+    int sweepThreads = 0;
+    // Seeds each scenario is run with at most, 0 runs it once, and the
+    // relative half width of the 95% intervals to stop early at, and
+    // whether each seed runs again with antithetic arrivals
+    int replications = 0;
+    double ciWidth = 0.05;
+    bool antithetic = false;
+
+    // Options can appear anywhere, everything else is positional
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 10, "--tick-ms=") == 0) {
+            if (!ParseRate(arg.substr(10), &tickMs)) {
+                std::cerr << arg << ": not a whole number of ms above 0"
+                          << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 11, "--frame-ms=") == 0) {
+            if (!ParseRate(arg.substr(11), &frameMs)) {
+                std::cerr << arg << ": not a whole number of ms above 0"
+                          << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--network=") == 0) {
+            networkImage = arg.substr(10);
+        } else if (arg.compare(0, 18, "--compile-network=") == 0) {
+            compileNetwork = arg.substr(18);
+        } else if (arg.compare(0, 7, "--gtfs=") == 0) {
+            gtfsDirectory = arg.substr(7);
+        } else if (arg.compare(0, 9, "--demand=") == 0) {
+            demandFile = arg.substr(9);
+        } else if (arg.compare(0, 10, "--restore=") == 0) {
+            restoreFile = arg.substr(10);
+        } else if (arg.compare(0, 11, "--headless=") == 0) {
+            headlessSteps = std::atoi(arg.c_str() + 11);
+        } else if (arg.compare(0, 10, "--timings=") == 0) {
+            timings = arg.substr(10);
+        } else if (arg.compare(0, 7, "--save=") == 0) {
+            saveFile = arg.substr(7);
+        } else if (arg.compare(0, 13, "--wait-stats=") == 0) {
+            waitStatsFile = arg.substr(13);
+        } else if (arg.compare(0, 19, "--wait-stats-every=") == 0) {
+            waitStatsEvery = std::atoi(arg.c_str() + 19);
+        } else if (arg.compare(0, 8, "--sweep=") == 0) {
+            sweepFile = arg.substr(8);
+        } else if (arg.compare(0, 10, "--summary=") == 0) {
+            summaryFile = arg.substr(10);
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            sweepThreads = std::atoi(arg.c_str() + 10);
+        } else if (arg.compare(0, 15, "--replications=") == 0) {
+            replications = std::atoi(arg.c_str() + 15);
+        } else if (arg.compare(0, 11, "--ci-width=") == 0) {
+            ciWidth = std::atof(arg.c_str() + 11);
+        } else if (arg == "--antithetic") {
+            antithetic = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    // Compile the network once, later starts map the image with --network
+    if (!compileNetwork.empty()) {
+        try {
+            ConfigManager compiler;
+            if (gtfsDirectory.empty()) {
+                compiler.ReadConfig("config.txt");
+            } else {
+                compiler.ReadGtfs(gtfsDirectory, demandFile);
+            }
+            compiler.WriteNetwork(compileNetwork);
+        } catch (const ConfigError& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Compiled "
+                  << (gtfsDirectory.empty() ? "config.txt" : gtfsDirectory)
+                  << " into " << compileNetwork << std::endl;
+        return 0;
+    }
+
+    // Compare headways, fleet strategies and demand, one simulation per
+    // scenario, all of them on the network read once
+    if (!sweepFile.empty()) {
+        ConfigManager cm;
+        if (!ReadNetwork(&cm, gtfsDirectory, demandFile, networkImage)) {
+            return 1;
+        }
+        std::vector<Scenario> scenarios;
+        try {
+            scenarios = SweepRunner::ReadScenarios(sweepFile);
+        } catch (const ConfigError& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        SweepRunner runner(cm.GetNetwork(), sweepThreads);
+        std::cout << "Running " << scenarios.size() << " scenarios"
+                  << std::endl;
+        // The simulations trace nothing, the intervals of replications go
+        // to the console
+        std::vector<ScenarioResult> results;
+        std::vector<ReplicationResult> replicated;
+        if (replications > 0) {
+            ReplicationOptions options;
+            options.maxReplications = replications;
+            options.relativeWidth = ciWidth;
+            options.numThreads = sweepThreads;
+            options.antithetic = antithetic;
+            ReplicationRunner replicator(runner, options);
+            for (int i = 0; i < static_cast<int>(scenarios.size()); i++) {
+                replicated.push_back(
+                    replicator.Run(scenarios[i], &std::cout));
+            }
+        } else {
+            results = runner.Run(scenarios);
+        }
+
+        int failed = 0;
+        for (int i = 0; i < static_cast<int>(results.size()); i++) {
+            if (!results[i].error.empty()) failed++;
+        }
+        for (int i = 0; i < static_cast<int>(replicated.size()); i++) {
+            if (!replicated[i].error.empty()) failed++;
+        }
+        std::ofstream summary;
+        if (!summaryFile.empty()) {
+            summary.open(summaryFile.c_str());
+        }
+        std::ostream& table = summaryFile.empty() ? std::cout : summary;
+        if (replications > 0) {
+            ReplicationRunner::WriteTable(table, replicated);
+        } else {
+            SweepRunner::WriteTable(table, results);
+        }
+        if (!summaryFile.empty()) {
+            summary.close();
+            if (!summary) {
+                std::cerr << summaryFile << ": cannot write the summary"
+                          << std::endl;
+                return 1;
+            }
+            std::cout << "Wrote " << summaryFile << std::endl;
+        }
+        if (failed > 0) {
+            std::cerr << failed << " scenarios failed, see the error column"
+                      << std::endl;
+        }
+        return 0;
+    }
+
+    // Warm up or branch a run without the web server, one checkpoint in,
+    // one out
+    if (headlessSteps >= 0) {
+        ConfigManager cm;
+        if (!ReadNetwork(&cm, gtfsDirectory, demandFile, networkImage)) {
+            return 1;
+        }
+        NullWebInterface web;
+        std::ostream report(NULL);  // route and bus reports are dropped
+        VisualizationSimulator sim(&web, &cm, &report);
+        std::string error;
+        if (!restoreFile.empty()) {
+            if (!sim.LoadCheckpoint(restoreFile, &error)) {
+                std::cerr << restoreFile << ": " << error << std::endl;
+                return 1;
+            }
+            sim.RunFor(headlessSteps);
+        } else {
+            // One timing per line, Start does not check them
+            int numLines = static_cast<int>(cm.GetRoutes().size()) / 2;
+            std::vector<int> busTimings;
+            if (!ParseTimings(timings, &busTimings)) {
+                std::cerr << "--timings=" << timings
+                          << ": not a list of whole numbers of 0 or more"
+                          << std::endl;
+                return 1;
+            }
+            if (busTimings.empty()) {
+                busTimings.assign(numLines, 5);
+            }
+            if (static_cast<int>(busTimings.size()) != numLines) {
+                std::cerr << "--timings=" << timings << ": "
+                          << busTimings.size() << " timings for "
+                          << numLines << " lines" << std::endl;
+                return 1;
+            }
+            sim.Start(busTimings, headlessSteps);
+        }
+        for (int i = 0; i < headlessSteps && sim.Update(); i++) {
+            if (waitStatsEvery > 0 && (i + 1) % waitStatsEvery == 0) {
+                PrintWaitPercentiles(i + 1, sim.GetWaitStatistics());
+            }
+        }
+        if (!waitStatsFile.empty()) {
+            std::vector<WaitSummary> summaries =
+                sim.GetWaitStatistics().GetSummaries();
+            if (waitStatsFile == "-") {
+                WaitStatistics::WriteTable(std::cout, summaries,
+                                           cm.GetNames());
+            } else {
+                std::ofstream table(waitStatsFile.c_str());
+                WaitStatistics::WriteTable(table, summaries, cm.GetNames());
+                table.close();
+                if (!table) {
+                    std::cerr << waitStatsFile
+                              << ": cannot write the wait times"
+                              << std::endl;
+                    return 1;
+                }
+            }
+        }
+        if (!saveFile.empty()
+            && (!sim.SaveCheckpoint(saveFile, &error)
+                || !sim.WaitForCheckpoint(&error))) {
+            std::cerr << saveFile << ": " << error << std::endl;
+            return 1;
+        }
+        return 0;
+    }
 
     // Check whether received arguments is legal
-    if (argc > 1) {
-        int port = std::atoi(argv[1]);
+    if (args.size() > 0) {
+        int port = std::atoi(args[0].c_str());
         std::streambuf* buffer;
         std::ofstream of;
 
-        if (argc > 2) {
+        if (args.size() > 1) {
             // Only get here if a second parameter is being specified
             // which is a filename for output redirection.
-            std::string filename = argv[2];
+            std::string filename = args[1];
             of.open(filename.c_str(), std::fstream::out);
             buffer = of.rdbuf();
             std::cout << "got here" << std::endl;
@@ -56,27 +400,67 @@ int main(int argc, char**argv) {
         MyWebServer* myWS = new MyWebServer();
         ConfigManager* cm = new ConfigManager();
 
-        // Read in configuration file for the routes
-        cm->ReadConfig("config.txt");
-        std::cout << "Using default config file: config.txt" << std::endl;
+        // Read in configuration file for the routes, a GTFS feed, or a
+        // compiled image
+        if (!ReadNetwork(cm, gtfsDirectory, demandFile, networkImage)) {
+            return 1;
+        }
+        myWS->SetNames(&cm->GetNames());
+        myWS->InitRouteGeometry(cm->GetRoutes());
 
         VisualizationSimulator* mySim =
           new VisualizationSimulator(myWS, cm, &out);
+        myWS->SetSimulator(mySim);
+
+        // The simulation thread is not running yet, load it right away
+        if (!restoreFile.empty()) {
+            std::string error;
+            if (!mySim->LoadCheckpoint(restoreFile, &error)) {
+                std::cerr << restoreFile << ": " << error << std::endl;
+                return 1;
+            }
+        }
 
         // Initialize commands for interaction
         state.commands["getRoutes"] = new GetRoutesCommand(myWS);
         state.commands["getBusses"] = new GetBussesCommand(myWS);
         state.commands["start"] = new StartCommand(mySim);
         state.commands["pause"] = new PauseCommand(mySim);
-        state.commands["update"] = new UpdateCommand(mySim);
-        state.commands["initRoutes"] = new InitRoutesCommand(cm);
-        state.commands["listenBus"] = new AddBusListenerCommand(mySim);
-        state.commands["listenStop"] = new AddStopListenerCommand(mySim);
+        state.commands["subscribe"] = new SubscribeCommand(myWS);
+        state.commands["initRoutes"] = new InitRoutesCommand(myWS);
+        state.commands["listenBus"] = new AddBusListenerCommand(myWS);
+        state.commands["listenStop"] = new AddStopListenerCommand(myWS);
+        state.commands["setViewport"] = new SetViewportCommand(myWS);
+        state.commands["setZoom"] = new SetZoomCommand(myWS);
+        state.commands["save"] = new SaveCommand(mySim);
+        state.commands["load"] = new LoadCommand(mySim);
+        state.commands["waitStats"] = new WaitStatsCommand(mySim);
+        state.webServer = myWS;
 
         WebServerWithState<MyWebServerSession,
                            MyWebServerSessionState> server(state, port);
+
+        // The simulation ticks on its own thread and clock, so neither the
+        // number of open browsers nor a slow tick affects the other side
+        SimulationThread simThread(mySim, tickMs);
+        SimulationClock frameClock(frameMs);
+        std::cout << "Simulation tick every " << tickMs << " ms, frame every "
+                  << frameMs << " ms" << std::endl;
+        simThread.Start();
+
         while (true) {
-            server.service();
+            // The frame clock drives the loop: the server polls its sockets
+            // at most until the next frame is due, and returns earlier on
+            // traffic
+            server.service(frameClock.GetRemaining());
+
+            // Watched buses and stops of the latest tick, one frame per
+            // session
+            myWS->FlushObservations();
+
+            if (frameClock.Expirations() > 0) {
+                myWS->PushFrame();
+            }
         }
     }
 
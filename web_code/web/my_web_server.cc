@@ -4,57 +4,745 @@
  * @copyright 2019 3081 Staff, All rights reserved.
  */
 #include <algorithm>
+#include <list>
+#include <map>
+#include <sstream>
 #include <string>
 
+#include "WebServer.h"
 #include "web_code/web/my_web_server.h"
+#include "web_code/web/my_web_server_session.h"
+#include "src/name_table.h"
+#include "src/route.h"
+#include "src/stop.h"
+#include "web_code/web/visualization_simulator.h"
 
-MyWebServer::MyWebServer() : routes(std::vector<RouteData>(0)),
-                                    busses(std::vector<BusData>(0)) {
+static std::string FormatBus(const NameTable& names, const BusData& bus) {
+    picojson::object data;
+    data["command"] = picojson::value("observeBus");
+    std::stringstream ss;
+    ss << "Bus " << names.GetName(bus.id) << "\n";
+    ss << "-----------------------------\n";
+    ss << "  * Position: (" << bus.position.x
+       << "," << bus.position.y << ")\n";
+    ss << "  * Passengers: " << bus.num_passengers << "\n";
+    ss << "  * Capacity: " << bus.capacity << "\n";
+    data["text"] = picojson::value(ss.str());
+    return picojson::value(data).serialize();
+}
+
+static std::string FormatStop(const NameTable& names,
+                              const StopData& stop) {
+    picojson::object data;
+    data["command"] = picojson::value("observeStop");
+    std::stringstream ss;
+    ss << "Stop " << names.GetName(stop.id) << "\n";
+    ss << "-----------------------------\n";
+    ss << "  * Position: (" << stop.position.x
+       << "," << stop.position.y << ")\n";
+    ss << "  * Passengers: " << stop.num_people << "\n";
+    data["text"] = picojson::value(ss.str());
+    return picojson::value(data).serialize();
+}
+
+// Position, load and color of every bus
+static std::string FormatBusses(const NameTable& names,
+                                const std::vector<BusData>& bs) {
+    picojson::object data;
+    data["command"] = picojson::value("updateBusses");
+
+    picojson::array bussesArray;
+
+    // Get and store information for all buses
+    for (int i = 0; i < static_cast<int>(bs.size()); i++) {
+        picojson::object s;
+        // Get store bus name
+        s["id"] = picojson::value(names.GetName(bs[i].id));
+        // Get the number of passengers on the bus
+        s["numPassengers"] = picojson::value
+          (static_cast<double>(bs[i].num_passengers));
+        // Get bus capacity
+        s["capacity"] = picojson::value
+          (static_cast<double>(bs[i].capacity));
+
+        picojson::object pStruct;
+        // Get stop position
+        pStruct["x"] = picojson::value(bs[i].position.x);
+        pStruct["y"] = picojson::value(bs[i].position.y);
+        s["position"] = picojson::value(pStruct);
+
+        picojson::object cStruct;
+        cStruct["red"] =
+        picojson::value(static_cast<double>(bs[i].color.red));
+        cStruct["green"] =
+        picojson::value(static_cast<double>(bs[i].color.green));
+        cStruct["blue"] =
+        picojson::value(static_cast<double>(bs[i].color.blue));
+        cStruct["alpha"] =
+        picojson::value(static_cast<double>(bs[i].color.alpha));
+        s["color"] = picojson::value(cStruct);
+
+        bussesArray.push_back(picojson::value(s));
+    }
+
+    data["busses"] = picojson::value(bussesArray);
+    return picojson::value(data).serialize();
+}
+
+// Waiting counts of every stop, in the same stop order as the geometry. With
+// a stop filter, only routes with stops in it are sent, with the indices of
+// those stops
+static std::string FormatRoutes(const NameTable& names,
+    const std::vector<RouteData>& routes,
+    const std::map<int, std::vector<int> >* filter) {
+    picojson::object data;
+    data["command"] = picojson::value("updateRoutes");
+
+    picojson::array routesArray;
+
+    for (int i = 0; i < static_cast<int>(routes.size()); i++) {
+        const RouteData& route = routes[i];
+        picojson::object r;
+        r["id"] = picojson::value(names.GetName(route.id));
+
+        picojson::array numPeopleArray;
+        if (filter) {
+            std::map<int, std::vector<int> >::const_iterator it =
+              filter->find(route.id);
+            if (it == filter->end()) {
+                continue;
+            }
+            picojson::array stopArray;
+            for (int j = 0; j < static_cast<int>(it->second.size()); j++) {
+                int stop = it->second[j];
+                if (stop >= static_cast<int>(route.num_people.size())) {
+                    continue;
+                }
+                stopArray.push_back(picojson::value
+                  (static_cast<double>(stop)));
+                numPeopleArray.push_back(picojson::value
+                  (static_cast<double>(route.num_people[stop])));
+            }
+            r["stops"] = picojson::value(stopArray);
+        } else {
+            for (int j = 0; j < static_cast<int>(route.num_people.size());
+                 j++) {
+                numPeopleArray.push_back(picojson::value
+                  (static_cast<double>(route.num_people[j])));
+            }
+        }
+
+        r["numPeople"] = picojson::value(numPeopleArray);
+        routesArray.push_back(picojson::value(r));
+    }
+
+    data["routes"] = picojson::value(routesArray);
+    return picojson::value(data).serialize();
+}
+
+// Clusters of a detail level, as tiles of the grid. The load is the mean
+// load of the busses of a tile, its color the most common bus color
+static std::string FormatClusters(const std::vector<ClusterTile>& tiles,
+    int level, double cellSize) {
+    picojson::object data;
+    data["command"] = picojson::value("updateClusters");
+    data["level"] = picojson::value(static_cast<double>(level));
+    data["cellSize"] = picojson::value(cellSize);
+
+    picojson::array tilesArray;
+    for (int i = 0; i < static_cast<int>(tiles.size()); i++) {
+        const ClusterTile& tile = tiles[i];
+        picojson::object t;
+        t["column"] = picojson::value(static_cast<double>(tile.column));
+        t["row"] = picojson::value(static_cast<double>(tile.row));
+        t["numBusses"] = picojson::value
+          (static_cast<double>(tile.num_busses));
+        t["load"] = picojson::value(tile.capacity > 0 ?
+          static_cast<double>(tile.num_passengers) / tile.capacity : 0.0);
+        if (tile.color >= 0) {
+            picojson::object cStruct;
+            cStruct["red"] = picojson::value
+              (static_cast<double>((tile.color >> 16) & 0xff));
+            cStruct["green"] = picojson::value
+              (static_cast<double>((tile.color >> 8) & 0xff));
+            cStruct["blue"] = picojson::value
+              (static_cast<double>(tile.color & 0xff));
+            t["color"] = picojson::value(cStruct);
+        }
+        t["numStops"] = picojson::value(static_cast<double>(tile.num_stops));
+        t["numWaiting"] = picojson::value
+          (static_cast<double>(tile.num_waiting));
+        tilesArray.push_back(picojson::value(t));
+    }
+
+    data["tiles"] = picojson::value(tilesArray);
+    return picojson::value(data).serialize();
+}
+
+MyWebServer::MyWebServer() : routes(std::vector<const RouteData *>(0)),
+                                    busses(std::vector<BusData>(0)),
+                                    bussesVersion(0), routesVersion(0),
+                                    visibleVersion(0),
+                                    culledBussesVersion(0),
+                                    viewportsChanged(false),
+                                    clusterTiles(kNumDetailLevels - 1),
+                                    clustersChanged(false),
+                                    clustersVersion(0),
+                                    routeGeometry(""), routeOccupancy(""),
+                                    routeOccupancyVersion(-1), bussesJSON(""),
+                                    bussesJSONVersion(-1), frameDirty(true),
+                                    front(nullptr),
+                                    nextViewportSlot(0), sim(nullptr),
+                                    names(NameTable::GetDefault()) {
+    for (int level = 0; level < kNumDetailLevels; level++) {
+        if (level > 0) {
+            clusterGrids.push_back(ClusterGrid(GetClusterCellSize(level)));
+        }
+        clustersJSONVersion[level] = -1;
+    }
+}
+
+int MyWebServer::GetDetailLevel(int zoom) {
+    // Individual busses down to a city, then cells about 50 pixels wide
+    if (zoom >= 12) return 0;
+    if (zoom >= 10) return 1;
+    if (zoom >= 8) return 2;
+    return 3;
+}
+
+double MyWebServer::GetClusterCellSize(int level) {
+    // 1/32, 1/8 and 1/2 of a degree, each level nests in the next
+    return 0.5 / (1 << (2 * (kNumDetailLevels - 1 - level)));
+}
+
+// Packed 0xRRGGBB color of a bus, which tells its direction
+static int PackColor(const Color& color) {
+    return (color.red << 16) | (color.green << 8) | color.blue;
 }
 
 void MyWebServer::UpdateBus(const BusData& bData, bool deleted) {
-    auto it = std::find_if(busses.begin(), busses.end(), [&](const BusData& b)
-                           { return b.id == bData.id; });
+    bussesVersion++;
+
+    // Busses are found by id, ids being dense, see NameTable
+    if (bData.id < 0) {
+        return;
+    }
+    if (bData.id >= static_cast<int>(busIndex.size())) {
+        busIndex.resize(bData.id + 1, -1);
+    }
+    int index = busIndex[bData.id];
 
     // Check whether the bus is found
-    if (it != busses.end()) {
+    if (index >= 0) {
         // Check whether we need to delete the bus from the simulator
         if (deleted) {
-            busses.erase(it);
+            // Swap-remove, the order of the busses does not matter
+            busIndex[busses.back().id] = index;
+            busses[index] = busses.back();
+            busses.pop_back();
+            busIndex[bData.id] = -1;
+            busGrid.Remove(bData.id);
+            for (int i = 0; i < static_cast<int>(clusterGrids.size()); i++) {
+                clusterGrids[i].RemoveBus(bData.id);
+            }
+            clustersChanged = true;
             return;
         }
 
-        int index = std::distance(busses.begin(), it);
-
         busses[index].id = bData.id;
         busses[index].position = bData.position;
         busses[index].num_passengers = bData.num_passengers;
         busses[index].capacity = bData.capacity;
         busses[index].color = bData.color;
-    } else {
+    } else if (!deleted) {
+        busIndex[bData.id] = static_cast<int>(busses.size());
         busses.push_back(bData);
+    } else {
+        return;
+    }
+    // Only touches the grid cells when the bus crossed into another cell
+    busGrid.Update(bData.id, bData.position.x, bData.position.y);
+    for (int i = 0; i < static_cast<int>(clusterGrids.size()); i++) {
+        clusterGrids[i].UpdateBus(bData.id, bData.position.x,
+                                  bData.position.y, bData.num_passengers,
+                                  bData.capacity, PackColor(bData.color));
     }
+    clustersChanged = true;
 }
 
 void MyWebServer::UpdateRoute(const RouteData& rData, bool deleted) {
-    auto it = std::find_if(routes.begin(), routes.end(), [&](const RouteData& r)
-                           { return r.id == rData.id; });
+    auto it = std::find(routes.begin(), routes.end(), &rData);
 
     // Check whether the route is found
     if (it != routes.end()) {
         // Check whether we need to delete the route from the simulator
         if (deleted) {
             routes.erase(it);
+            routesVersion++;
+            UpdateStopClusters(rData, true, true);
             return;
         }
+        // Otherwise the view already reflects the latest route data, we
+        // only need to know whether a waiting count changed
+        if (std::find(rData.dirty.begin(), rData.dirty.end(), true)
+            != rData.dirty.end()) {
+            routesVersion++;
+            UpdateStopClusters(rData, false, false);
+        }
+    } else if (!deleted) {
+        routes.push_back(&rData);
+        routesVersion++;
+        UpdateStopClusters(rData, true, false);
+    }
+}
+
+void MyWebServer::UpdateStopClusters(const RouteData& rData, bool all,
+    bool deleted) {
+    // Only the stops whose waiting count changed, unless the route is new
+    // or gone
+    for (int i = 0; i < static_cast<int>(clusterGrids.size()); i++) {
+        for (int j = 0; j < static_cast<int>(rData.stops.size()); j++) {
+            const StopData& stop = *rData.stops[j];
+            if (deleted) {
+                clusterGrids[i].RemoveStop(stop.id);
+            } else if (all || rData.dirty[j]) {
+                clusterGrids[i].UpdateStop(stop.id, stop.position.x,
+                                           stop.position.y,
+                                           rData.num_people[j]);
+            }
+        }
+    }
+    clustersChanged = true;
+}
+
+void MyWebServer::Publish() {
+    // The back buffer may hold an older tick, only copy what changed since
+    SimulationSnapshot& snapshot = snapshots.GetBack();
+    if (snapshot.bussesVersion != bussesVersion) {
+        snapshot.busses = busses;
+        snapshot.bussesVersion = bussesVersion;
+    }
+    if (snapshot.routesVersion != routesVersion) {
+        snapshot.routes.resize(routes.size());
+        for (int i = 0; i < static_cast<int>(routes.size()); i++) {
+            snapshot.routes[i].id = routes[i]->id;
+            snapshot.routes[i].num_people = routes[i]->num_people;
+        }
+        snapshot.routesVersion = routesVersion;
+    }
+    if (viewportsChanged || culledBussesVersion != bussesVersion) {
+        CullBusses();
+    }
+    if (snapshot.visibleVersion != visibleVersion) {
+        snapshot.visibleBusses = visibleBusses;
+        snapshot.visibleVersion = visibleVersion;
+    }
+    // Reading the clusters out is linear in the occupied cells, not in the
+    // busses, which were already added up as they moved
+    if (clustersChanged) {
+        for (int i = 0; i < static_cast<int>(clusterGrids.size()); i++) {
+            clusterGrids[i].GetTiles(&clusterTiles[i]);
+        }
+        clustersChanged = false;
+        clustersVersion++;
+    }
+    if (snapshot.clustersVersion != clustersVersion) {
+        snapshot.clusters = clusterTiles;
+        snapshot.clustersVersion = clustersVersion;
+    }
+    snapshots.Publish();
+    if (!observed.busses.empty() || !observed.stops.empty()) {
+        observations.Push(&observed);
+    }
+}
+
+void MyWebServer::CullBusses() {
+    // Each viewport is a grid query, the busses out of view are not visited
+    std::vector<int> ids;
+    visibleBusses.clear();
+    for (std::map<int, BoundingBox>::const_iterator it = viewports.begin();
+         it != viewports.end(); it++) {
+        ids.clear();
+        busGrid.Query(it->second, &ids);
+        std::vector<BusData>& visible = visibleBusses[it->first];
+        for (int i = 0; i < static_cast<int>(ids.size()); i++) {
+            visible.push_back(busses[busIndex[ids[i]]]);
+        }
+    }
+    culledBussesVersion = bussesVersion;
+    viewportsChanged = false;
+    visibleVersion++;
+}
+
+void MyWebServer::InitRouteGeometry(const std::vector<Route *>& routeList) {
+    picojson::object data;
+    data["command"] = picojson::value("initRoutes");
+    data["numRoutes"] = picojson::value
+      (static_cast<double>(routeList.size()));
+
+    picojson::array routesArray;
 
-        int index = std::distance(routes.begin(), it);
+    // Store the stop ids and positions of all routes
+    routeStops.clear();
+    stopGrid.Clear();
+    for (int i = 0; i < static_cast<int>(routeList.size()); i++) {
+        picojson::object r;
+        r["id"] = picojson::value(routeList[i]->GetName());
+        int routeId = routeList[i]->GetId();
 
-        routes[index].id = rData.id;
-        routes[index].stops = rData.stops;
+        picojson::array stopArray;
+        const std::list<Stop *>& stops = routeList[i]->GetStops();
+        for (std::list<Stop *>::const_iterator it = stops.begin();
+             it != stops.end(); it++) {
+            const StopData& stop = (*it)->GetStopData();
+            // Indexed for viewports, by its place on the route
+            stopGrid.Update(static_cast<int>(routeStops.size()),
+                            stop.position.x, stop.position.y);
+            routeStops.push_back(std::make_pair(routeId,
+                                                static_cast<int>(
+                                                  stopArray.size())));
+            picojson::object stopStruct;
+            // Get stop name
+            stopStruct["id"] = picojson::value(names->GetName(stop.id));
+
+            picojson::object pStruct;
+            // Get position of the stop
+            pStruct["x"] = picojson::value(stop.position.x);
+            pStruct["y"] = picojson::value(stop.position.y);
+
+            stopStruct["position"] = picojson::value(pStruct);
+
+            stopArray.push_back(picojson::value(stopStruct));
+        }
+
+        r["stops"] = picojson::value(stopArray);
+        routesArray.push_back(picojson::value(r));
+    }
+
+    data["routes"] = picojson::value(routesArray);
+
+    routeGeometry = picojson::value(data).serialize();
+}
+
+void MyWebServer::Refresh() {
+    // Grab the latest snapshot, the simulation thread is never waited for
+    const SimulationSnapshot& snapshot = snapshots.GetFront();
+    front = &snapshot;
+
+    if (snapshot.routesVersion != routeOccupancyVersion) {
+        routeOccupancy = FormatRoutes(*names, snapshot.routes, nullptr);
+        routeOccupancyVersion = snapshot.routesVersion;
+        frameDirty = true;
+    }
+
+    if (snapshot.bussesVersion != bussesJSONVersion) {
+        bussesJSON = FormatBusses(*names, snapshot.busses);
+        bussesJSONVersion = snapshot.bussesVersion;
+        frameDirty = true;
+    }
+}
+
+const std::string& MyWebServer::GetRouteOccupancy() {
+    Refresh();
+    return routeOccupancy;
+}
+
+const std::string& MyWebServer::GetBusses() {
+    Refresh();
+    return bussesJSON;
+}
+
+void MyWebServer::RemoveSession(MyWebServerSession* session) {
+    subscribers.erase(session);
+    details.erase(session);
+    ClearViewport(session);
+    Unwatch(kBusEntity, watchers[kBusEntity].Unsubscribe(session));
+    Unwatch(kStopEntity, watchers[kStopEntity].Unsubscribe(session));
+}
+
+void MyWebServer::Subscribe(MyWebServerSession* session) {
+    subscribers.insert(session);
+
+    // A new subscriber gets the current frame right away
+    Refresh();
+    std::map<MyWebServerSession*, SessionDetail>::iterator detail =
+      details.find(session);
+    if (detail != details.end()) {
+        detail->second.clustersVersion = -1;
+        SendClusters(session, &detail->second);
+        return;
+    }
+    std::map<MyWebServerSession*, SessionView>::iterator it =
+      views.find(session);
+    if (it != views.end()) {
+        it->second.bussesVersion = -1;
+        it->second.routesVersion = -1;
+        SendView(session, &it->second);
+        return;
+    }
+    session->sendMessage(routeOccupancy);
+    session->sendMessage(bussesJSON);
+}
+
+void MyWebServer::PushFrame() {
+    Refresh();
+    if (subscribers.empty()) {
+        return;
+    }
+
+    // Serialized once, then the same buffers go to every subscriber without
+    // a viewport, the others get what changed in their own view
+    for (std::set<MyWebServerSession*>::iterator it = subscribers.begin();
+         it != subscribers.end(); it++) {
+        std::map<MyWebServerSession*, SessionDetail>::iterator detail =
+          details.find(*it);
+        std::map<MyWebServerSession*, SessionView>::iterator view =
+          views.find(*it);
+        if (detail != details.end()) {
+            SendClusters(*it, &detail->second);
+        } else if (view != views.end()) {
+            SendView(*it, &view->second);
+        } else if (frameDirty) {
+            (*it)->sendMessage(routeOccupancy);
+            (*it)->sendMessage(bussesJSON);
+        }
+    }
+    frameDirty = false;
+}
+
+void MyWebServer::SendView(MyWebServerSession* session, SessionView* view) {
+    if (view->routesVersion != front->routesVersion) {
+        session->sendMessage(FormatRoutes(*names, front->routes,
+                                          &view->stops));
+        view->routesVersion = front->routesVersion;
+    }
+    // The busses of a new viewport come with the next snapshot
+    std::map<int, std::vector<BusData> >::const_iterator it =
+      front->visibleBusses.find(view->slot);
+    if (it != front->visibleBusses.end()
+        && view->bussesVersion != front->visibleVersion) {
+        session->sendMessage(FormatBusses(*names, it->second));
+        view->bussesVersion = front->visibleVersion;
+    }
+}
+
+void MyWebServer::SetViewport(MyWebServerSession* session,
+    const BoundingBox& box) {
+    // A quarter of the view on every side
+    BoundingBox area = box.Expand(0.25);
+
+    std::map<MyWebServerSession*, SessionView>::iterator found =
+      views.find(session);
+    if (found == views.end()) {
+        SessionView view;
+        view.slot = nextViewportSlot++;
+        found = views.insert(std::make_pair(session, view)).first;
+    }
+    SessionView& view = found->second;
+    view.bussesVersion = -1;
+    view.routesVersion = -1;
+
+    // Stops never move, so their part of the view is found once here
+    std::vector<int> ids;
+    stopGrid.Query(area, &ids);
+    std::sort(ids.begin(), ids.end());
+    view.stops.clear();
+    for (int i = 0; i < static_cast<int>(ids.size()); i++) {
+        view.stops[routeStops[ids[i]].first].push_back(
+          routeStops[ids[i]].second);
+    }
+
+    // Busses are culled by the simulation thread, which publishes right
+    // away so a paused simulation still fills the new view
+    MyWebServer* ws = this;
+    int slot = view.slot;
+    sim->Post([ws, slot, area]() {
+        ws->viewports[slot] = area;
+        ws->viewportsChanged = true;
+        ws->Publish();
+    });
+
+    if (subscribers.count(session) && !details.count(session)) {
+        Refresh();
+        SendView(session, &view);
+    }
+}
+
+void MyWebServer::ClearViewport(MyWebServerSession* session) {
+    std::map<MyWebServerSession*, SessionView>::iterator found =
+      views.find(session);
+    if (found == views.end()) {
+        return;
+    }
+    MyWebServer* ws = this;
+    int slot = found->second.slot;
+    sim->Post([ws, slot]() {
+        ws->viewports.erase(slot);
+        ws->viewportsChanged = true;
+    });
+    views.erase(found);
+
+    // Back to the full frames
+    if (subscribers.count(session) && !details.count(session)) {
+        SendEntities(session);
+    }
+}
+
+void MyWebServer::SendEntities(MyWebServerSession* session) {
+    Refresh();
+    std::map<MyWebServerSession*, SessionView>::iterator view =
+      views.find(session);
+    if (view != views.end()) {
+        view->second.bussesVersion = -1;
+        view->second.routesVersion = -1;
+        SendView(session, &view->second);
     } else {
-        routes.push_back(rData);
+        session->sendMessage(routeOccupancy);
+        session->sendMessage(bussesJSON);
     }
 }
 
+void MyWebServer::SetZoom(MyWebServerSession* session, int zoom) {
+    int level = GetDetailLevel(zoom);
+    std::map<MyWebServerSession*, SessionDetail>::iterator found =
+      details.find(session);
+    if (level == 0) {
+        if (found != details.end()) {
+            details.erase(found);
+            if (subscribers.count(session)) {
+                SendEntities(session);
+            }
+        }
+        return;
+    }
+    if (found != details.end() && found->second.level == level) {
+        return;
+    }
+    SessionDetail& detail = details[session];
+    detail.level = level;
+    detail.clustersVersion = -1;
+    if (subscribers.count(session)) {
+        Refresh();
+        SendClusters(session, &detail);
+    }
+}
 
+void MyWebServer::SendClusters(MyWebServerSession* session,
+    SessionDetail* detail) {
+    if (detail->clustersVersion == front->clustersVersion
+        || front->clusters.empty()) {
+        return;
+    }
+    // Serialized once per level and shared by the sessions at that level
+    int level = detail->level;
+    if (clustersJSONVersion[level] != front->clustersVersion) {
+        clustersJSON[level] = FormatClusters(front->clusters[level - 1],
+                                             level,
+                                             GetClusterCellSize(level));
+        clustersJSONVersion[level] = front->clustersVersion;
+    }
+    session->sendMessage(clustersJSON[level]);
+    detail->clustersVersion = front->clustersVersion;
+}
+
+void MyWebServer::Watch(MyWebServerSession* session, EntityKind kind,
+    int id) {
+    if (watchers[kind].GetSubscription(session) == id) {
+        return;
+    }
+    if (id == NameTable::kNoId) {
+        // Unknown name, the session just stops watching
+        Unwatch(kind, watchers[kind].Unsubscribe(session));
+        return;
+    }
+    int dropped = NameTable::kNoId;
+    bool first = watchers[kind].Subscribe(session, id, &dropped);
+    Unwatch(kind, dropped);
+
+    // Applied by the simulation thread between two ticks, after any
+    // earlier Unwatch of the same entity
+    VisualizationSimulator* s = sim;
+    MyWebServer* ws = this;
+    // Entities only publish when they change, so a new watcher is sent the
+    // current state right away
+    if (kind == kBusEntity) {
+        sim->Post([s, ws, id, first]() {
+            if (first) {
+                s->GetEventBus().Subscribe<BusMovedEvent, MyWebServer,
+                                           &MyWebServer::OnBusMoved>(ws, id);
+            }
+            s->RepublishBus(id);
+        });
+    } else {
+        sim->Post([s, ws, id, first]() {
+            if (first) {
+                s->GetEventBus().Subscribe<StopCountChangedEvent, MyWebServer,
+                                   &MyWebServer::OnStopCountChanged>(ws, id);
+            }
+            s->RepublishStop(id);
+        });
+    }
+}
+
+void MyWebServer::Unwatch(EntityKind kind, int id) {
+    // Only stop observing once the last watching session is gone
+    if (id == NameTable::kNoId) {
+        return;
+    }
+    VisualizationSimulator* s = sim;
+    MyWebServer* ws = this;
+    if (kind == kBusEntity) {
+        sim->Post([s, ws, id]() {
+            s->GetEventBus().Unsubscribe<BusMovedEvent>(ws, id);
+        });
+    } else {
+        sim->Post([s, ws, id]() {
+            s->GetEventBus().Unsubscribe<StopCountChangedEvent>(ws, id);
+        });
+    }
+}
+
+void MyWebServer::FlushObservations() {
+    std::vector<Observations> ticks;
+    observations.TakeAll(&ticks);
+    if (ticks.empty()) {
+        return;
+    }
+
+    // One frame per session, holding every entity it watches, in tick order
+    std::map<MyWebServerSession*, std::string> frames;
+    for (int t = 0; t < static_cast<int>(ticks.size()); t++) {
+        const Observations& tick = ticks[t];
+        for (int i = 0; i < static_cast<int>(tick.busses.size()); i++) {
+            AppendObservation(kBusEntity, tick.busses[i].id,
+                              FormatBus(*names, tick.busses[i]), &frames);
+        }
+        for (int i = 0; i < static_cast<int>(tick.stops.size()); i++) {
+            AppendObservation(kStopEntity, tick.stops[i].id,
+                              FormatStop(*names, tick.stops[i]), &frames);
+        }
+    }
+
+    for (std::map<MyWebServerSession*, std::string>::iterator it =
+         frames.begin(); it != frames.end(); it++) {
+        it->second += "]}";
+        it->first->sendMessage(it->second);
+    }
+}
+
+void MyWebServer::AppendObservation(EntityKind kind, int id,
+    const std::string& text,
+    std::map<MyWebServerSession*, std::string>* frames) const {
+    // Entities nobody watches anymore have no subscribers and are skipped
+    const std::vector<MyWebServerSession*>* sessions =
+      watchers[kind].GetSubscribers(id);
+    if (!sessions) {
+        return;
+    }
+    for (int i = 0; i < static_cast<int>(sessions->size()); i++) {
+        std::string& frame = (*frames)[(*sessions)[i]];
+        frame += frame.empty() ? "{\"command\":\"observe\",\"observations\":["
+                               : ",";
+        frame += text;
+    }
+}
@@ -6,20 +6,216 @@
 #ifndef WEB_CODE_WEB_MY_WEB_SERVER_H_
 #define WEB_CODE_WEB_MY_WEB_SERVER_H_
 
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "src/cluster_grid.h"
+#include "src/event_bus.h"
+#include "src/name_table.h"
+#include "src/spatial_grid.h"
 #include "web_code/web/web_interface.h"
+#include "web_code/web/batch_queue.h"
+#include "web_code/web/subscription_registry.h"
+#include "web_code/web/triple_buffer.h"
+
+class Route;
+class MyWebServerSession;
+class VisualizationSimulator;
+
+// Kind of entity a session can watch with listenBus or listenStop
+enum EntityKind {
+    kBusEntity,
+    kStopEntity
+};
+
+// Immutable copy of the simulation state at the end of a tick
+struct SimulationSnapshot {
+    SimulationSnapshot() : busses(std::vector<BusData>(0)),
+        routes(std::vector<RouteData>(0)), bussesVersion(0),
+        routesVersion(0), visibleVersion(0), clustersVersion(0) {}
+    std::vector<BusData> busses;
+    // Only the ids and waiting counts, the geometry is sent separately
+    std::vector<RouteData> routes;
+    // Bumped whenever busses or routes changed, so the web thread knows
+    // when to serialize them again
+    int bussesVersion;
+    int routesVersion;
+    // Busses inside each session viewport, by viewport slot, and a version
+    // bumped whenever any of them changed
+    std::map<int, std::vector<BusData> > visibleBusses;
+    int visibleVersion;
+    // Clusters of every detail level above 0, by level - 1
+    std::vector<std::vector<ClusterTile> > clusters;
+    int clustersVersion;
+};
+
+// Raw data of the watched buses and stops notified during a tick,
+// formatted by the web server thread
+struct Observations {
+    std::vector<BusData> busses;
+    std::vector<StopData> stops;
+    void swap(Observations& other) {
+        busses.swap(other.busses);
+        stops.swap(other.stops);
+    }
+};
+
+// Level 0 sends every bus and stop, the levels above send clusters of grid
+// cells growing 4 times wider per level
+static const int kNumDetailLevels = 4;
 
 class MyWebServer : public WebInterface {
  public:
      MyWebServer();
      ~MyWebServer() {}
 
+    // The simulation the watched buses and stops are observed on
+    void SetSimulator(VisualizationSimulator* sim) { this->sim = sim; }
+    // The names of the network of the simulation, the ids sent to the
+    // clients are turned back into them, NameTable::GetDefault by default
+    void SetNames(const NameTable* names) { this->names = names; }
+    const NameTable& GetNames() const { return *names; }
+
+    // Simulation thread: collect the updates of a tick, then publish them
     void UpdateRoute(const RouteData& route, bool deleted = false) override;
     void UpdateBus(const BusData& bus, bool deleted = false) override;
+    void Publish() override;
 
-    std::vector<RouteData> routes;
+    // Route geometry never changes after the config is read, so it is
+    // serialized once and the same buffer is sent to every session
+    void InitRouteGeometry(const std::vector<Route *>& routeList);
+    const std::string& GetRouteGeometry() const { return routeGeometry; }
+
+    // Web server thread: serialized views of the latest snapshot, only
+    // re-serialized when the snapshot changed
+    const std::string& GetRouteOccupancy();
+    const std::string& GetBusses();
+
+    // Web server thread: sessions subscribed to the frames pushed by the
+    // server clock
+    void RemoveSession(MyWebServerSession* session);
+    void Subscribe(MyWebServerSession* session);
+    // Send the latest frame to every subscriber, if anything changed
+    void PushFrame();
+
+    // Web server thread: only send a session the busses and stops inside a
+    // box, grown by a margin so short pans do not pop, instead of the whole
+    // network. Clearing it goes back to the shared full frames
+    void SetViewport(MyWebServerSession* session, const BoundingBox& box);
+    void ClearViewport(MyWebServerSession* session);
+    // Web server thread: pick the detail level of a session from the zoom
+    // of its map, zoomed out sessions get clusters instead of entities
+    void SetZoom(MyWebServerSession* session, int zoom);
+    static int GetDetailLevel(int zoom);
+    static double GetClusterCellSize(int level);
+
+    // Web server thread: make a session watch a single bus or stop, the
+    // entity is only observed while at least one session watches it
+    void Watch(MyWebServerSession* session, EntityKind kind, int id);
+
+    // Simulation thread: event handlers recording the data of a watched
+    // entity, it is published with the rest of the tick
+    void OnBusMoved(const BusMovedEvent& event) {
+        observed.busses.push_back(event.bus);
+    }
+    void OnStopCountChanged(const StopCountChangedEvent& event) {
+        observed.stops.push_back(event.stop);
+    }
+
+    // Web server thread: format the observations of the ticks published
+    // since the last call, and send every session a single frame with all
+    // of them
+    void FlushObservations();
+
+ private:
+    // What a session with a viewport sees, and was sent last
+    struct SessionView {
+        int slot;  // key of its busses in SimulationSnapshot::visibleBusses
+        // Indices of the stops in the viewport, by interned route name
+        std::map<int, std::vector<int> > stops;
+        int bussesVersion;
+        int routesVersion;
+    };
+
+    // Detail level of a session and the clusters it was sent last
+    struct SessionDetail {
+        int level;
+        int clustersVersion;
+    };
+
+    void Refresh();
+    void SendView(MyWebServerSession* session, SessionView* view);
+    void SendClusters(MyWebServerSession* session, SessionDetail* detail);
+    // Send a session every bus and stop again, after clusters
+    void SendEntities(MyWebServerSession* session);
+    // Simulation thread: fill visibleBusses from the bus grid
+    void CullBusses();
+    // Simulation thread: put the stops of a route into the clusters, all of
+    // them or only those whose waiting count changed
+    void UpdateStopClusters(const RouteData& rData, bool all, bool deleted);
+    void Unwatch(EntityKind kind, int id);
+    void AppendObservation(EntityKind kind, int id, const std::string& text,
+        std::map<MyWebServerSession*, std::string>* frames) const;
+
+    // Owned by the simulation thread
+    std::vector<const RouteData *> routes;
     std::vector<BusData> busses;
+    int bussesVersion;
+    int routesVersion;
+    Observations observed;
+    // Every bus by position, moved as UpdateBus reports it, the index of
+    // each bus in busses by id, and the viewports to cull for by slot
+    SpatialGrid busGrid;
+    std::vector<int> busIndex;
+    std::map<int, BoundingBox> viewports;
+    std::map<int, std::vector<BusData> > visibleBusses;
+    int visibleVersion;
+    int culledBussesVersion;
+    bool viewportsChanged;
+    // Busses and stop queues summed up per detail level above 0, updated
+    // with every bus and route update
+    std::vector<ClusterGrid> clusterGrids;
+    std::vector<std::vector<ClusterTile> > clusterTiles;
+    bool clustersChanged;
+    int clustersVersion;
+
+    TripleBuffer<SimulationSnapshot> snapshots;
+    // Observations go their own way, a snapshot the web thread skips must
+    // not take them along
+    BatchQueue<Observations> observations;
+
+    // Owned by the web server thread
+    std::string routeGeometry;
+    std::string routeOccupancy;
+    int routeOccupancyVersion;
+    std::string bussesJSON;
+    int bussesJSONVersion;
+    std::set<MyWebServerSession*> subscribers;
+    bool frameDirty;  // set when routes or busses changed since last push
+    const SimulationSnapshot* front;  // set by Refresh
+
+    SubscriptionRegistry<MyWebServerSession*> watchers[2];  // by EntityKind
+
+    // Every route stop by position, keyed by its index in routeStops, which
+    // holds its interned route name and its index on the route. Built with
+    // the route geometry and never changed, so any thread may read it
+    SpatialGrid stopGrid;
+    std::vector<std::pair<int, int> > routeStops;
+    std::map<MyWebServerSession*, SessionView> views;
+    int nextViewportSlot;
+    // Sessions above detail level 0, and the clusters of each level
+    // serialized once for all of them
+    std::map<MyWebServerSession*, SessionDetail> details;
+    std::string clustersJSON[kNumDetailLevels];
+    int clustersJSONVersion[kNumDetailLevels];
+
+    // The watched entities are subscribed to on its event bus
+    VisualizationSimulator* sim;
+    const NameTable* names;  // not owned
+
 };
 
 #endif  // WEB_CODE_WEB_MY_WEB_SERVER_H_
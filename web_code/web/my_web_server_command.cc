@@ -6,9 +6,10 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <sstream>
+#include <cctype>
 #include <string>
 #include "web_code/web/my_web_server_command.h"
+#include "src/name_table.h"
 
 /*******************************************************************************
  * Member Functions
@@ -20,48 +21,8 @@ void GetRoutesCommand::execute(MyWebServerSession* session,
     (void)command;
     (void)state;
 
-    std::vector<RouteData> routes = myWS->routes;
-
-    // std::cout << "Updating routes" << std::endl;
-
-    picojson::object data;
-    data["command"] = picojson::value("updateRoutes");
-
-    picojson::array routesArray;
-
-    // Get and store information for all routes
-    for (int i = 0; i < static_cast<int>(routes.size()); i++) {
-        picojson::object r;
-        r["id"] = picojson::value(routes[i].id);
-
-        picojson::array stopArray;
-        for (int j = 0; j < static_cast<int>(routes[i].stops.size()); j++) {
-            picojson::object stopStruct;
-            // Get stop name
-            stopStruct["id"] = picojson::value(routes[i].stops[j].id);
-            // Get number of people waiting at the stop
-            stopStruct["numPeople"] = picojson::value
-              (static_cast<double>(routes[i].stops[j].num_people));
-
-            picojson::object pStruct;
-            // Get position of the stop
-            pStruct["x"] = picojson::value(routes[i].stops[j].position.x);
-            pStruct["y"] = picojson::value(routes[i].stops[j].position.y);
-
-            stopStruct["position"] = picojson::value(pStruct);
-
-            stopArray.push_back(picojson::value(stopStruct));
-        }
-
-        r["stops"] = picojson::value(stopArray);
-        routesArray.push_back(picojson::value(r));
-    }
-
-    data["routes"] = picojson::value(routesArray);
-
-    picojson::value ret(data);
-
-    session->sendJSON(ret);
+    // Stop geometry was sent with initRoutes, only occupancy goes here
+    session->sendMessage(myWS->GetRouteOccupancy());
 }
 
 GetBussesCommand::GetBussesCommand(MyWebServer* ws) : myWS(ws) {}
@@ -71,52 +32,8 @@ void GetBussesCommand::execute(MyWebServerSession* session,
     (void)command;
     (void)state;
 
-    std::vector<BusData> busses = myWS->busses;
-
-    // std::cout << "Updating Busses" << std::endl;
-
-    picojson::object data;
-    data["command"] = picojson::value("updateBusses");
-
-    picojson::array bussesArray;
-
-    // Get and store information for all buses
-    for (int i = 0; i < static_cast<int>(busses.size()); i++) {
-        picojson::object s;
-        // Get store bus name
-        s["id"] = picojson::value(busses[i].id);
-        // Get the number of passengers on the bus
-        s["numPassengers"] = picojson::value
-          (static_cast<double>(busses[i].num_passengers));
-        // Get bus capacity
-        s["capacity"] = picojson::value
-          (static_cast<double>(busses[i].capacity));
-
-        picojson::object pStruct;
-        // Get stop position
-        pStruct["x"] = picojson::value(busses[i].position.x);
-        pStruct["y"] = picojson::value(busses[i].position.y);
-        s["position"] = picojson::value(pStruct);
-
-        picojson::object cStruct;
-        cStruct["red"] =
-        picojson::value(static_cast<double>(busses[i].color.red));
-        cStruct["green"] =
-        picojson::value(static_cast<double>(busses[i].color.green));
-        cStruct["blue"] =
-        picojson::value(static_cast<double>(busses[i].color.blue));
-        cStruct["alpha"] =
-        picojson::value(static_cast<double>(busses[i].color.alpha));
-        s["color"] = picojson::value(cStruct);
-
-        bussesArray.push_back(picojson::value(s));
-    }
-
-    data["busses"] = picojson::value(bussesArray);
-
-    picojson::value ret(data);
-
-    session->sendJSON(ret);
+    // Serialized once per change and shared by every session
+    session->sendMessage(myWS->GetBusses());
 }
 
 StartCommand::StartCommand(VisualizationSimulator* sim) :
@@ -146,117 +63,244 @@ void StartCommand::execute(MyWebServerSession* session,
                   << timeBetweenBusses[i] << std::endl;
     }
 
+    // Optional color policy of every line, "gold-maroon" paints its busses
+    // gold on the way out, anything else keeps the maroon-gold default
+    std::vector<Bus::ColorPolicy> colorPolicies;
+    picojson::value policies =
+      command.get<picojson::object>()["colorPolicies"];
+    if (policies.is<picojson::array>()) {
+        const picojson::array& names = policies.get<picojson::array>();
+        for (int i = 0; i < static_cast<int>(names.size()); i++) {
+            Bus::ColorPolicy policy = NULL;
+            if (names[i].is<std::string>()
+                && names[i].get<std::string>() == "gold-maroon") {
+                policy = &GoldMaroonColorPolicy::Apply<Bus>;
+            }
+            colorPolicies.push_back(policy);
+        }
+    }
+
     std::cout << "Number of time steps for simulation is: "
               << numTimeSteps
               << std::endl;
     std::cout << "Starting simulation" << std::endl;
 
-    mySim->Start(timeBetweenBusses, numTimeSteps);
+    // Applied by the simulation thread between two ticks
+    VisualizationSimulator* sim = mySim;
+    std::vector<int> busTimings = timeBetweenBusses;
+    int timeSteps = numTimeSteps;
+    mySim->Post([sim, busTimings, timeSteps, colorPolicies]() {
+        for (int i = 0; i < static_cast<int>(busTimings.size()); i++) {
+            sim->SetColorPolicy(i, i < static_cast<int>(colorPolicies.size())
+                                   ? colorPolicies[i] : NULL);
+        }
+        sim->Start(busTimings, timeSteps);
+    });
 }
 
-UpdateCommand::UpdateCommand(VisualizationSimulator* sim): mySim(sim) {}
+SubscribeCommand::SubscribeCommand(MyWebServer* ws) : myWS(ws) {}
 
-void UpdateCommand::execute(MyWebServerSession* session,
+void SubscribeCommand::execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) {
-    (void)session;
     (void)state;
     (void)command;
 
-    mySim->Update();
+    // Frames are now pushed to this session by the server clock
+    myWS->Subscribe(session);
 }
 
 PauseCommand::PauseCommand(VisualizationSimulator* sim) : mySim(sim) {}
 
 void PauseCommand::execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) {
-    mySim->TogglePause();
+    VisualizationSimulator* sim = mySim;
+    mySim->Post([sim]() { sim->TogglePause(); });
 }
 
-// Calls to Notify function to notify the observer
-// about the observed bus information.
-class BusWebObserver : public IObserver<BusData *> {
- public:
-    explicit BusWebObserver(MyWebServerSession* session) : session(session) {}
-    // This normally called update, but we call it Notify per the lab writeup
-    void Notify(BusData* info) {
-        picojson::object data;
-        data["command"] = picojson::value("observeBus");
-        std::stringstream ss;
-        ss << "Bus " << info->id << "\n";
-        ss << "-----------------------------\n";
-        ss << "  * Position: (" << info->position.x
-           << "," << info->position.y << ")\n";
-        ss << "  * Passengers: " << info->num_passengers << "\n";
-        ss << "  * Capacity: " << info->capacity << "\n";
-        data["text"] = picojson::value(ss.str());
-        picojson::value ret(data);
-        session->sendJSON(ret);
-    }
- private:
-    MyWebServerSession* session;
-};
-
-AddBusListenerCommand::AddBusListenerCommand(VisualizationSimulator* sim) :
-    mySim(sim) {}
+AddBusListenerCommand::AddBusListenerCommand(MyWebServer* ws) :
+    myWS(ws) {}
 
 void AddBusListenerCommand::execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) {
-    mySim->ClearBusListeners();
+    (void)state;
     std::cout << "starting AddBusListenerCommand::execute" << std::endl;
     std::string id = command.get<picojson::object>()["id"].get<std::string>();
     std::cout << id << std::endl;
-    mySim->AddBusListener(&id, new BusWebObserver(session));
+    // Only replaces the bus this session watches, other sessions keep theirs
+    myWS->Watch(session, kBusEntity, myWS->GetNames().Find(id));
 }
 
-// Calls to Notify function to notify the observer
-// about the observed stop information.
-class StopWebObserver : public IObserver<StopData *> {
- public:
-    explicit StopWebObserver(MyWebServerSession* session) : session(session) {}
-    // This normally called update, but we call it Notify per the lab writeup
-    void Notify(StopData* info) {
-        picojson::object data;
-        data["command"] = picojson::value("observeStop");
-        std::stringstream ss;
-        ss << "Stop " << info->id << "\n";
-        ss << "-----------------------------\n";
-        ss << "  * Position: (" << info->position.x
-           << "," << info->position.y << ")\n";
-        ss << "  * Passengers: " << info->num_people << "\n";
-        data["text"] = picojson::value(ss.str());
-        picojson::value ret(data);
-        session->sendJSON(ret);
-    }
- private:
-    MyWebServerSession* session;
-};
-
-AddStopListenerCommand::AddStopListenerCommand(VisualizationSimulator* sim) :
-    mySim(sim) {}
+AddStopListenerCommand::AddStopListenerCommand(MyWebServer* ws) :
+    myWS(ws) {}
 
 void AddStopListenerCommand::execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) {
-    mySim->ClearStopListeners();
+    (void)state;
     std::cout << "starting AddStopListenerCommand::execute" << std::endl;
     std::string id = command.get<picojson::object>()["id"].get<std::string>();
     std::cout << id << std::endl;
-    mySim->AddStopListener(&id, new StopWebObserver(session));
+    // Only replaces the stop this session watches, other sessions keep theirs
+    myWS->Watch(session, kStopEntity, myWS->GetNames().Find(id));
 }
 
-InitRoutesCommand::InitRoutesCommand(ConfigManager* configManager) :
-    cm(configManager) {}
+InitRoutesCommand::InitRoutesCommand(MyWebServer* ws) : myWS(ws) {}
 
 void InitRoutesCommand::execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) {
     (void)state;
     (void)command;
 
-    int  numRoutes = static_cast<int>(cm->GetRoutes().size());
+    // The geometry is serialized once and shared by every session
+    session->sendMessage(myWS->GetRouteGeometry());
+}
+
+SetViewportCommand::SetViewportCommand(MyWebServer* ws) : myWS(ws) {}
+
+void SetViewportCommand::execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) {
+    (void)state;
+
+    // Bounds in the coordinates of the positions sent, all four or none
+    picojson::object& args = command.get<picojson::object>();
+    const char* names[4] = {"minX", "minY", "maxX", "maxY"};
+    double bounds[4];
+    for (int i = 0; i < 4; i++) {
+        picojson::object::iterator it = args.find(names[i]);
+        if (it == args.end() || !it->second.is<double>()) {
+            myWS->ClearViewport(session);
+            return;
+        }
+        bounds[i] = it->second.get<double>();
+    }
+    myWS->SetViewport(session,
+                      BoundingBox(bounds[0], bounds[1], bounds[2], bounds[3]));
+}
+
+SetZoomCommand::SetZoomCommand(MyWebServer* ws) : myWS(ws) {}
+
+void SetZoomCommand::execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) {
+    (void)state;
+
+    // Map zoom level, as in web map tiles
+    picojson::object& args = command.get<picojson::object>();
+    picojson::object::iterator it = args.find("zoom");
+    if (it == args.end() || !it->second.is<double>()) {
+        return;
+    }
+    myWS->SetZoom(session, static_cast<int>(it->second.get<double>()));
+}
 
+// File of a checkpoint named by a client, the name is a plain word so a
+// client cannot reach outside the working directory
+static bool CheckpointPath(picojson::value& command, std::string * path) {
+    std::string name = "checkpoint";
+    picojson::object& args = command.get<picojson::object>();
+    picojson::object::iterator it = args.find("name");
+    if (it != args.end() && it->second.is<std::string>()) {
+        name = it->second.get<std::string>();
+    }
+    if (name.empty() || name.size() > 64) {
+        return false;
+    }
+    for (int i = 0; i < static_cast<int>(name.size()); i++) {
+        if (!std::isalnum(static_cast<unsigned char>(name[i]))
+            && name[i] != '_' && name[i] != '-') {
+            return false;
+        }
+    }
+    *path = name + ".ckpt";
+    return true;
+}
+
+SaveCommand::SaveCommand(VisualizationSimulator* sim) : mySim(sim) {}
+
+void SaveCommand::execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) {
+    (void)session;
+    (void)state;
+
+    std::string path;
+    if (!CheckpointPath(command, &path)) {
+        std::cerr << "save: bad checkpoint name" << std::endl;
+        return;
+    }
+    // Copied between two ticks, written to disk in the background
+    VisualizationSimulator* sim = mySim;
+    mySim->Post([sim, path]() {
+        std::string error;
+        if (!sim->SaveCheckpoint(path, &error)) {
+            std::cerr << path << ": " << error << std::endl;
+        }
+    });
+}
+
+LoadCommand::LoadCommand(VisualizationSimulator* sim) : mySim(sim) {}
+
+void LoadCommand::execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) {
+    (void)session;
+    (void)state;
+
+    std::string path;
+    if (!CheckpointPath(command, &path)) {
+        std::cerr << "load: bad checkpoint name" << std::endl;
+        return;
+    }
+    VisualizationSimulator* sim = mySim;
+    mySim->Post([sim, path]() {
+        std::string error;
+        if (!sim->LoadCheckpoint(path, &error)) {
+            std::cerr << path << ": " << error << std::endl;
+        }
+    });
+}
+
+static picojson::value FormatPercentiles(const WaitPercentiles& percentiles) {
     picojson::object data;
-    data["command"] = picojson::value("initRoutes");
-    data["numRoutes"] = picojson::value(static_cast<double>(numRoutes));
+    data["count"] = picojson::value(static_cast<double>(percentiles.count));
+    data["mean"] = picojson::value(percentiles.mean);
+    data["p50"] = picojson::value(static_cast<double>(percentiles.p50));
+    data["p95"] = picojson::value(static_cast<double>(percentiles.p95));
+    data["p99"] = picojson::value(static_cast<double>(percentiles.p99));
+    data["max"] = picojson::value(static_cast<double>(percentiles.max));
+    return picojson::value(data);
+}
 
-    picojson::value ret(data);
-    session->sendJSON(ret);
+WaitStatsCommand::WaitStatsCommand(VisualizationSimulator* sim) :
+    mySim(sim) {}
+
+void WaitStatsCommand::execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) {
+    (void)command;
+    (void)state;
+
+    // Summarized under the lock of the statistics, the simulation thread
+    // goes on ticking
+    std::vector<WaitSummary> summaries =
+        mySim->GetWaitStatistics().GetSummaries();
+    picojson::object data;
+    data["command"] = picojson::value("waitStats");
+    picojson::array routes;
+    picojson::array stops;
+    for (int i = 0; i < static_cast<int>(summaries.size()); i++) {
+        const WaitSummary& summary = summaries[i];
+        picojson::object s;
+        s["waitAtStop"] = FormatPercentiles(summary.waitAtStop);
+        s["ride"] = FormatPercentiles(summary.ride);
+        s["total"] = FormatPercentiles(summary.total);
+        if (summary.scope == WaitSummary::kNetwork) {
+            data["network"] = picojson::value(s);
+            continue;
+        }
+        s["id"] = picojson::value(mySim->GetNames().GetName(summary.id));
+        if (summary.scope == WaitSummary::kRoute) {
+            routes.push_back(picojson::value(s));
+        } else {
+            stops.push_back(picojson::value(s));
+        }
+    }
+    data["routes"] = picojson::value(routes);
+    data["stops"] = picojson::value(stops);
+    session->sendMessage(picojson::value(data).serialize());
 }
@@ -41,7 +41,7 @@ class MyWebServerCommand {
  * @brief The main class for GetRoutes command in Command Pattern.
  *
  * Calls to \ref execute function to invoke the callback to
- * get route information.
+ * get the number of people waiting at every stop.
  */
 class GetRoutesCommand : public MyWebServerCommand {
  public:
@@ -84,17 +84,18 @@ class StartCommand : public MyWebServerCommand {
 };
 
 /**
- * @brief The main class for Update command in Command Pattern.
+ * @brief The main class for Subscribe command in Command Pattern.
  *
- * Calls to \ref execute function to invoke the callback to update the simulation.
+ * Calls to \ref execute function to invoke the callback to receive the
+ * frames pushed by the server clock, instead of polling for them.
  */
-class UpdateCommand : public MyWebServerCommand {
+class SubscribeCommand : public MyWebServerCommand {
  public:
-  explicit UpdateCommand(VisualizationSimulator* sim);
+  explicit SubscribeCommand(MyWebServer* ws);
   void execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) override;
  private:
-  VisualizationSimulator* mySim;
+  MyWebServer* myWS;
 };
 
 /**
@@ -120,11 +121,11 @@ class PauseCommand : public MyWebServerCommand {
  */
 class AddBusListenerCommand: public MyWebServerCommand {
  public:
-  explicit AddBusListenerCommand(VisualizationSimulator* sim);
+  explicit AddBusListenerCommand(MyWebServer* ws);
   void execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) override;
  private:
-  VisualizationSimulator* mySim;
+  MyWebServer* myWS;
 };
 
 /**
@@ -136,26 +137,102 @@ class AddBusListenerCommand: public MyWebServerCommand {
  */
 class AddStopListenerCommand: public MyWebServerCommand {
  public:
-  explicit AddStopListenerCommand(VisualizationSimulator* sim);
+  explicit AddStopListenerCommand(MyWebServer* ws);
   void execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) override;
  private:
-  VisualizationSimulator* mySim;
+  MyWebServer* myWS;
 };
 
 /**
  * @brief The main class for InitRoutes command in Command Pattern.
  *
  * Calls to \ref execute function to invoke the callback to
- * initialize the routes.
+ * initialize the routes, sending the pre-serialized route geometry.
  */
 class InitRoutesCommand : public MyWebServerCommand {
  public:
-  explicit InitRoutesCommand(ConfigManager* cm);
+  explicit InitRoutesCommand(MyWebServer* ws);
   void execute(MyWebServerSession* session,
     picojson::value& command, MyWebServerSessionState* state) override;
  private:
-  ConfigManager* cm;
+  MyWebServer* myWS;
+};
+
+/**
+ * @brief The main class for SetViewport command in Command Pattern.
+ *
+ * Calls to \ref execute function to invoke the callback to only receive
+ * the busses and stops inside a box, or everything again without one.
+ */
+class SetViewportCommand : public MyWebServerCommand {
+ public:
+  explicit SetViewportCommand(MyWebServer* ws);
+  void execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) override;
+ private:
+  MyWebServer* myWS;
+};
+
+/**
+ * @brief The main class for SetZoom command in Command Pattern.
+ *
+ * Calls to \ref execute function to invoke the callback to pick the
+ * detail level from the zoom of the map, clusters when zoomed out.
+ */
+class SetZoomCommand : public MyWebServerCommand {
+ public:
+  explicit SetZoomCommand(MyWebServer* ws);
+  void execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) override;
+ private:
+  MyWebServer* myWS;
+};
+
+/**
+ * @brief The main class for Save command in Command Pattern.
+ *
+ * Calls to \ref execute function to invoke the callback to save the run
+ * as a checkpoint, named by the client and kept in the working directory.
+ */
+class SaveCommand : public MyWebServerCommand {
+ public:
+  explicit SaveCommand(VisualizationSimulator* sim);
+  void execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) override;
+ private:
+  VisualizationSimulator* mySim;
+};
+
+/**
+ * @brief The main class for Load command in Command Pattern.
+ *
+ * Calls to \ref execute function to invoke the callback to replace the
+ * run with a checkpoint saved by the Save command.
+ */
+class LoadCommand : public MyWebServerCommand {
+ public:
+  explicit LoadCommand(VisualizationSimulator* sim);
+  void execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) override;
+ private:
+  VisualizationSimulator* mySim;
+};
+
+/**
+ * @brief The main class for WaitStats command in Command Pattern.
+ *
+ * Calls to \ref execute function to invoke the callback to get the
+ * percentiles of the passenger wait, ride and total times so far, for the
+ * network, every route and every stop.
+ */
+class WaitStatsCommand : public MyWebServerCommand {
+ public:
+  explicit WaitStatsCommand(VisualizationSimulator* sim);
+  void execute(MyWebServerSession* session,
+    picojson::value& command, MyWebServerSessionState* state) override;
+ private:
+  VisualizationSimulator* mySim;
 };
 
 #endif  // WEB_CODE_WEB_MY_WEB_SERVER_COMMAND_H_
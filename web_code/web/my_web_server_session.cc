@@ -8,7 +8,14 @@
 
 #include "web_code/web/my_web_server_session.h"
 #include "web_code/web/my_web_server_command.h"
+#include "web_code/web/my_web_server.h"
 
+MyWebServerSession::~MyWebServerSession() {
+    // Stop pushing frames and watched entities to a closed session
+    if (state.webServer) {
+        state.webServer->RemoveSession(this);
+    }
+}
 
 void MyWebServerSession::receiveJSON(picojson::value& val) {
     std::string cmd = val.get<picojson::object>()["command"].get<std::string>();
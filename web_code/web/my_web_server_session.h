@@ -13,7 +13,7 @@
 class MyWebServerSession : public JSONSession {
  public:
      explicit MyWebServerSession(MyWebServerSessionState s) : state(s) {}
-    ~MyWebServerSession() {}
+    ~MyWebServerSession();
 
     void receiveJSON(picojson::value& val) override;
     void update() override {}
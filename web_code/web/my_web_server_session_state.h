@@ -10,11 +10,15 @@
 #include <map>
 
 class MyWebServerCommand;
+class MyWebServer;
 
 struct MyWebServerSessionState {
     MyWebServerSessionState() : commands(std::map<std::string,
-                                         MyWebServerCommand*>()) {}
+                                         MyWebServerCommand*>()),
+                                webServer(nullptr) {}
     std::map<std::string, MyWebServerCommand*> commands;
+    // Drops the subscriptions of a closed session
+    MyWebServer* webServer;
 };
 
 #endif  // WEB_CODE_WEB_MY_WEB_SERVER_SESSION_STATE_H_
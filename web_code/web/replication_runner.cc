@@ -0,0 +1,158 @@
+/**
+ * @file replication_runner.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+
+#include "web_code/web/replication_runner.h"
+
+ReplicationRunner::ReplicationRunner(const SweepRunner& runner,
+                                     const ReplicationOptions& options) :
+  runner_(runner), options_(options), pool_(options.numThreads) {
+  options_.maxReplications = std::max(1, options_.maxReplications);
+  options_.minReplications = std::max(2, options_.minReplications);
+}
+
+ReplicationResult ReplicationRunner::Run(const Scenario& scenario,
+                                         std::ostream * progress) {
+  ReplicationResult result;
+  result.scenario = scenario;
+  result.replications = 0;
+  result.converged = false;
+
+  // Filled by the tasks, every one of them is waited for before returning
+  int pairSize = options_.antithetic ? 2 : 1;
+  int numRuns = options_.maxReplications * pairSize;
+  std::vector<ScenarioResult> runs(numRuns);
+  std::vector<char> done(numRuns, 0);
+  std::mutex mutex;  // guards done
+  std::condition_variable finished;
+  std::atomic<bool> stopping(false);
+
+  int submitted = 0;
+  auto submit = [&]() {
+    int i = submitted++;
+    Scenario replica = scenario;
+    replica.seed = scenario.seed + i / pairSize;
+    if (options_.antithetic) {
+      replica.antithetic = i % 2 != 0;
+    }
+    pool_.Submit([&, i, replica]() {
+      // Queued past the stopping point, the replication is not needed
+      ScenarioResult run;
+      if (!stopping) {
+        run = runner_.RunScenario(replica);
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      runs[i] = run;
+      done[i] = 1;
+      finished.notify_all();
+    });
+  };
+  // One run ahead per thread, a new one once one is folded
+  while (submitted < numRuns && submitted < pool_.GetNumThreads()) {
+    submit();
+  }
+
+  for (int i = 0; i < numRuns; i += pairSize) {
+    // The mean of the runs of the replication
+    double meanWait = 0;
+    double maxQueue = 0;
+    double meanLoad = 0;
+    for (int j = i; j < i + pairSize; j++) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return done[j] != 0; });
+      }
+      const ScenarioResult& run = runs[j];
+      if (!run.error.empty()) {
+        result.error = run.error;
+        break;
+      }
+      meanWait += run.summary.meanWait / pairSize;
+      maxQueue += run.summary.maxQueue * 1.0 / pairSize;
+      meanLoad += run.summary.meanLoad / pairSize;
+    }
+    if (!result.error.empty()) {
+      break;
+    }
+    result.meanWait.Add(meanWait);
+    result.maxQueue.Add(maxQueue);
+    result.meanLoad.Add(meanLoad);
+    result.waits.push_back(meanWait);
+    result.replications++;
+
+    if (progress) {
+      *progress << scenario.name << " replication " << result.replications
+                << ": mean_wait " << result.meanWait.GetMean() << " +- "
+                << result.meanWait.GetHalfWidth()
+                << ", max_queue " << result.maxQueue.GetMean() << " +- "
+                << result.maxQueue.GetHalfWidth()
+                << ", mean_load " << result.meanLoad.GetMean() << " +- "
+                << result.meanLoad.GetHalfWidth() << std::endl;
+    }
+    if (result.replications >= options_.minReplications && IsNarrow(result)) {
+      result.converged = true;
+      break;
+    }
+    while (submitted < numRuns && submitted < i + pairSize
+                                              + pool_.GetNumThreads()) {
+      submit();
+    }
+  }
+
+  stopping = true;
+  pool_.Wait();
+  return result;
+}
+
+bool ReplicationRunner::IsNarrow(const ReplicationResult& result) const {
+  if (options_.relativeWidth <= 0) {
+    return false;
+  }
+  const RunningStats * stats[3] = {
+    &result.meanWait, &result.maxQueue, &result.meanLoad
+  };
+  for (int i = 0; i < 3; i++) {
+    if (stats[i]->GetHalfWidth()
+        > options_.relativeWidth * std::fabs(stats[i]->GetMean())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ReplicationRunner::WriteTable(
+    std::ostream& out, const std::vector<ReplicationResult>& results) {
+  out << "name,headways,strategy,demand_scale,seed,steps,arrivals,"
+      << "antithetic,replications,mean_wait,mean_wait_ci,max_queue,"
+      << "max_queue_ci,mean_load,mean_load_ci,vs_first_mean_wait,"
+      << "vs_first_mean_wait_ci,converged,error" << std::endl;
+  for (int i = 0; i < static_cast<int>(results.size()); i++) {
+    const ReplicationResult& result = results[i];
+    // Replications of the same seeds as the first scenario, paired
+    RunningStats difference;
+    const std::vector<double>& first = results[0].waits;
+    for (int j = 0; j < static_cast<int>(result.waits.size())
+                    && j < static_cast<int>(first.size()); j++) {
+      difference.Add(result.waits[j] - first[j]);
+    }
+    SweepRunner::WriteScenario(out, result.scenario);
+    out << "," << result.replications
+        << "," << result.meanWait.GetMean()
+        << "," << result.meanWait.GetHalfWidth()
+        << "," << result.maxQueue.GetMean()
+        << "," << result.maxQueue.GetHalfWidth()
+        << "," << result.meanLoad.GetMean()
+        << "," << result.meanLoad.GetHalfWidth()
+        << "," << difference.GetMean()
+        << "," << difference.GetHalfWidth()
+        << "," << (result.converged ? 1 : 0)
+        << "," << result.error << std::endl;
+  }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file replication_runner.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_REPLICATION_RUNNER_H_
+#define WEB_CODE_WEB_REPLICATION_RUNNER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "web_code/web/sweep_runner.h"
+#include "src/running_stats.h"
+#include "src/thread_pool.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+struct ReplicationOptions {
+  ReplicationOptions() : maxReplications(30), minReplications(5),
+    relativeWidth(0.05), numThreads(0), antithetic(false) {}
+  int maxReplications;
+  // Fewest replications an interval is trusted from, at least 2
+  int minReplications;
+  // Stop once every interval is within this fraction of its mean, on both
+  // sides, 0 always runs maxReplications
+  double relativeWidth;
+  int numThreads;  // replications run at once, 0 for one per core
+  // Every replication is a pair of runs of one seed, the second with
+  // antithetic arrivals, and counts as the mean of the two
+  bool antithetic;
+};
+
+struct ReplicationResult {
+  Scenario scenario;
+  int replications;
+  // Across replications: mean wait at the stop, longest queue, mean bus
+  // load
+  RunningStats meanWait;
+  RunningStats maxQueue;
+  RunningStats meanLoad;
+  // Mean wait at the stop of every replication, in seed order, to compare
+  // scenarios replication by replication
+  std::vector<double> waits;
+  bool converged;  // stopped on the requested width
+  std::string error;
+};
+
+/**
+ * @brief Runs a scenario with one seed after another until the means of
+ * its outcome are known closely enough.
+ *
+ * Replications run in parallel, their results are folded in seed order, so
+ * the intervals and the point they stop at do not depend on the threads:
+ * a replication that ends before an earlier one waits for it. Seeds are the
+ * one of the scenario and the ones following it.
+ *
+ * With antithetic replications, each seed runs twice, with its arrivals
+ * and with their mirror, and the pair is one replication.
+ *
+ * Calls to \ref Run function to replicate a scenario.
+ * Calls to \ref WriteTable function to write the intervals of scenarios.
+ */
+class ReplicationRunner {
+ public:
+  ReplicationRunner(const SweepRunner& runner,
+                    const ReplicationOptions& options);
+ /**
+  * @brief Replicate a scenario.
+  *
+  * @param[in] progress Gets a line with the intervals so far after every
+  * replication folded, or NULL
+  */
+  ReplicationResult Run(const Scenario& scenario, std::ostream * progress);
+  /**
+  * @brief Write the intervals of scenarios as a CSV table.
+  *
+  * The difference of every mean wait from the one of the first scenario
+  * is estimated from the differences of replications of the same seed,
+  * which with common arrivals is much narrower than the intervals of the
+  * two means.
+  */
+  static void WriteTable(std::ostream& out,
+                         const std::vector<ReplicationResult>& results);
+
+ private:
+  // Whether every interval is narrow enough to stop
+  bool IsNarrow(const ReplicationResult& result) const;
+  const SweepRunner& runner_;
+  ReplicationOptions options_;
+  ThreadPool pool_;
+};
+
+#endif  // WEB_CODE_WEB_REPLICATION_RUNNER_H_
@@ -0,0 +1,83 @@
+/**
+ * @file run_metrics.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include <algorithm>
+
+#include "web_code/web/run_metrics.h"
+
+RunMetrics::RunMetrics() : totalPassengers_(0), totalCapacity_(0),
+  loadSum_(0), loadTicks_(0), maxQueue_(0), delivered_(0), waitSum_(0),
+  tripTimeSum_(0),
+  maxTripTime_(0), trips_(0) {
+}
+
+void RunMetrics::UpdateBus(const BusData& bus, bool deleted) {
+  if (bus.id < 0) {
+    return;
+  }
+  if (bus.id >= static_cast<int>(busPassengers_.size())) {
+    busPassengers_.resize(bus.id + 1, 0);
+    busCapacity_.resize(bus.id + 1, 0);
+  }
+  totalPassengers_ -= busPassengers_[bus.id];
+  totalCapacity_ -= busCapacity_[bus.id];
+  if (deleted) {
+    busPassengers_[bus.id] = 0;
+    busCapacity_[bus.id] = 0;
+    trips_++;
+    return;
+  }
+  busPassengers_[bus.id] = bus.num_passengers;
+  busCapacity_[bus.id] = bus.capacity;
+  totalPassengers_ += bus.num_passengers;
+  totalCapacity_ += bus.capacity;
+}
+
+void RunMetrics::UpdateRoute(const RouteData& route, bool deleted) {
+  int waiting = 0;
+  for (int i = 0; i < static_cast<int>(route.num_people.size()); i++) {
+    waiting += route.num_people[i];
+    maxQueue_ = std::max(maxQueue_, route.num_people[i]);
+  }
+  routeWaiting_[route.id] = deleted ? 0 : waiting;
+}
+
+void RunMetrics::Publish() {
+  // Ticks without a bus on the road have no load
+  if (totalCapacity_ > 0) {
+    loadSum_ += static_cast<double>(totalPassengers_) / totalCapacity_;
+    loadTicks_++;
+  }
+}
+
+void RunMetrics::Attach(EventBus * events) {
+  events->Subscribe<PassengerAlightedEvent, RunMetrics,
+                    &RunMetrics::OnAlighted>(this);
+}
+
+void RunMetrics::OnAlighted(const PassengerAlightedEvent& event) {
+  delivered_++;
+  waitSum_ += event.wait_at_stop;
+  tripTimeSum_ += event.total_wait;
+  maxTripTime_ = std::max(maxTripTime_, event.total_wait);
+}
+
+RunSummary RunMetrics::GetSummary() const {
+  RunSummary summary;
+  summary.delivered = delivered_;
+  summary.meanWait = delivered_ > 0 ? waitSum_ / delivered_ : 0;
+  summary.meanTripTime = delivered_ > 0 ? tripTimeSum_ / delivered_ : 0;
+  summary.maxTripTime = maxTripTime_;
+  summary.maxQueue = maxQueue_;
+  summary.meanLoad = loadTicks_ > 0 ? loadSum_ / loadTicks_ : 0;
+  for (std::unordered_map<int, int>::const_iterator it =
+         routeWaiting_.begin();
+       it != routeWaiting_.end();
+       it++) {
+    summary.waitingAtEnd += it->second;
+  }
+  summary.trips = trips_;
+  return summary;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file run_metrics.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_RUN_METRICS_H_
+#define WEB_CODE_WEB_RUN_METRICS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <unordered_map>
+#include <vector>
+
+#include "web_code/web/web_interface.h"
+#include "src/event_bus.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+// Outcome of a run, times are in time steps
+struct RunSummary {
+  RunSummary() : delivered(0), meanWait(0), meanTripTime(0), maxTripTime(0),
+    maxQueue(0), meanLoad(0), waitingAtEnd(0), trips(0) {}
+  int delivered;  // passengers who got off at their stop
+  double meanWait;  // at the stop, of a delivered passenger
+  double meanTripTime;  // waiting plus riding, of a delivered passenger
+  int maxTripTime;
+  int maxQueue;  // most passengers waiting at one stop at once
+  double meanLoad;  // riding passengers over capacity, mean of the ticks
+  int waitingAtEnd;  // passengers still waiting at a stop
+  int trips;  // busses that finished their routes
+};
+
+/**
+ * @brief Web interface that measures a run instead of drawing it.
+ *
+ * Counts are kept up to date from the updates the simulation sends
+ * anyway, so measuring a tick costs no pass over the network.
+ *
+ * Calls to \ref Attach function to count the passengers who get off.
+ * Calls to \ref GetSummary function to get the outcome so far.
+ */
+class RunMetrics : public WebInterface {
+ public:
+  RunMetrics();
+  void UpdateBus(const BusData& bus, bool deleted = false) override;
+  void UpdateRoute(const RouteData& route, bool deleted = false) override;
+  void Publish() override;
+ /**
+  * @brief Subscribe to the passengers getting off, on the event bus of the
+  * simulation measured.
+  */
+  void Attach(EventBus * events);
+  RunSummary GetSummary() const;
+
+ private:
+  void OnAlighted(const PassengerAlightedEvent& event);
+
+  // Riding passengers and capacity of the busses on the road, by id
+  std::vector<int> busPassengers_;
+  std::vector<int> busCapacity_;
+  int totalPassengers_;
+  int totalCapacity_;
+  double loadSum_;
+  int loadTicks_;
+
+  // Waiting passengers of every route, by id
+  std::unordered_map<int, int> routeWaiting_;
+  int maxQueue_;
+
+  int delivered_;
+  double waitSum_;
+  double tripTimeSum_;
+  int maxTripTime_;
+  int trips_;
+};
+
+#endif  // WEB_CODE_WEB_RUN_METRICS_H_
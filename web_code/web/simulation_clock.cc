@@ -0,0 +1,98 @@
+/**
+ * @file simulation_clock.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include "web_code/web/simulation_clock.h"
+
+SimulationClock::SimulationClock(int periodMs) : fd_(-1), periodMs_(0) {
+  // Non blocking, so polling an idle clock returns right away
+  fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (fd_ < 0) {
+    std::cerr << "timerfd_create failed: " << std::strerror(errno)
+              << std::endl;
+    return;
+  }
+  SetPeriod(periodMs);
+}
+
+SimulationClock::~SimulationClock() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void SimulationClock::SetPeriod(int periodMs) {
+  periodMs_ = periodMs > 0 ? periodMs : 0;
+  if (fd_ < 0) {
+    return;
+  }
+
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = periodMs_ / 1000;
+  spec.it_interval.tv_nsec = (periodMs_ % 1000) * 1000000L;
+  // The first expiration is one full period from now
+  spec.it_value = spec.it_interval;
+  timerfd_settime(fd_, 0, &spec, NULL);
+}
+
+int SimulationClock::Expirations() {
+  if (fd_ < 0) {
+    return 0;
+  }
+
+  uint64_t expirations = 0;
+  // Fails with EAGAIN when no period elapsed since the last read
+  if (read(fd_, &expirations, sizeof(expirations))
+      != static_cast<ssize_t>(sizeof(expirations))) {
+    return 0;
+  }
+  return static_cast<int>(expirations);
+}
+
+int SimulationClock::GetRemaining() const {
+  if (fd_ < 0 || periodMs_ == 0) {
+    return periodMs_;
+  }
+
+  // An unread expiration is due right away, timerfd_gettime would only
+  // give the time to the one after it
+  struct pollfd pfd;
+  pfd.fd = fd_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, 0) > 0) {
+    return 0;
+  }
+
+  struct itimerspec spec;
+  if (timerfd_gettime(fd_, &spec) != 0) {
+    return periodMs_;
+  }
+  // Rounded up, so the caller wakes up after the expiration, not before
+  return static_cast<int>(spec.it_value.tv_sec * 1000
+                          + (spec.it_value.tv_nsec + 999999L) / 1000000L);
+}
+
+int SimulationClock::Wait(int timeoutMs) {
+  if (fd_ < 0) {
+    return 0;
+  }
+
+  struct pollfd pfd;
+  pfd.fd = fd_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, timeoutMs) <= 0) {
+    return 0;
+  }
+  return Expirations();
+}
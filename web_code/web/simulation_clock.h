@@ -0,0 +1,63 @@
+/**
+ * @file simulation_clock.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_SIMULATION_CLOCK_H_
+#define WEB_CODE_WEB_SIMULATION_CLOCK_H_
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A periodic server-side clock backed by a timerfd.
+ *
+ * The clock never blocks, so it can be polled from the web server's
+ * service loop between two calls to service(), each bounded by the time
+ * left until the next period.
+ *
+ * Calls to \ref Expirations function to get the number of periods elapsed.
+ * Calls to \ref GetRemaining function to get the time to the next period.
+ * Calls to \ref Wait function to block until the next period elapses.
+ * Calls to \ref SetPeriod function to change the rate of the clock.
+ */
+class SimulationClock {
+ public:
+  explicit SimulationClock(int periodMs);
+  ~SimulationClock();
+  /**
+   * @brief Change the period of the clock and restart it.
+   *
+   * @param[in] periodMs Period in milliseconds, 0 stops the clock
+   */
+  void SetPeriod(int periodMs);
+  int GetPeriod() const { return periodMs_; }
+  /**
+   * @brief Get the number of periods elapsed since the last call.
+   *
+   * @return Number of elapsed periods, 0 if none elapsed yet.
+   */
+  int Expirations();
+  /**
+   * @brief Get the time left until the next period elapses.
+   *
+   * @return Milliseconds, rounded up, 0 if a period already elapsed
+   * unread, and the period if the clock is stopped.
+   */
+  int GetRemaining() const;
+  /**
+   * @brief Block until at least one period elapsed, or the timeout.
+   *
+   * @param[in] timeoutMs Longest time to wait in milliseconds
+   * @return Number of elapsed periods, 0 on timeout.
+   */
+  int Wait(int timeoutMs);
+
+ private:
+  SimulationClock(const SimulationClock&) = delete;
+  SimulationClock& operator=(const SimulationClock&) = delete;
+  int fd_;
+  int periodMs_;
+};
+
+#endif  // WEB_CODE_WEB_SIMULATION_CLOCK_H_
@@ -0,0 +1,45 @@
+/**
+ * @file simulation_thread.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include "web_code/web/simulation_thread.h"
+#include "web_code/web/visualization_simulator.h"
+
+// Posted changes are applied at least this often, even with a slow clock
+static const int kPostedTaskLatencyMs = 50;
+
+SimulationThread::SimulationThread(VisualizationSimulator* sim, int tickMs) :
+  sim_(sim), clock_(tickMs), running_(false) {}
+
+SimulationThread::~SimulationThread() {
+  Stop();
+}
+
+void SimulationThread::Start() {
+  if (running_.exchange(true)) {
+    return;
+  }
+  thread_ = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void SimulationThread::Run() {
+  while (running_) {
+    int ticks = clock_.Wait(kPostedTaskLatencyMs);
+
+    // Apply start, pause and listener changes from the web commands
+    sim_->RunPosted();
+
+    // Catch up on every tick that elapsed, each one publishes a snapshot
+    for (int i = 0; i < ticks; i++) {
+      sim_->Update();
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/**
+ * @file simulation_thread.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_SIMULATION_THREAD_H_
+#define WEB_CODE_WEB_SIMULATION_THREAD_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <thread>
+
+#include "web_code/web/simulation_clock.h"
+
+class VisualizationSimulator;
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Runs the simulation on its own thread, driven by its own clock.
+ *
+ * The web server thread never runs a tick, so a slow tick does not stall
+ * the sockets. Changes requested by the web commands are posted to the
+ * simulator and applied between two ticks.
+ *
+ * Calls to \ref Start function to start ticking.
+ * Calls to \ref Stop function to stop ticking and join the thread.
+ */
+class SimulationThread {
+ public:
+  SimulationThread(VisualizationSimulator* sim, int tickMs);
+  ~SimulationThread();
+  void Start();
+  void Stop();
+
+ private:
+  SimulationThread(const SimulationThread&) = delete;
+  SimulationThread& operator=(const SimulationThread&) = delete;
+  void Run();
+  VisualizationSimulator* sim_;
+  SimulationClock clock_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+};
+
+#endif  // WEB_CODE_WEB_SIMULATION_THREAD_H_
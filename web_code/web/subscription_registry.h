@@ -0,0 +1,95 @@
+/**
+ * @file subscription_registry.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_SUBSCRIPTION_REGISTRY_H_
+#define WEB_CODE_WEB_SUBSCRIPTION_REGISTRY_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "src/name_table.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Which subscribers watch which entity, keyed by interned entity id.
+ *
+ * A subscriber watches at most one entity of the registry at a time, the
+ * way a browser shows a single bus or stop panel. Subscribing to another
+ * entity drops the previous subscription.
+ *
+ * Calls to \ref Subscribe function to watch an entity.
+ * Calls to \ref Unsubscribe function to stop watching.
+ * Calls to \ref GetSubscribers function to fan a payload out.
+ */
+template <typename Subscriber>
+class SubscriptionRegistry {
+ public:
+  /**
+   * @brief Make the subscriber watch an entity instead of its previous one.
+   *
+   * @param[in] subscriber Subscriber to move
+   * @param[in] id Interned id of the entity to watch
+   * @param[out] dropped Entity that lost its last subscriber, or kNoId
+   *
+   * @return true if the entity had no subscriber before.
+   */
+  bool Subscribe(Subscriber subscriber, int id, int* dropped) {
+    *dropped = Unsubscribe(subscriber);
+    subscriptions_[subscriber] = id;
+    std::vector<Subscriber>& list = subscribers_[id];
+    list.push_back(subscriber);
+    return list.size() == 1;
+  }
+  /**
+   * @brief Drop the subscription of a subscriber, if any.
+   *
+   * @return The entity that lost its last subscriber, or kNoId.
+   */
+  int Unsubscribe(Subscriber subscriber) {
+    typename std::unordered_map<Subscriber, int>::iterator it =
+      subscriptions_.find(subscriber);
+    if (it == subscriptions_.end()) {
+      return NameTable::kNoId;
+    }
+    int id = it->second;
+    subscriptions_.erase(it);
+
+    std::vector<Subscriber>& list = subscribers_[id];
+    list.erase(std::remove(list.begin(), list.end(), subscriber), list.end());
+    if (!list.empty()) {
+      return NameTable::kNoId;
+    }
+    subscribers_.erase(id);
+    return id;
+  }
+  /**
+   * @brief Get the entity a subscriber watches, or kNoId.
+   */
+  int GetSubscription(Subscriber subscriber) const {
+    typename std::unordered_map<Subscriber, int>::const_iterator it =
+      subscriptions_.find(subscriber);
+    return it == subscriptions_.end() ? NameTable::kNoId : it->second;
+  }
+  /**
+   * @brief Get every subscriber of an entity, or nullptr if there is none.
+   */
+  const std::vector<Subscriber>* GetSubscribers(int id) const {
+    typename std::unordered_map<int, std::vector<Subscriber> >::
+      const_iterator it = subscribers_.find(id);
+    return it == subscribers_.end() ? nullptr : &it->second;
+  }
+
+ private:
+  std::unordered_map<int, std::vector<Subscriber> > subscribers_;
+  std::unordered_map<Subscriber, int> subscriptions_;
+};
+
+#endif  // WEB_CODE_WEB_SUBSCRIPTION_REGISTRY_H_
@@ -0,0 +1,313 @@
+/**
+ * @file sweep_runner.cc
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+#include "web_code/web/sweep_runner.h"
+#include "web_code/web/visualization_simulator.h"
+#include "src/config_manager.h"
+#include "src/csv_reader.h"
+#include "src/thread_pool.h"
+
+static std::string Trim(const std::string& text) {
+  size_t begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = text.find_last_not_of(" \t\r");
+  return text.substr(begin, end - begin + 1);
+}
+
+// Alternatives of a field, "3|4|5", an empty field has one empty one
+static std::vector<std::string> Alternatives(const CsvField& field) {
+  std::vector<std::string> alternatives;
+  std::string value = field.ToString();
+  size_t start = 0;
+  while (true) {
+    size_t end = value.find('|', start);
+    alternatives.push_back(Trim(value.substr(start, end - start)));
+    if (end == std::string::npos) {
+      break;
+    }
+    start = end + 1;
+  }
+  return alternatives;
+}
+
+static bool ParseInt(const std::string& text, int * value) {
+  char * end;
+  long parsed = std::strtol(text.c_str(), &end, 10);  // NOLINT
+  if (text.empty() || *end != '\0' || parsed < -2147483647L
+      || parsed > 2147483647L) {
+    return false;
+  }
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+static bool ParseDouble(const std::string& text, double * value) {
+  char * end;
+  *value = std::strtod(text.c_str(), &end);
+  return !text.empty() && *end == '\0';
+}
+
+static std::vector<int> ParseHeadways(const std::string& text) {
+  std::vector<int> headways;
+  std::istringstream in(text);
+  std::string headway;
+  while (in >> headway) {
+    int value;
+    if (!ParseInt(headway, &value) || value < 0) {
+      throw std::runtime_error("bad headways " + text);
+    }
+    headways.push_back(value);
+  }
+  return headways;
+}
+
+// Seeds of "7" or of a range "1-20"
+static std::vector<uint32_t> ParseSeeds(const std::string& text) {
+  std::vector<uint32_t> seeds;
+  size_t dash = text.find('-', 1);
+  int first;
+  int last;
+  if (dash == std::string::npos) {
+    if (!ParseInt(text, &first) || first < 0) {
+      throw std::runtime_error("bad seed " + text);
+    }
+    last = first;
+  } else if (!ParseInt(Trim(text.substr(0, dash)), &first)
+             || !ParseInt(Trim(text.substr(dash + 1)), &last)
+             || first < 0 || last < first) {
+    throw std::runtime_error("bad seed range " + text);
+  }
+  for (int64_t seed = first; seed <= last; seed++) {
+    seeds.push_back(static_cast<uint32_t>(seed));
+  }
+  return seeds;
+}
+
+static const char * const kArrivalModes[] = {"stream", "common", "sobol"};
+
+SweepRunner::SweepRunner(const NetworkTables& tables, int numThreads) :
+  tables_(tables), numThreads_(numThreads) {
+}
+
+std::vector<Scenario> SweepRunner::ReadScenarios(const std::string& path) {
+  CsvReader file;
+  if (!file.Open(path)) {
+    throw ConfigError(path, 0, "cannot open the file");
+  }
+  int nameColumn = file.GetColumn("name");
+  int stepsColumn = file.GetColumn("steps");
+  if (nameColumn < 0) {
+    throw ConfigError(path, 1, "missing column name");
+  }
+  if (stepsColumn < 0) {
+    throw ConfigError(path, 1, "missing column steps");
+  }
+  int headwaysColumn = file.GetColumn("headways");
+  int strategyColumn = file.GetColumn("strategy");
+  int scaleColumn = file.GetColumn("demand_scale");
+  int seedColumn = file.GetColumn("seed");
+  int arrivalsColumn = file.GetColumn("arrivals");
+  int antitheticColumn = file.GetColumn("antithetic");
+
+  std::vector<Scenario> scenarios;
+  file.ForEachRow(1, [&](int, const CsvRow& row) {
+    Scenario scenario;
+    scenario.name = Trim(row[nameColumn].ToString());
+    if (scenario.name.empty()) {
+      throw std::runtime_error("missing name");
+    }
+
+    std::vector<std::vector<int> > headways;
+    std::vector<std::string> fields = Alternatives(row[headwaysColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      headways.push_back(ParseHeadways(fields[i]));
+    }
+    std::vector<int> strategies;
+    fields = Alternatives(row[strategyColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      int strategy = 0;
+      if (!fields[i].empty() && (!ParseInt(fields[i], &strategy)
+                                 || strategy < 0 || strategy > 4)) {
+        throw std::runtime_error("bad strategy " + fields[i]);
+      }
+      strategies.push_back(strategy);
+    }
+    std::vector<double> scales;
+    fields = Alternatives(row[scaleColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      double scale = 1;
+      if (!fields[i].empty() && (!ParseDouble(fields[i], &scale)
+                                 || scale < 0)) {
+        throw std::runtime_error("bad demand_scale " + fields[i]);
+      }
+      scales.push_back(scale);
+    }
+    std::vector<int> steps;
+    fields = Alternatives(row[stepsColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      int numTimeSteps;
+      if (!ParseInt(fields[i], &numTimeSteps) || numTimeSteps < 0) {
+        throw std::runtime_error("bad steps " + fields[i]);
+      }
+      steps.push_back(numTimeSteps);
+    }
+    std::vector<uint32_t> seeds;
+    fields = Alternatives(row[seedColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      std::vector<uint32_t> range =
+        fields[i].empty() ? std::vector<uint32_t>(1, 1)
+                          : ParseSeeds(fields[i]);
+      seeds.insert(seeds.end(), range.begin(), range.end());
+    }
+    std::vector<RandomStreams::ArrivalMode> modes;
+    fields = Alternatives(row[arrivalsColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      int mode = fields[i].empty() ? 0 : -1;
+      for (int m = 0; m < 3 && mode < 0; m++) {
+        if (fields[i] == kArrivalModes[m]) {
+          mode = m;
+        }
+      }
+      if (mode < 0) {
+        throw std::runtime_error("bad arrivals " + fields[i]);
+      }
+      modes.push_back(static_cast<RandomStreams::ArrivalMode>(mode));
+    }
+    std::vector<bool> antithetics;
+    fields = Alternatives(row[antitheticColumn]);
+    for (int i = 0; i < static_cast<int>(fields.size()); i++) {
+      if (fields[i] != "" && fields[i] != "0" && fields[i] != "1") {
+        throw std::runtime_error("bad antithetic " + fields[i]);
+      }
+      antithetics.push_back(fields[i] == "1");
+    }
+
+    // Every combination, the seeds of a setting next to each other
+    for (int h = 0; h < static_cast<int>(headways.size()); h++) {
+      scenario.headways = headways[h];
+      for (int d = 0; d < static_cast<int>(strategies.size()); d++) {
+        scenario.strategy = strategies[d];
+        for (int c = 0; c < static_cast<int>(scales.size()); c++) {
+          scenario.demandScale = scales[c];
+          for (int t = 0; t < static_cast<int>(steps.size()); t++) {
+            scenario.numTimeSteps = steps[t];
+            for (int m = 0; m < static_cast<int>(modes.size()); m++) {
+              scenario.arrivalMode = modes[m];
+              for (int a = 0; a < static_cast<int>(antithetics.size());
+                   a++) {
+                scenario.antithetic = antithetics[a];
+                for (int s = 0; s < static_cast<int>(seeds.size()); s++) {
+                  scenario.seed = seeds[s];
+                  scenarios.push_back(scenario);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+  return scenarios;
+}
+
+std::vector<ScenarioResult> SweepRunner::Run(
+    const std::vector<Scenario>& scenarios) const {
+  std::vector<ScenarioResult> results(scenarios.size());
+  ThreadPool pool(numThreads_);
+  for (int i = 0; i < static_cast<int>(scenarios.size()); i++) {
+    // Every task writes its own result only
+    pool.Submit([this, &scenarios, &results, i]() {
+      results[i] = RunScenario(scenarios[i]);
+    });
+  }
+  pool.Wait();
+  return results;
+}
+
+ScenarioResult SweepRunner::RunScenario(const Scenario& scenario) const {
+  ScenarioResult result;
+  result.scenario = scenario;
+  try {
+    NetworkTables tables = tables_;
+    // A generation probability p adds p / (1 - p) passengers a step, that
+    // mean is scaled. A stop sure to get a passenger is left as it is
+    for (int i = 0; i < static_cast<int>(tables.probabilities.size()); i++) {
+      double& probability = tables.probabilities[i];
+      if (probability < 1) {
+        double mean = probability / (1 - probability) * scenario.demandScale;
+        probability = mean / (1 + mean);
+      }
+    }
+    if (scenario.strategy != 0) {
+      NetworkWindowRecord window;
+      window.start_time = 0;
+      window.strategy = scenario.strategy;
+      tables.windows.assign(1, window);
+    }
+
+    ConfigManager network;
+    network.ReadTables(tables);
+    network.GetRandom().Seed(scenario.seed);
+    network.GetRandom().SetArrivalMode(scenario.arrivalMode,
+                                       scenario.antithetic);
+    int numLines = static_cast<int>(network.GetRoutes().size()) / 2;
+    std::vector<int> headways = scenario.headways;
+    if (headways.empty()) {
+      headways.assign(numLines, 5);
+    }
+    if (static_cast<int>(headways.size()) != numLines) {
+      result.error = std::to_string(headways.size()) + " headways for "
+                   + std::to_string(numLines) + " lines";
+      return result;
+    }
+
+    RunMetrics metrics;
+    std::ostream report(NULL);  // route and bus reports are dropped
+    VisualizationSimulator sim(&metrics, &network, &report);
+    sim.SetLog(NULL);
+    sim.SetTrace(NULL);
+    metrics.Attach(&sim.GetEventBus());
+    sim.Start(headways, scenario.numTimeSteps);
+    while (sim.Update()) {}
+    result.summary = metrics.GetSummary();
+  } catch (const std::exception& error) {
+    result.error = error.what();
+  }
+  return result;
+}
+
+void SweepRunner::WriteTable(std::ostream& out,
+                             const std::vector<ScenarioResult>& results) {
+  out << "name,headways,strategy,demand_scale,seed,steps,arrivals,"
+      << "antithetic,delivered,mean_wait,"
+      << "mean_trip_time,max_trip_time,max_queue,mean_load,waiting_at_end,"
+      << "trips,error" << std::endl;
+  for (int i = 0; i < static_cast<int>(results.size()); i++) {
+    const RunSummary& summary = results[i].summary;
+    WriteScenario(out, results[i].scenario);
+    out << "," << summary.delivered << "," << summary.meanWait << ","
+        << summary.meanTripTime << ","
+        << summary.maxTripTime << "," << summary.maxQueue << ","
+        << summary.meanLoad << "," << summary.waitingAtEnd << ","
+        << summary.trips << "," << results[i].error << std::endl;
+  }
+}
+
+void SweepRunner::WriteScenario(std::ostream& out, const Scenario& scenario) {
+  out << scenario.name << ",";
+  for (int j = 0; j < static_cast<int>(scenario.headways.size()); j++) {
+    out << (j > 0 ? " " : "") << scenario.headways[j];
+  }
+  out << "," << scenario.strategy << "," << scenario.demandScale << ","
+      << scenario.seed << "," << scenario.numTimeSteps << ","
+      << kArrivalModes[scenario.arrivalMode] << ","
+      << (scenario.antithetic ? 1 : 0);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file sweep_runner.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_SWEEP_RUNNER_H_
+#define WEB_CODE_WEB_SWEEP_RUNNER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "web_code/web/run_metrics.h"
+#include "src/network_image.h"
+#include "src/random_streams.h"
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+// One simulation of a sweep
+struct Scenario {
+  Scenario() : strategy(0), demandScale(1), seed(1), numTimeSteps(100),
+    arrivalMode(RandomStreams::kSequential), antithetic(false) {}
+  std::string name;
+  // Time steps between two busses of every line, one per route pair, or
+  // empty for 5 on every line
+  std::vector<int> headways;
+  int strategy;  // BusDepot strategy for the whole run, 0 for the plan
+  double demandScale;  // multiplies the passengers arriving at every stop
+  uint32_t seed;
+  int numTimeSteps;
+  // How passenger arrivals are drawn, kCommon or kSobol give scenarios of
+  // the same seed the same arrivals, see RandomStreams
+  RandomStreams::ArrivalMode arrivalMode;
+  bool antithetic;  // arrivals mirrored, 1 - u for every draw u
+};
+
+struct ScenarioResult {
+  Scenario scenario;
+  RunSummary summary;
+  std::string error;  // why the scenario could not run, if it did not
+};
+
+/**
+ * @brief Runs many scenarios of one network as independent simulations.
+ *
+ * Every scenario builds a network of its own from the same tables, with
+ * its own random streams, depots and event bus, so scenarios run on the
+ * threads of a ThreadPool without sharing any state, and a scenario gives
+ * the same summary whatever thread or order it runs in.
+ *
+ * Calls to \ref ReadScenarios function to read a scenario file.
+ * Calls to \ref Run function to run scenarios in parallel.
+ * Calls to \ref WriteTable function to write their summary table.
+ */
+class SweepRunner {
+ public:
+ /**
+  * @param[in] tables Network every scenario runs on, see
+  * ConfigManager::GetNetwork
+  * @param[in] numThreads Simulations run at once, 0 for one per core
+  */
+  explicit SweepRunner(const NetworkTables& tables, int numThreads = 0);
+ /**
+  * @brief Read scenarios from a CSV file.
+  *
+  * Columns are name, headways (space separated, one per line), strategy,
+  * demand_scale, seed, steps, arrivals (stream, common or sobol) and
+  * antithetic (0 or 1), only name and steps are required. A field may list
+  * alternatives separated by '|', a row stands for every combination of
+  * them, and a seed may be a range such as 1-20.
+  *
+  * Throws ConfigError on a malformed row.
+  */
+  static std::vector<Scenario> ReadScenarios(const std::string& path);
+ /**
+  * @brief Run scenarios, the results come in the order of the scenarios.
+  */
+  std::vector<ScenarioResult> Run(const std::vector<Scenario>& scenarios)
+    const;
+ /**
+  * @brief Run one scenario on the calling thread.
+  */
+  ScenarioResult RunScenario(const Scenario& scenario) const;
+ /**
+  * @brief Write results as a CSV table, one row per scenario.
+  */
+  static void WriteTable(std::ostream& out,
+                         const std::vector<ScenarioResult>& results);
+ /**
+  * @brief Write the settings of a scenario, the first columns of a table
+  * row, in the columns of a scenario file.
+  */
+  static void WriteScenario(std::ostream& out, const Scenario& scenario);
+
+ private:
+  NetworkTables tables_;
+  int numThreads_;
+};
+
+#endif  // WEB_CODE_WEB_SWEEP_RUNNER_H_
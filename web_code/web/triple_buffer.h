@@ -0,0 +1,67 @@
+/**
+ * @file triple_buffer.h
+ *
+ * @copyright 2020 Zecheng Qian, All rights reserved.
+ */
+#ifndef WEB_CODE_WEB_TRIPLE_BUFFER_H_
+#define WEB_CODE_WEB_TRIPLE_BUFFER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Lock-free triple buffer between one writer and one reader thread.
+ *
+ * The writer fills the back buffer and publishes it, the reader always
+ * gets the latest published buffer. Neither side ever waits for the other,
+ * and intermediate buffers the reader did not get to are simply dropped.
+ *
+ * Calls to \ref GetBack function to get the buffer to fill (writer only).
+ * Calls to \ref Publish function to make the back buffer the latest one.
+ * Calls to \ref GetFront function to get the latest buffer (reader only).
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() : back_(0), front_(2), middle_(1) {}
+  /**
+   * @brief Get the buffer owned by the writer.
+   *
+   * It may hold the data of an older publish, not the last one.
+   */
+  T& GetBack() { return buffers_[back_]; }
+  /**
+   * @brief Hand the back buffer over to the reader.
+   */
+  void Publish() {
+    int old = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+    back_ = old & kIndex;
+  }
+  /**
+   * @brief Get the latest published buffer.
+   *
+   * The buffer stays valid and unchanged until the next call.
+   */
+  const T& GetFront() {
+    if (middle_.load(std::memory_order_acquire) & kFresh) {
+      int old = middle_.exchange(front_, std::memory_order_acq_rel);
+      front_ = old & kIndex;
+    }
+    return buffers_[front_];
+  }
+
+ private:
+  static const int kIndex = 3;
+  static const int kFresh = 4;  // set while the middle buffer is unread
+  T buffers_[3];
+  int back_;  // only touched by the writer
+  int front_;  // only touched by the reader
+  std::atomic<int> middle_;
+};
+
+#endif  // WEB_CODE_WEB_TRIPLE_BUFFER_H_
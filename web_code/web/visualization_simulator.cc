@@ -4,7 +4,8 @@
  * @copyright 2019 3081 Staff, All rights reserved.
  */
 #include <iostream>
-#include <ctime>
+#include <unordered_set>
+#include <utility>
 
 #include "web_code/web/visualization_simulator.h"
 #include "src/bus.h"
@@ -16,16 +17,54 @@ VisualizationSimulator::VisualizationSimulator
   webInterface_ = webI;
   configManager_ = configM;
   paused_ = false;  // global status for pause button
+  started_ = false;  // nothing to update until the client starts a run
+  numTimeSteps_ = 0;
+  simulationTimeElapsed_ = 0;
   out_ = out;  // output stream
   bus_stats_file_name = "BusData.csv";
   bus_stat_ss.str("");
   instance = FileWriterManager::GetInstance();
+  trace_ = &std::cout;
+  waitStatistics_.Attach(&events_);
+}
+
+VisualizationSimulator::~VisualizationSimulator() {
+  if (checkpointWriter_.joinable()) {
+    checkpointWriter_.join();
+  }
+  ClearDepots();
+}
+
+void VisualizationSimulator::ClearDepots() {
+  // The depots own the busses, drop every reference to them first
+  busses_.Clear();
+  busRegistry_.Clear();
+  for (int i = 0; i < static_cast<int>(depots_.size()); i++) {
+    delete depots_[i];
+  }
+  depots_.clear();
 }
 
-VisualizationSimulator::~VisualizationSimulator() {}
+void VisualizationSimulator::SetColorPolicy(int line,
+                                            Bus::ColorPolicy policy) {
+  if (line >= static_cast<int>(colorPolicies_.size())) {
+    colorPolicies_.resize(line + 1, NULL);
+  }
+  colorPolicies_[line] = policy;
+}
+
+Bus::ColorPolicy VisualizationSimulator::GetColorPolicy(int line) const {
+  if (line < static_cast<int>(colorPolicies_.size())
+      && colorPolicies_[line] != NULL) {
+    return colorPolicies_[line];
+  }
+  return &MaroonGoldColorPolicy::Apply<Bus>;
+}
 
 void VisualizationSimulator::TogglePause() {
-  std::cout << "Toggling Pause" << std::endl;
+  if (trace_) {
+    *trace_ << "Toggling Pause" << std::endl;
+  }
   paused_ = !paused_;  // swith the global paused_ status
 }
 
@@ -40,14 +79,36 @@ void VisualizationSimulator::Start
   }
 
   simulationTimeElapsed_ = 0;
+  started_ = true;
+  waitStatistics_.Clear();
+
+  // One depot per route, they live as long as the run
+  dispatchCursor_ = DispatchCursor(&configManager_->GetDispatchPlan());
+  dispatchCursor_.Advance(simulationTimeElapsed_);
+  // The busses of a previous run leave the web interface with their depots
+  RemoveBusses();
+  ClearDepots();
+  for (int i = 0; i < static_cast<int>(busStartTimings_.size()); i++) {
+    depots_.push_back(new BusDepot());
+    depots_.back()->SetStrategy(dispatchCursor_.GetStrategy());
+  }
 
   prototypeRoutes_ = configManager_->GetRoutes();
+  stopRegistry_.Clear();
   for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
     prototypeRoutes_[i]->Report(*out_);
 
+    const std::list<Stop *>& stops = prototypeRoutes_[i]->GetStops();
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end();
+      it++) {
+      stopRegistry_.Add((*it)->GetStopData().id, *it);
+    }
+
   prototypeRoutes_[i]->UpdateRouteData();
   webInterface_->UpdateRoute(prototypeRoutes_[i]->GetRouteData());
   }
+  webInterface_->Publish();
 }
 
 bool VisualizationSimulator::Update() {
@@ -65,9 +126,9 @@ bool VisualizationSimulator::Update() {
 
 bool VisualizationSimulator::CanUpdate() {
   // Check whether or not simulator can update
-  // maybe unable to update because paused, terminated, etcetra
-  // only cares about whether or not it is paused right now
-  return !paused_;
+  // maybe unable to update because not started, paused or all the
+  // requested time steps have already run
+  return started_ && !paused_ && simulationTimeElapsed_ <= numTimeSteps_;
 }
 
 void VisualizationSimulator::ExecuteUpdate() {
@@ -75,11 +136,20 @@ void VisualizationSimulator::ExecuteUpdate() {
   // I added a gating mechanism for pause functionality
   simulationTimeElapsed_++;
 
-  std::cout << "~~~~~~~~~~ The time is now " << simulationTimeElapsed_;
-  std::cout << "~~~~~~~~~~" << std::endl;
+  if (trace_) {
+    *trace_ << "~~~~~~~~~~ The time is now " << simulationTimeElapsed_;
+    *trace_ << "~~~~~~~~~~" << std::endl;
 
-  std::cout << "~~~~~~~~~~ Generating new busses if needed ";
-  std::cout << "~~~~~~~~~~" << std::endl;
+    *trace_ << "~~~~~~~~~~ Generating new busses if needed ";
+    *trace_ << "~~~~~~~~~~" << std::endl;
+  }
+
+  // Switch every depot to the bus-type mix of the new window, if any
+  if (dispatchCursor_.Advance(simulationTimeElapsed_)) {
+    for (int i = 0; i < static_cast<int>(depots_.size()); i++) {
+      depots_[i]->SetStrategy(dispatchCursor_.GetStrategy());
+    }
+  }
 
   // Check if we need to generate new busses
   for (int i = 0; i < static_cast<int>(timeSinceLastBus_.size()); i++) {
@@ -88,98 +158,370 @@ void VisualizationSimulator::ExecuteUpdate() {
       Route * outbound = prototypeRoutes_[2 * i];
       Route * inbound = prototypeRoutes_[2 * i + 1];
 
-      // Create a bus depot for deploying bus
-      BusDepot * bus_depot = new BusDepot();
-      time_t timer;
-      struct tm timeinfo;
-      char buf[50];
-
-      time(&timer);  // get the current time
-      localtime_r(&timer, &timeinfo);  // convert it to local time
-
-      std::cout << "Current local time is: "
-                << asctime_r(&timeinfo, buf);
-
-      // Check the range of total distance to check which
-      // strategy to apply
-      if (timeinfo.tm_hour >= 6 && timeinfo.tm_hour < 8) {
-        // Depoly strategy 1
-        bus_depot->SetStrategy(1);
-      } else if (timeinfo.tm_hour >= 8 && timeinfo.tm_hour < 15) {
-      // Depoly strategy 2
-        bus_depot->SetStrategy(2);
-      } else if (timeinfo.tm_hour >= 15 && timeinfo.tm_hour < 20) {
-        // Depoly strategy 3
-        bus_depot->SetStrategy(3);
-      } else {
-        // Set it to the default strategy
-        bus_depot->SetStrategy(4);
+      // Deploy a bus using the strategy of the current dispatch window,
+      // the depot recycles a retired one of the same type if it can
+      Deployment deployment;
+      int numOwned = depots_[i]->GetNumOwned();
+      deployment.bus = depots_[i]->Deploy(std::to_string(busId),
+        outbound, inbound, 1);
+      deployment.depot = depots_[i];
+      deployment.line = i;
+      deployment.bus->SetColorPolicy(GetColorPolicy(i));
+      deployment.bus->SetEventBus(&events_);
+      deployment.bus->SetLog(instance);
+      busses_.Insert(deployment);
+      busRegistry_.Add(deployment.bus->GetId(), deployment.bus);
+      // A recycled bus keeps its name, only a new one takes the next
+      if (depots_[i]->GetNumOwned() > numOwned) {
+        busId++;
       }
 
-      // Generate a bus using a specific strategy
-      busses_.push_back(bus_depot->Generate(std::to_string(busId),
-        outbound->Clone(), inbound->Clone(), 1));
-      busId++;
-
-      // Delete the bus depot instance
-      delete bus_depot;
-
       timeSinceLastBus_[i] = busStartTimings_[i];
       } else {
       timeSinceLastBus_[i]--;
       }
   }
 
-  std::cout << "~~~~~~~~~ Updating busses ";
-  std::cout << "~~~~~~~~~" << std::endl;
+  if (trace_) {
+    *trace_ << "~~~~~~~~~ Updating busses ";
+    *trace_ << "~~~~~~~~~" << std::endl;
+  }
 
   // Update busses
-  for (int i = static_cast<int>(busses_.size()) - 1; i >= 0; i--) {
-    busses_[i]->Update();
+  // Backwards, so swap-removing a finished bus skips nothing
+  for (int i = busses_.Size() - 1; i >= 0; i--) {
+    Bus * bus = busses_[i].bus;
+    bus->Update();
 
-    if (busses_[i]->IsTripComplete()) {
-      bus_stat_ss.str("");  // empty the ostringstream
-      busses_[i]->Report(bus_stat_ss);
+    if (bus->IsTripComplete()) {
       // Passing the information and write to the log file
       // for BusData
-      instance->Write(bus_stats_file_name, Util::ProcessOutput(bus_stat_ss));
-      webInterface_->UpdateBus(busses_[i]->GetBusData(), true);
-      busses_.erase(busses_.begin() + i);
+      if (instance) {
+        bus_stat_ss.str("");  // empty the ostringstream
+        bus->Report(bus_stat_ss);
+        instance->Write(bus_stats_file_name,
+                        Util::ProcessOutput(bus_stat_ss));
+      }
+      webInterface_->UpdateBus(bus->GetBusData(), true);
+      busRegistry_.Remove(bus->GetId());
+      busses_[i].depot->Retire(bus);
+      busses_.RemoveAt(i);
       continue;
     }
 
-    webInterface_->UpdateBus(busses_[i]->GetBusData());
+    // Only send buses whose visible state changed
+    if (bus->HasChanged()) {
+      webInterface_->UpdateBus(bus->GetBusData());
+    }
 
-    busses_[i]->Report(*out_);
+    bus->Report(*out_);
   }
 
-  std::cout << "~~~~~~~~~ Updating routes ";
-  std::cout << "~~~~~~~~~" << std::endl;
+  if (trace_) {
+    *trace_ << "~~~~~~~~~ Updating routes ";
+    *trace_ << "~~~~~~~~~" << std::endl;
+  }
   // Update routes
   for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
     prototypeRoutes_[i]->Update();
-    webInterface_->UpdateRoute(prototypeRoutes_[i]->GetRouteData());
     prototypeRoutes_[i]->Report(*out_);
+    // Idle routes, where no waiting count changed, are skipped entirely
+    if (prototypeRoutes_[i]->HasChanged()) {
+      SendRoute(prototypeRoutes_[i]);
+    }
+  }
+
+  // Hand the state of this tick over to the web server thread
+  webInterface_->Publish();
+}
+
+void VisualizationSimulator::SendRoute(Route * route) {
+  const RouteData& routeData = route->GetRouteData();
+  if (events_.HasSubscribers<StopCountChangedEvent>()) {
+    for (int j = 0; j < static_cast<int>(routeData.dirty.size()); j++) {
+      if (routeData.dirty[j]) {
+        events_.Publish(routeData.stops[j]->id,
+                        StopCountChangedEvent(*routeData.stops[j]));
+      }
+    }
+  }
+  webInterface_->UpdateRoute(routeData);
+}
+
+void VisualizationSimulator::Post(const std::function<void()>& task) {
+  std::lock_guard<std::mutex> lock(posted_mutex_);
+  posted_.push_back(task);
+}
+
+void VisualizationSimulator::RunPosted() {
+  std::vector<std::function<void()> > tasks;
+  {
+    std::lock_guard<std::mutex> lock(posted_mutex_);
+    tasks.swap(posted_);
+  }
+  // Run outside the lock, the web thread must never wait for a task
+  for (int i = 0; i < static_cast<int>(tasks.size()); i++) {
+    tasks[i]();
   }
 }
 
-void VisualizationSimulator::ClearBusListeners() {
-  // Remove all observers for all buses
-  for (int i = static_cast<int>(busses_.size()) - 1; i >= 0; i--) {
-    busses_[i]->ClearObservers();
+void VisualizationSimulator::RepublishBus(int id) {
+  Bus * bus = busRegistry_.Find(id);
+  if (bus) {
+    events_.Publish(id, BusMovedEvent(bus->GetBusData()));
   }
 }
 
-void VisualizationSimulator::ClearStopListeners() {
-  // Iterate for all routes
-  for (int i = static_cast<int>(prototypeRoutes_.size()) - 1; i >= 0; i--) {
-    // For a single route, query information for all stops
-    std::list<Stop *> stops_ = prototypeRoutes_[i]->GetStops();
-    for (std::list<Stop *>::iterator it = stops_.begin();
-      it != stops_.end();
+void VisualizationSimulator::RepublishStop(int id) {
+  Stop * stop = stopRegistry_.Find(id);
+  if (stop) {
+    events_.Publish(id, StopCountChangedEvent(stop->GetStopData()));
+  }
+}
+
+void VisualizationSimulator::RemoveBusses() {
+  for (int i = 0; i < busses_.Size(); i++) {
+    webInterface_->UpdateBus(busses_[i].bus->GetBusData(), true);
+  }
+}
+
+bool VisualizationSimulator::SaveCheckpoint(const std::string& path,
+                                            std::string * error) {
+  if (!started_) {
+    *error = "no run to save";
+    return false;
+  }
+  CheckpointWriter out;
+  out.WriteInt(simulationTimeElapsed_);
+  out.WriteInt(numTimeSteps_);
+  out.WriteInt(busId);
+  out.WriteInt(Passenger::GetCount());
+  out.WriteString(configManager_->GetRandom().GetState());
+
+  // The network, checked before a load replaces anything
+  out.WriteInt(static_cast<int>(prototypeRoutes_.size()));
+  for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
+    const std::list<Stop *>& stops = prototypeRoutes_[i]->GetStops();
+    out.WriteInt(static_cast<int>(stops.size()));
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end();
       it++) {
-      // Remove all observers for all stops on this route
-      (*it)->ClearObservers();
+      out.WriteInt((*it)->GetId());
     }
   }
+
+  // Dispatch timers and bus-type rotation of every line
+  out.WriteInt(static_cast<int>(busStartTimings_.size()));
+  for (int i = 0; i < static_cast<int>(busStartTimings_.size()); i++) {
+    out.WriteInt(busStartTimings_[i]);
+    out.WriteInt(timeSinceLastBus_[i]);
+    depots_[i]->Save(&out);
+  }
+
+  // Waiting passengers, a stop listed twice is saved once
+  std::unordered_set<const Stop *> saved;
+  for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
+    const std::list<Stop *>& stops = prototypeRoutes_[i]->GetStops();
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end();
+      it++) {
+      if (saved.insert(*it).second) {
+        (*it)->Save(&out);
+      }
+    }
+  }
+
+  // Busses in update order, which decides who boards first at a stop
+  out.WriteInt(busses_.Size());
+  for (int i = 0; i < busses_.Size(); i++) {
+    out.WriteInt(busses_[i].line);
+    out.WriteString(busses_[i].bus->GetName());
+    out.WriteString(busses_[i].bus->GetType());
+    busses_[i].bus->Save(&out);
+  }
+
+  // The copy is done, the tick goes on while the file is written, the
+  // writer only touches the body and checkpointError_
+  std::string body;
+  out.Swap(&body);
+  if (checkpointWriter_.joinable()) {
+    checkpointWriter_.join();
+  }
+  checkpointWriter_ = std::thread(&VisualizationSimulator::WriteCheckpoint,
+                                  this, path, std::move(body));
+  return true;
+}
+
+void VisualizationSimulator::WriteCheckpoint(std::string path,
+                                             std::string body) {
+  checkpointError_.clear();
+  if (Checkpoint::Write(path, body, &checkpointError_)) {
+    std::cout << "Saved checkpoint " << path << std::endl;
+  } else {
+    std::cerr << path << ": " << checkpointError_ << std::endl;
+  }
+}
+
+bool VisualizationSimulator::WaitForCheckpoint(std::string * error) {
+  if (checkpointWriter_.joinable()) {
+    checkpointWriter_.join();
+  }
+  if (!checkpointError_.empty()) {
+    *error = checkpointError_;
+    return false;
+  }
+  return true;
+}
+
+bool VisualizationSimulator::LoadCheckpoint(const std::string& path,
+                                            std::string * error) {
+  std::string body;
+  if (!Checkpoint::Read(path, &body, error)) {
+    return false;
+  }
+  CheckpointReader in(body);
+  int simulationTimeElapsed = in.ReadInt();
+  int numTimeSteps = in.ReadInt();
+  int nextBusId = in.ReadInt();
+  int passengerCount = in.ReadInt();
+  std::string randomState = in.ReadString();
+
+  // Nothing is replaced until the network is known to be the same
+  std::vector<Route *> routes = configManager_->GetRoutes();
+  if (in.ReadInt() != static_cast<int>(routes.size())) {
+    in.Fail("checkpoint of another network, not "
+            + std::to_string(routes.size()) + " routes");
+  }
+  for (int i = 0; i < static_cast<int>(routes.size()) && in.IsOk(); i++) {
+    const std::list<Stop *>& stops = routes[i]->GetStops();
+    if (in.ReadInt() != static_cast<int>(stops.size())) {
+      in.Fail("checkpoint of another network, route "
+              + routes[i]->GetName() + " differs");
+    }
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end() && in.IsOk();
+      it++) {
+      if (in.ReadInt() != (*it)->GetId()) {
+        in.Fail("checkpoint of another network, route "
+                + routes[i]->GetName() + " differs");
+      }
+    }
+  }
+  if (!in.IsOk()) {
+    *error = in.GetError();
+    return false;
+  }
+
+  RemoveBusses();
+  ClearDepots();
+  simulationTimeElapsed_ = simulationTimeElapsed;
+  numTimeSteps_ = numTimeSteps;
+  busId = nextBusId;
+  prototypeRoutes_ = routes;
+  stopRegistry_.Clear();
+  for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
+    const std::list<Stop *>& stops = prototypeRoutes_[i]->GetStops();
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end();
+      it++) {
+      stopRegistry_.Add((*it)->GetStopData().id, *it);
+    }
+  }
+  if (!configManager_->GetRandom().SetState(randomState)) {
+    in.Fail("bad random generator state");
+  }
+  if (!in.IsOk() || !RestoreRun(&in)) {
+    // Damaged past the network, there is no run to go on with
+    RemoveBusses();
+    ClearDepots();
+    started_ = false;
+    webInterface_->Publish();
+    *error = in.GetError();
+    return false;
+  }
+  Passenger::SetCount(passengerCount);
+  started_ = true;
+  waitStatistics_.Clear();
+
+  // The web interface and the watchers get the restored state at once
+  for (int i = 0; i < busses_.Size(); i++) {
+    Bus * bus = busses_[i].bus;
+    webInterface_->UpdateBus(bus->GetBusData());
+    if (events_.HasSubscribers<BusMovedEvent>(bus->GetId())) {
+      RepublishBus(bus->GetId());
+    }
+  }
+  for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
+    prototypeRoutes_[i]->UpdateRouteData();
+    SendRoute(prototypeRoutes_[i]);
+  }
+  webInterface_->Publish();
+  std::cout << "Loaded checkpoint " << path << " at time "
+            << simulationTimeElapsed_ << std::endl;
+  return true;
+}
+
+bool VisualizationSimulator::RestoreRun(CheckpointReader * in) {
+  // A line takes its timer, countdown and four rotations
+  int numLines = in->ReadCount(6 * sizeof(int));
+  if (2 * numLines > static_cast<int>(prototypeRoutes_.size())) {
+    return in->Fail("more lines than routes in the checkpoint");
+  }
+  dispatchCursor_ = DispatchCursor(&configManager_->GetDispatchPlan());
+  dispatchCursor_.Advance(simulationTimeElapsed_);
+  busStartTimings_.assign(numLines, 0);
+  timeSinceLastBus_.assign(numLines, 0);
+  for (int i = 0; i < numLines; i++) {
+    busStartTimings_[i] = in->ReadInt();
+    timeSinceLastBus_[i] = in->ReadInt();
+    depots_.push_back(new BusDepot());
+    depots_.back()->SetStrategy(dispatchCursor_.GetStrategy());
+    depots_.back()->Load(in);
+  }
+
+  std::unordered_set<Stop *> loaded;
+  for (int i = 0; i < static_cast<int>(prototypeRoutes_.size()); i++) {
+    const std::list<Stop *>& stops = prototypeRoutes_[i]->GetStops();
+    for (std::list<Stop *>::const_iterator it = stops.begin();
+      it != stops.end();
+      it++) {
+      if (loaded.insert(*it).second && !(*it)->Load(in)) {
+        return false;
+      }
+    }
+  }
+
+  // A bus takes at least its line, name, type and place on the routes
+  int numBusses = in->ReadCount(7 * sizeof(int) + 2 * sizeof(double));
+  for (int i = 0; i < numBusses; i++) {
+    int line = in->ReadInt();
+    std::string name = in->ReadString();
+    std::string type = in->ReadString();
+    if (!in->IsOk()) {
+      return false;
+    }
+    if (line < 0 || line >= numLines) {
+      return in->Fail("bus " + name + " on no line");
+    }
+    if (type != "Small" && type != "Medium" && type != "Large") {
+      return in->Fail("bus " + name + " of unknown type " + type);
+    }
+    Deployment deployment;
+    deployment.bus = depots_[line]->DeployType(name, type,
+      prototypeRoutes_[2 * line], prototypeRoutes_[2 * line + 1], 1);
+    deployment.depot = depots_[line];
+    deployment.line = line;
+    deployment.bus->SetColorPolicy(GetColorPolicy(line));
+    deployment.bus->SetEventBus(&events_);
+    deployment.bus->SetLog(instance);
+    busses_.Insert(deployment);
+    busRegistry_.Add(deployment.bus->GetId(), deployment.bus);
+    if (!deployment.bus->Load(in)) {
+      return false;
+    }
+  }
+  if (!in->AtEnd()) {
+    return in->Fail("unexpected data after the busses");
+  }
+  return true;
 }
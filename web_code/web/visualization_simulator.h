@@ -9,19 +9,28 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <list>
 #include <string>
 
 #include "web_code/web/web_interface.h"
+#include "src/bus.h"
+#include "src/checkpoint.h"
 #include "src/config_manager.h"
-#include "src/iobserver.h"
+#include "src/dispatch_plan.h"
+#include "src/entity_registry.h"
+#include "src/event_bus.h"
 #include "src/file_writer.h"
 #include "src/file_writer_manager.h"
+#include "src/slot_map.h"
 #include "src/util.h"
+#include "src/wait_statistics.h"
 
 class Route;
-class Bus;
+class BusDepot;
 class Stop;
 class FileWriterManager;
 class Util;
@@ -37,6 +46,9 @@ class Util;
  * Calls to \ref AddBusListener to register an observer for a bus.
  * Calls to \ref ClearStopListeners function to clear all the observers for stops.
  * Calls to \ref AddStopListener to register an observer for a stop.
+ * Calls to \ref SaveCheckpoint function to save the run to a file.
+ * Calls to \ref LoadCheckpoint function to go on from a saved run.
+ * Calls to \ref GetWaitStatistics function for the passenger wait times.
  */
 class VisualizationSimulator {
  public:
@@ -70,37 +82,117 @@ class VisualizationSimulator {
    */
   void TogglePause();
   /**
-   * @brief Clear all the observers for all buses.
+   * @brief Get the event bus buses and stops publish on.
    *
-   * This function will be used for simulation purposes.
+   * Only to be used on the simulation thread.
    */
-  void ClearBusListeners();
+  EventBus& GetEventBus() { return events_; }
   /**
-   * @brief Register an observers to a bus specified by bus name.
+   * @brief Get the wait times of the passengers delivered so far.
    *
-   * This function will be used for simulation purposes.
+   * Counted since the run was started or loaded from a checkpoint. Their
+   * summaries can be taken from any thread.
+   */
+  const WaitStatistics& GetWaitStatistics() const { return waitStatistics_; }
+  /**
+   * @brief Get the names of the busses, routes and stops of the network.
+   */
+  const NameTable& GetNames() const { return configManager_->GetNames(); }
+  /**
+   * @brief Publish the current state of a bus, even if it did not change.
    *
-   * @param[in] id A string of Bus name
-   * @param[in] observer Observer to be registered
+   * Lets a new subscriber of BusMovedEvent get the initial state.
+   *
+   * @param[in] id Interned Bus name, see NameTable
    */
-  template <typename T>
-  void AddBusListener(std::string * id, IObserver<T> * observer);
+  void RepublishBus(int id);
   /**
-   * @brief Clear all the observers for all stops.
+   * @brief Publish the current state of a stop, even if it did not change.
    *
-   * This function will be used for simulation purposes.
+   * Lets a new subscriber of StopCountChangedEvent get the initial count.
+   *
+   * @param[in] id Interned Stop name, see NameTable
    */
-  void ClearStopListeners();
+  void RepublishStop(int id);
   /**
-   * @brief Register an observers to a stop specified by stop name.
+   * @brief Queue a change to the simulation from another thread.
    *
-   * This function will be used for simulation purposes.
+   * The simulation runs on its own thread, so the web commands post their
+   * changes here instead of calling the simulator directly.
+   *
+   * @param[in] task Change to apply between two ticks
+   */
+  void Post(const std::function<void()>& task);
+  /**
+   * @brief Apply the posted changes, on the simulation thread.
+   */
+  void RunPosted();
+  /**
+   * @brief Save the run as a checkpoint, on the simulation thread.
+   *
+   * Saves the busses with their place on the routes, the waiting and
+   * riding passengers, the dispatch timers and the random generators.
+   * Only the copy of the state into memory is made between two ticks, the
+   * file is written by a background thread, so a large state does not
+   * stall the next tick. A save waits for the file of the previous one.
+   *
+   * @param[in] path Checkpoint file, replaced once fully written
+   * @param[out] error Reason of a failure
+   * @return false if there is no run to save.
+   */
+  bool SaveCheckpoint(const std::string& path, std::string * error);
+  /**
+   * @brief Wait until the file of the last save is written.
+   *
+   * @param[out] error Reason the file could not be written
+   * @return false if it could not be written.
+   */
+  bool WaitForCheckpoint(std::string * error);
+  /**
+   * @brief Replace the run with a checkpoint, on the simulation thread.
+   *
+   * The run goes on from the time step it was saved at, without a Start,
+   * so many runs can branch from one warmed up state. A checkpoint of
+   * another network is refused before anything is replaced.
    *
-   * @param[in] id A string of Stop ID
-   * @param[in] observer Observer to be registered
+   * @param[in] path Checkpoint file written by SaveCheckpoint
+   * @param[out] error Reason of a failure
+   * @return false if the checkpoint cannot be used, the run is stopped if
+   * it was found damaged past its network.
    */
-  template <typename T>
-  void AddStopListener(std::string * id, IObserver<T> * observer);
+  bool LoadCheckpoint(const std::string& path, std::string * error);
+  /**
+   * @brief Let the run go on for some more time steps.
+   */
+  void RunFor(int numTimeSteps) {
+    numTimeSteps_ = simulationTimeElapsed_ + numTimeSteps;
+  }
+  /**
+   * @brief Set the log finished busses and passengers are reported to.
+   *
+   * Applies to the busses deployed from then on.
+   *
+   * @param[in] log Log to write to, NULL to write none, the log of
+   * FileWriterManager is used by default
+   */
+  void SetLog(FileWriter * log) { instance = log; }
+  /**
+   * @brief Set the stream every tick and pause is traced to.
+   *
+   * @param[in] trace Stream to write to, NULL to trace nothing and skip
+   * the formatting, std::cout by default
+   */
+  void SetTrace(std::ostream * trace) { trace_ = trace; }
+  /**
+   * @brief Choose how the busses of a line are painted, see BusColorPolicy.
+   *
+   * Applies to the busses deployed from then on, a line without one uses
+   * MaroonGoldColorPolicy.
+   *
+   * @param[in] line Index of the route pair
+   * @param[in] policy Policy to paint with, NULL for the default
+   */
+  void SetColorPolicy(int line, Bus::ColorPolicy policy);
 
  private:
   /**
@@ -110,6 +202,16 @@ class VisualizationSimulator {
    * This function will be used for simulation purposes.
    */
   void ExecuteUpdate();
+  void ClearDepots();
+  // Tell the web interface every bus on the road is gone
+  void RemoveBusses();
+  // Publish the changed stops of a route and send it to the web interface
+  void SendRoute(Route * route);
+  // Depots, stops and busses of a checkpoint, after its network
+  bool RestoreRun(CheckpointReader * in);
+  void WriteCheckpoint(std::string path, std::string body);
+  // Policy the busses of a line are painted with
+  Bus::ColorPolicy GetColorPolicy(int line) const;
   WebInterface* webInterface_;
   ConfigManager* configManager_;
 
@@ -119,44 +221,46 @@ class VisualizationSimulator {
   int simulationTimeElapsed_;
 
   std::vector<Route *> prototypeRoutes_;
-  std::vector<Bus *> busses_;
+
+  // A bus on the road and the depot that owns it
+  struct Deployment {
+    Bus * bus;
+    BusDepot * depot;
+    int line;  // index of the depot and of the route pair
+  };
+  // Busses on the road, a finished one is swap-removed and retired to its
+  // depot, which recycles it for a later spawn
+  SlotMap<Deployment> busses_;
+
+  // One depot per route, switched by the dispatch plan as time advances
+  std::vector<BusDepot *> depots_;
+  DispatchCursor dispatchCursor_;
+  // Color policy of every line, NULL or missing for the default
+  std::vector<Bus::ColorPolicy> colorPolicies_;
+
+  // Live busses and stops by interned id, kept in sync with busses_ and
+  // prototypeRoutes_
+  EntityRegistry<Bus> busRegistry_;
+  EntityRegistry<Stop> stopRegistry_;
 
   int busId = 1000;
+  bool started_;  // global state, indicates whether Start was called
   bool paused_;  // global state, indices pause or resume
   std::ostream* out_;
+  std::ostream* trace_;  // not owned, may be NULL
   std::string bus_stats_file_name;
   std::ostringstream bus_stat_ss;
   FileWriter * instance;
-};
 
-template <typename T>
-void VisualizationSimulator::AddBusListener
-  (std::string * id, IObserver<T> * observer) {
-  // Iterate through the bus vector
-  for (int i = static_cast<int>(busses_.size()) - 1; i >= 0; i--) {
-    // Check whether the Bus id matches
-    if (busses_[i]->GetName() == *id) {
-      busses_[i]->RegisterObserver(observer);
-    }
-  }
-}
-
-template <typename T>
-void VisualizationSimulator::AddStopListener
-  (std::string * id, IObserver<T> * observer) {
-  // Iterate for all routes
-  for (int i = static_cast<int>(prototypeRoutes_.size()) - 1; i >= 0; i--) {
-    // For a single route, query information for all stops
-    std::list<Stop *> stops_ = prototypeRoutes_[i]->GetStops();
-    for (std::list<Stop *>::iterator it = stops_.begin();
-      it != stops_.end();
-      it++) {
-      // Check whether the Stop id matches
-      if (std::to_string((*it)->GetId()) == *id) {
-        (*it)->RegisterObserver(observer);
-      }
-    }
-  }
-}
+  EventBus events_;
+  WaitStatistics waitStatistics_;
+
+  std::mutex posted_mutex_;  // guards posted_ only
+  std::vector<std::function<void()> > posted_;
+
+  // Writes the last saved checkpoint, the error is read once it is joined
+  std::thread checkpointWriter_;
+  std::string checkpointError_;
+};
 
 #endif  // WEB_CODE_WEB_VISUALIZATION_SIMULATOR_H_
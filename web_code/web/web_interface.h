@@ -16,6 +16,16 @@ class WebInterface {
 
      virtual void UpdateBus(const BusData& bus, bool deleted = false) = 0;
      virtual void UpdateRoute(const RouteData& route, bool deleted = false) = 0;
+     // Called once the updates of a whole tick were made
+     virtual void Publish() = 0;
+};
+
+// Drops every update, for a simulation run without a web server
+class NullWebInterface : public WebInterface {
+ public:
+     void UpdateBus(const BusData&, bool) override {}
+     void UpdateRoute(const RouteData&, bool) override {}
+     void Publish() override {}
 };
 
 #endif  // WEB_CODE_WEB_WEB_INTERFACE_H_
@@ -5,14 +5,19 @@ var mapImg; // UMN Image generated from myMap
 var myMap; // Map from mappa
 var imageWidth;
 var imageHeight;
+var mapCenter;
+var mappa;
+var mapOptions;
+var zoomSlider;
+
+// Zoomed out, the server sends grid cell clusters instead of busses and
+// stops, see renderClusters
+var clusters = [];
+var clusterLevel = 0;
+var clusterCellSize = 0;
 let imageX = 250; // Top left position, in pixels, of image
 let imageY = 1; // Top left position, in pixels, of image
 
-const updateTime = 1000; // miliseconds
-var totalUpdates = 0; // How many times have we called update on the sim
-var elapsedTime;
-var startTime;
-
 var socket;
 var connected;
 
@@ -31,6 +36,9 @@ var startButton;
 var started;
 var pauseButton;
 var paused = false;
+var saveButton;
+var loadButton;
+var waitStatsButton;
 
 var simInfoYRectPos = 1; // Magic numbers for GUI elements
 var simInfoYPos = 15;
@@ -44,6 +52,7 @@ var runYPos = 465;
 var startYPos = 500;
 var observedBusText = "";
 var observedStopText = "";
+var waitStatsText = "";
 
 // Data for vis. Matches data_structs.h in C++
 function Position(x, y) {
@@ -85,30 +94,10 @@ function setupSocket() {
             if (data.command == "initRoutes") {
                 numRoutes = int(data.numRoutes / 2);
                 initRouteSliders();
-            }
-            if (data.command == "updateBusses") {
-                
-                busses = [];
-
-                for (let i = 0; i < data.busses.length; i++) {
-                    id = data.busses[i].id;
-                    numPassengers = data.busses[i].numPassengers;
-                    capacity = data.busses[i].capacity;
-                    
-                    x = data.busses[i].position.x;
-                    y = data.busses[i].position.y;
-                    position = new Position(x, y);
-
-                    var color = data.busses[i].color;
-                    color = new Color(color.red, color.green, color.blue, color.alpha);
 
-                    busses.push(new Bus(id, position, numPassengers, capacity, color));
-                }
-            }
-            if (data.command == "updateRoutes") {
-                
+                // Route geometry is static, so it only arrives once
                 routes = [];
-                
+
                 for (let i = 0; i < data.routes.length; i++) {
                     id = data.routes[i].id;
 
@@ -116,33 +105,91 @@ function setupSocket() {
 
                     for (let j = 0; j < data.routes[i].stops.length; j++) {
                         stop_id = data.routes[i].stops[j].id;
-                        
+
                         let index = stops.findIndex(x => x.id == stop_id);
                         if (index == -1) {
-                            numPeople = data.routes[i].stops[j].numPeople;
-
                             x = data.routes[i].stops[j].position.x;
                             y = data.routes[i].stops[j].position.y;
                             position = new Position(x, y);
 
-                            var newStop = new Stop(stop_id, position, numPeople);
+                            var newStop = new Stop(stop_id, position, 0);
                             stops.push(newStop);
                             stopDropDown.option(newStop.id)
 
                             route_stop_indices.push(stops.length-1);
                         } else {
-                            stops[index].numPeople = data.routes[i].stops[j].numPeople;
                             route_stop_indices.push(index);
                         }
                     }
                     routes.push(new Route(id, route_stop_indices));
                 }
             }
-            if (data.command == "observeBus") {
-                observedBusText = data.text;
-            } 
-            if (data.command == "observeStop") {
-                observedStopText = data.text;
+            if (data.command == "updateClusters") {
+                clusters = data.tiles;
+                clusterLevel = data.level;
+                clusterCellSize = data.cellSize;
+                busses = [];
+            }
+            if (data.command == "updateBusses") {
+                clusterLevel = 0;
+                busses = [];
+
+                for (let i = 0; i < data.busses.length; i++) {
+                    id = data.busses[i].id;
+                    numPassengers = data.busses[i].numPassengers;
+                    capacity = data.busses[i].capacity;
+                    
+                    x = data.busses[i].position.x;
+                    y = data.busses[i].position.y;
+                    position = new Position(x, y);
+
+                    var color = data.busses[i].color;
+                    color = new Color(color.red, color.green, color.blue, color.alpha);
+
+                    busses.push(new Bus(id, position, numPassengers, capacity, color));
+                }
+            }
+            if (data.command == "updateRoutes") {
+                // Only the number of people waiting at each stop, in the
+                // same order as the stops sent with initRoutes
+                for (let i = 0; i < data.routes.length; i++) {
+                    let route = routes.find(r => r.id == data.routes[i].id);
+                    if (route == undefined) {
+                        continue;
+                    }
+
+                    // With a viewport, only the stops in view are sent,
+                    // along with their indices on the route
+                    let indices = data.routes[i].stops;
+                    for (let j = 0; j < data.routes[i].numPeople.length; j++) {
+                        let k = indices == undefined ? j : indices[j];
+                        stops[route.stopIndices[k]].numPeople = data.routes[i].numPeople[j];
+                    }
+                }
+            }
+            if (data.command == "waitStats") {
+                // Percentiles of the whole network, per route and stop too
+                let lines = "Passenger times, p50 / p95 / p99\n";
+                let kinds = [["Wait at stop", "waitAtStop"], ["Ride", "ride"],
+                             ["Total", "total"]];
+                for (let i = 0; i < kinds.length; i++) {
+                    let p = data.network[kinds[i][1]];
+                    lines += "  * " + kinds[i][0] + ": " + p.p50 + " / "
+                           + p.p95 + " / " + p.p99 + "\n";
+                }
+                waitStatsText = lines;
+            }
+            if (data.command == "observe") {
+                // Every watched bus and stop of a tick arrives in one frame
+                for (let i = 0; i < data.observations.length; i++) {
+                    let observation = data.observations[i];
+                    if (observation.command == "observeBus") {
+                        observedBusText = observation.text;
+                    }
+                    if (observation.command == "observeStop") {
+                        observedStopText = observation.text;
+                    }
+                }
             }
         } 
     } catch(exception) {
@@ -155,9 +202,48 @@ function setupSocket() {
     socket.onopen = function() {
         connected = true;
         socket.send(JSON.stringify({command: "initRoutes"}));
+        // The server advances the sim on its own clock and pushes frames,
+        // only with what the map shows
+        socket.send(JSON.stringify({command: "subscribe"}));
+        socket.send(JSON.stringify({command: "setZoom", zoom: mapOptions.zoom}));
+        sendViewport();
+    }
+}
+
+// Reloads the map image at the zoom of the slider, the server switches to
+// clusters or back to busses and stops to match
+function zoomChanged() {
+    mapOptions.zoom = zoomSlider.value();
+    loadMap();
+    if (connected) {
+        socket.send(JSON.stringify({command: "setZoom", zoom: mapOptions.zoom}));
+        sendViewport();
     }
 }
 
+function loadMap() {
+    myMap = mappa.staticMap(mapOptions);
+    myMap.onClick = function() { console.log("map click");}
+    mapImg = loadImage(myMap.imgUrl);
+    mapImg.onClick = function() { console.log('map click');}
+}
+
+// Tells the server which area the map shows, in the coordinates of the
+// positions it sends, so it leaves out the busses and stops off screen.
+// Call it again whenever the map moves or zooms
+function sendViewport() {
+    let center = myMap.latLngToPixel(mapCenter.lat, mapCenter.lng);
+    let corner = myMap.latLngToPixel(mapCenter.lat + 0.01, mapCenter.lng + 0.01);
+    let latPerPixel = 0.01 / abs(corner.y - center.y);
+    let lngPerPixel = 0.01 / abs(corner.x - center.x);
+    let halfLat = latPerPixel * imageHeight / 2;
+    let halfLng = lngPerPixel * imageWidth / 2;
+    // Positions are drawn with x as the latitude, see render
+    socket.send(JSON.stringify({command: "setViewport",
+        minX: mapCenter.lat - halfLat, maxX: mapCenter.lat + halfLat,
+        minY: mapCenter.lng - halfLng, maxY: mapCenter.lng + halfLng}));
+}
+
 function mapClick(event) {
     for (let i = 0; i < busses.length; i++) {
         var pos = myMap.latLngToPixel(busses[i].position.x, busses[i].position.y);
@@ -213,8 +299,32 @@ function setup() {
     pauseButton.style('height', '20px');
     pauseButton.mousePressed(pause);
 
+    // Checkpoint of the run on the server, a loaded one goes on by itself
+    saveButton = createButton('Save');
+    saveButton.position(10, startYPos + 105);
+    saveButton.style('width', '100px');
+    saveButton.style('height', '20px');
+    saveButton.mousePressed(saveRun);
+
+    loadButton = createButton('Load');
+    loadButton.position(110, startYPos + 105);
+    loadButton.style('width', '100px');
+    loadButton.style('height', '20px');
+    loadButton.mousePressed(loadRun);
+
+    waitStatsButton = createButton('Wait times');
+    waitStatsButton.position(10, startYPos + 130);
+    waitStatsButton.style('width', '200px');
+    waitStatsButton.style('height', '20px');
+    waitStatsButton.mousePressed(requestWaitStats);
+
+    zoomSlider = createSlider(6, 16, 13, 1);
+    zoomSlider.position(10, startYPos + 75);
+    zoomSlider.style('width', '200px');
+    zoomSlider.changed(zoomChanged);
+
     // Image/map information
-    const options = {
+    mapOptions = {
         lat: 44.9765,
         lng: -93.215,
         zoom: 13,
@@ -224,41 +334,22 @@ function setup() {
         pitch: 0,
         style: 'dark-v9',
     };
-    imageWidth = options.width;
-    imageHeight = options.height;
-    const mappa = new Mappa('Mapbox', key);
-    myMap = mappa.staticMap(options);
-    myMap.onClick = function() { console.log("map click");}
-    mapImg = loadImage(myMap.imgUrl);
-    mapImg.onClick = function() { console.log('map click');}
+    imageWidth = mapOptions.width;
+    imageHeight = mapOptions.height;
+    mapCenter = {lat: mapOptions.lat, lng: mapOptions.lng};
+    mappa = new Mappa('Mapbox', key);
+    loadMap();
 
     document.getElementById("defaultCanvas0").onclick = mapClick;
 }
 
 function draw() {
-    if (started && connected) {
-        update();
-    }
     render();
     drawGui();
     drawObservedInfo();
     drawInfo();
 }
 
-function update() {
-    // Send down commands to C++
-    socket.send(JSON.stringify({command: "getRoutes"}));
-    socket.send(JSON.stringify({command: "getBusses"}));
-
-    // Only update every specified timestep
-    elapsedTime = millis() - startTime;
-    if (elapsedTime > updateTime && totalUpdates <= numTimeSteps) {
-        socket.send(JSON.stringify({command: "update"}));
-        startTime = millis();
-        totalUpdates++;
-    }
-}
-
 function render() {
     clear();
 
@@ -287,6 +378,11 @@ function render() {
     }
     pop();
 
+    if (clusterLevel > 0) {
+        renderClusters();
+        return;
+    }
+
     // Draw Stops
     for (let i = 0; i < stops.length; i++) {
         x = stops[i].position.x;
@@ -329,6 +425,40 @@ function render() {
     }
 }
 
+// One square per grid cell, in the most common bus color of the cell and
+// more opaque the fuller its busses are, with the number of busses and of
+// people waiting at its stops
+function renderClusters() {
+    for (let i = 0; i < clusters.length; i++) {
+        let tile = clusters[i];
+        // Positions are drawn with x as the latitude, as for busses
+        var corner1 = myMap.latLngToPixel(tile.column * clusterCellSize,
+                                          tile.row * clusterCellSize);
+        var corner2 = myMap.latLngToPixel((tile.column + 1) * clusterCellSize,
+                                          (tile.row + 1) * clusterCellSize);
+        let x = min(corner1.x, corner2.x) + imageX;
+        let y = min(corner1.y, corner2.y) + imageY;
+        let w = abs(corner2.x - corner1.x);
+        let h = abs(corner2.y - corner1.y);
+
+        push();
+        stroke(255, 255, 255, 80);
+        if (tile.color != undefined) {
+            fill(tile.color.red, tile.color.green, tile.color.blue,
+                 60 + 195 * min(tile.load, 1));
+        } else {
+            fill(255, 255, 255, 40);
+        }
+        rect(x, y, w, h);
+
+        fill(255);
+        textAlign(CENTER, CENTER);
+        textSize(12);
+        text(tile.numBusses + ' / ' + tile.numWaiting, x + w / 2, y + h / 2);
+        pop();
+    }
+}
+
 function drawGui() {
     // GUI rect
     fill(255, 255, 255, 50);
@@ -347,6 +477,7 @@ function drawGui() {
 
     textAlign(LEFT, CENTER);
     text('Number of time steps to run:  ' + numTimeStepsSlider.value(), 10, numTimeStepsTextYPos);
+    text('Map zoom: ' + zoomSlider.value(), 10, startYPos + 62);
     for (let i = 0; i < numRoutes; i++) {
         text('Time steps between busses for route ' + i + ': ' +  busTimeOffsetsSliders[i].value(), 10, busTimeOffsetsYInitTextPos + busTimeOffsetsYOffset * i);
     }
@@ -360,8 +491,6 @@ function start() {
     numTimeSteps = numTimeStepsSlider.value();
     socket.send(JSON.stringify({command: "start", numTimeSteps: numTimeSteps, timeBetweenBusses: busTimeOffsets}));
     started = true;
-    elapsedTime = millis();
-    startTime = millis();
 }
 
 function dropDownSelect() {
@@ -383,6 +512,21 @@ function pause() {
     }
 }
 
+function saveRun() {
+    if (started) {
+        socket.send(JSON.stringify({command: "save", name: "checkpoint"}));
+    }
+}
+
+function loadRun() {
+    socket.send(JSON.stringify({command: "load", name: "checkpoint"}));
+    started = true;
+}
+
+function requestWaitStats() {
+    socket.send(JSON.stringify({command: "waitStats"}));
+}
+
 function initRouteSliders() {
     
     for (let i = 0; i < numRoutes; i++) {
@@ -428,5 +572,5 @@ function drawInfo() {
 
 
 function drawObservedInfo() {
-    text(observedBusText + observedStopText,1+imageWidth+270+5, simInfoYRectPos+200);
+    text(observedBusText + observedStopText + waitStatsText,1+imageWidth+270+5, simInfoYRectPos+200);
 }